@@ -39,6 +39,9 @@ typedef struct {
     char duco_mining_key[64];
     char duco_server[128];
     uint16_t duco_port;
+    char duco_difficulty[12];   // Difficulty tier, or "AUTO" for adaptive
+    char duco_rig_id[32];       // Rig identifier(s), comma-separated per rig
+    uint8_t duco_rig_count;     // Independent connections/workers (1-2)
 
     // General settings
     mining_mode_t active_mode;
@@ -11,6 +11,18 @@
 // Include user configuration
 #include "config.h"
 
+#ifndef DUCO_DIFFICULTY_TIER
+#define DUCO_DIFFICULTY_TIER "AUTO"
+#endif
+
+#ifndef DUCO_RIG_COUNT
+#define DUCO_RIG_COUNT 1
+#endif
+
+#ifndef DUCO_RIG_ID
+#define DUCO_RIG_ID "ESP32-S3"
+#endif
+
 static const char *TAG = "CONFIG";
 static const char *NVS_NAMESPACE = "miner";
 static const char *NVS_KEY = "config";
@@ -41,6 +53,9 @@ static void config_load_defaults(miner_config_t *config)
     strncpy(config->duco_mining_key, DUCO_MINING_KEY, sizeof(config->duco_mining_key) - 1);
     strncpy(config->duco_server, DUCO_SERVER, sizeof(config->duco_server) - 1);
     config->duco_port = DUCO_PORT;
+    strncpy(config->duco_difficulty, DUCO_DIFFICULTY_TIER, sizeof(config->duco_difficulty) - 1);
+    strncpy(config->duco_rig_id, DUCO_RIG_ID, sizeof(config->duco_rig_id) - 1);
+    config->duco_rig_count = DUCO_RIG_COUNT;
 
     // General settings
     config->active_mode = (mining_mode_t)DEFAULT_MINING_MODE;
@@ -287,6 +302,8 @@ void config_print(void)
     ESP_LOGI(TAG, "Username: %s", current_config.duco_username);
     ESP_LOGI(TAG, "Mining Key: %s", strlen(current_config.duco_mining_key) > 0 ? "***" : "(not set)");
     ESP_LOGI(TAG, "Server: %s:%d", current_config.duco_server, current_config.duco_port);
+    ESP_LOGI(TAG, "Difficulty: %s", current_config.duco_difficulty);
+    ESP_LOGI(TAG, "Rigs: %u (%s)", current_config.duco_rig_count, current_config.duco_rig_id);
 
     // General
     ESP_LOGI(TAG, "--- General Settings ---");
@@ -0,0 +1,122 @@
+/**
+ * GT911 Capacitive Touch Controller Implementation
+ */
+
+#include "gt911.h"
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "driver/gpio.h"
+#include "esp_log.h"
+
+static const char *TAG = "GT911";
+
+// Registers (16-bit, big-endian addresses)
+#define GT911_REG_PRODUCT_ID 0x8140     // "911" ASCII
+#define GT911_REG_X_MAX 0x8048          // Config: x resolution, little-endian
+#define GT911_REG_STATUS 0x814E         // bit 7 report ready, bits 0-3 points, then
+                                        // track id, x lo, x hi, y lo, y hi of point 1
+
+#define GT911_STATUS_READY 0x80
+#define GT911_MAX_POINTS 5
+#define GT911_I2C_TIMEOUT_MS 20
+
+static esp_err_t gt911_read_reg(gt911_t *dev, uint16_t reg, uint8_t *data, size_t len)
+{
+    uint8_t addr[2] = { (uint8_t)(reg >> 8), (uint8_t)reg };
+    return i2c_master_write_read_device(dev->port, dev->addr, addr, sizeof(addr), data, len,
+                                        pdMS_TO_TICKS(GT911_I2C_TIMEOUT_MS));
+}
+
+static esp_err_t gt911_write_reg8(gt911_t *dev, uint16_t reg, uint8_t value)
+{
+    uint8_t buf[3] = { (uint8_t)(reg >> 8), (uint8_t)reg, value };
+    return i2c_master_write_to_device(dev->port, dev->addr, buf, sizeof(buf),
+                                      pdMS_TO_TICKS(GT911_I2C_TIMEOUT_MS));
+}
+
+/**
+ * @brief Reset sequence; INT low while RST rises selects 0x5D
+ */
+static void gt911_reset(int rst_pin, int int_pin)
+{
+    gpio_config_t out = {
+        .pin_bit_mask = 1ULL << rst_pin | (int_pin >= 0 ? 1ULL << int_pin : 0),
+        .mode = GPIO_MODE_OUTPUT,
+    };
+    gpio_config(&out);
+
+    gpio_set_level(rst_pin, 0);
+    if (int_pin >= 0) {
+        gpio_set_level(int_pin, 0);
+    }
+    vTaskDelay(pdMS_TO_TICKS(10));
+    gpio_set_level(rst_pin, 1);
+    vTaskDelay(pdMS_TO_TICKS(5));
+
+    // Release INT; the controller drives it from here on
+    if (int_pin >= 0) {
+        gpio_set_direction(int_pin, GPIO_MODE_INPUT);
+    }
+    vTaskDelay(pdMS_TO_TICKS(50));
+}
+
+static bool gt911_probe(gt911_t *dev, uint8_t addr)
+{
+    char id[4] = {0};
+    dev->addr = addr;
+    return gt911_read_reg(dev, GT911_REG_PRODUCT_ID, (uint8_t *)id, 3) == ESP_OK &&
+           strcmp(id, "911") == 0;
+}
+
+esp_err_t gt911_init(gt911_t *dev, i2c_port_t port, int rst_pin, int int_pin)
+{
+    memset(dev, 0, sizeof(*dev));
+    dev->port = port;
+
+    if (rst_pin >= 0) {
+        gt911_reset(rst_pin, int_pin);
+    }
+
+    if (!gt911_probe(dev, GT911_ADDR_PRIMARY) && !gt911_probe(dev, GT911_ADDR_SECONDARY)) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    uint8_t res[4];
+    if (gt911_read_reg(dev, GT911_REG_X_MAX, res, sizeof(res)) == ESP_OK) {
+        dev->max_x = (uint16_t)(res[0] | res[1] << 8);
+        dev->max_y = (uint16_t)(res[2] | res[3] << 8);
+    }
+
+    // Drop any report latched before we were listening
+    gt911_write_reg8(dev, GT911_REG_STATUS, 0);
+
+    ESP_LOGI(TAG, "GT911 at 0x%02x, %ux%u", dev->addr, dev->max_x, dev->max_y);
+    return ESP_OK;
+}
+
+esp_err_t gt911_read(gt911_t *dev, uint16_t *x, uint16_t *y, uint8_t *points)
+{
+    // Status, track id and the first point's coordinates in one transfer
+    uint8_t buf[6];
+    esp_err_t ret = gt911_read_reg(dev, GT911_REG_STATUS, buf, sizeof(buf));
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    if (!(buf[0] & GT911_STATUS_READY)) {
+        return ESP_ERR_NOT_FINISHED;
+    }
+
+    uint8_t count = buf[0] & 0x0F;
+    if (count > GT911_MAX_POINTS) {
+        count = 0;
+    }
+    if (count > 0) {
+        *x = (uint16_t)(buf[2] | buf[3] << 8);
+        *y = (uint16_t)(buf[4] | buf[5] << 8);
+    }
+    *points = count;
+
+    // Acknowledge so the controller latches the next report
+    return gt911_write_reg8(dev, GT911_REG_STATUS, 0);
+}
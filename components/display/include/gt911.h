@@ -0,0 +1,60 @@
+/**
+ * GT911 Capacitive Touch Controller
+ *
+ * Minimal single-touch driver over I2C: probe, reset with address
+ * selection, and reading the first reported point. The controller raises
+ * its INT line whenever a new report is ready; callers can sleep on that
+ * line and only read when it fires.
+ */
+
+#ifndef GT911_H
+#define GT911_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "driver/i2c.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define GT911_ADDR_PRIMARY 0x5D
+#define GT911_ADDR_SECONDARY 0x14
+
+typedef struct {
+    i2c_port_t port;
+    uint8_t addr;                       // Probed 7-bit address
+    uint16_t max_x;                     // Resolution from the controller config
+    uint16_t max_y;
+} gt911_t;
+
+/**
+ * @brief Reset (when wired) and probe the controller
+ *
+ * The I2C driver must already be installed on port. With both pins wired,
+ * the reset sequence selects GT911_ADDR_PRIMARY; otherwise both addresses
+ * are tried. The INT pin is left as a floating input.
+ *
+ * @param rst_pin Reset GPIO, -1 if not wired
+ * @param int_pin INT GPIO, -1 if not wired
+ * @return ESP_OK on success, ESP_ERR_NOT_FOUND if no GT911 answers
+ */
+esp_err_t gt911_init(gt911_t *dev, i2c_port_t port, int rst_pin, int int_pin);
+
+/**
+ * @brief Read the current touch state and acknowledge the report
+ *
+ * @param x First point, valid when points > 0
+ * @param y First point, valid when points > 0
+ * @param points Number of touch points (0 = released)
+ * @return ESP_OK with a fresh report, ESP_ERR_NOT_FINISHED if no new report
+ *         is ready, or an I2C error
+ */
+esp_err_t gt911_read(gt911_t *dev, uint16_t *x, uint16_t *y, uint8_t *points);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GT911_H
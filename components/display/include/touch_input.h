@@ -0,0 +1,122 @@
+/**
+ * Touch Input Pipeline
+ *
+ * A low-priority task on core 0 owns the GT911. It sleeps until the
+ * controller's INT line fires (or polls when INT is not wired), reads one
+ * report and turns it into press / move / release events for the UI
+ * thread. Nothing on this path touches the hashing workers.
+ *
+ * Events reach the UI over a small lock-free ring. Press and release are
+ * always queued; moves are coalesced - while the UI has not caught up,
+ * only the newest position is kept - so a finger dragging faster than
+ * the UI redraws never builds a backlog.
+ *
+ * The UI thread (e.g. an LVGL input device read callback) drains events
+ * with touch_input_read(). With LVGL:
+ *
+ *   static void indev_read(lv_indev_t *indev, lv_indev_data_t *data)
+ *   {
+ *       static touch_event_t ev;
+ *       if (touch_input_read(&ev)) {
+ *           data->continue_reading = true;
+ *       }
+ *       data->point.x = ev.x;
+ *       data->point.y = ev.y;
+ *       data->state = ev.type == TOUCH_EVENT_RELEASE ? LV_INDEV_STATE_RELEASED
+ *                                                    : LV_INDEV_STATE_PRESSED;
+ *   }
+ *
+ * Latency is measured from the touch report (INT edge or poll) to the UI
+ * calling touch_input_feedback() once the visual response is on screen.
+ */
+
+#ifndef TOUCH_INPUT_H
+#define TOUCH_INPUT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TOUCH_EVENT_RING_SIZE 8         // Slots (power of two)
+
+typedef enum {
+    TOUCH_EVENT_PRESS = 0,
+    TOUCH_EVENT_MOVE,
+    TOUCH_EVENT_RELEASE,
+} touch_event_type_t;
+
+typedef struct {
+    touch_event_type_t type;
+    uint16_t x;
+    uint16_t y;
+    uint32_t report_us;                 // When the controller reported it (low 32 bits of esp_timer)
+} touch_event_t;
+
+// Pipeline statistics
+typedef struct {
+    bool irq_wakeup;                    // INT wired; false = polling
+    uint32_t wakeups;                   // Touch task wakeups
+    uint32_t reports;                   // Fresh controller reports read
+    uint32_t i2c_errors;
+    uint32_t events[3];                 // Queued, by touch_event_type_t
+    uint32_t coalesced;                 // Moves superseded before the UI saw them
+    uint32_t dropped;                   // Press / release lost to a full ring
+    uint32_t ui_reads;                  // Events taken by the UI
+    float queue_avg_us;                 // Report to UI read, EWMA
+    uint32_t queue_max_us;
+    uint32_t feedback_count;
+    uint32_t feedback_last_us;          // Report to visual feedback
+    float feedback_avg_us;              // EWMA
+    uint32_t feedback_max_us;
+} touch_stats_t;
+
+/**
+ * @brief Bring up I2C, probe the GT911 and start the touch task
+ *
+ * @return ESP_OK on success, ESP_ERR_NOT_FOUND without a touch controller
+ */
+esp_err_t touch_input_start(void);
+
+/**
+ * @brief Stop the touch task and release I2C
+ */
+esp_err_t touch_input_stop(void);
+
+/**
+ * @brief Wake this task whenever an event is queued (NULL to disable)
+ *
+ * Lets the UI thread run its handler right away instead of at its next
+ * refresh period.
+ */
+void touch_input_set_ui_task(TaskHandle_t task);
+
+/**
+ * @brief Take the oldest queued event (UI thread only)
+ *
+ * @return false if no event is pending
+ */
+bool touch_input_read(touch_event_t *event);
+
+/**
+ * @brief Report that the visual response to an event is on screen (UI thread only)
+ */
+void touch_input_feedback(const touch_event_t *event);
+
+/**
+ * @brief Get pipeline statistics
+ *
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE if touch is not running
+ */
+esp_err_t touch_input_get_stats(touch_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TOUCH_INPUT_H
@@ -0,0 +1,48 @@
+/**
+ * Touch UI Dispatcher
+ *
+ * Stands in for the UI thread until the board has a display driver: it
+ * drains the touch input ring as events arrive and turns gestures into UI
+ * actions. A long press (held still for TOUCH_UI_HOLD_MS) toggles between
+ * Duino-Coin and Bitcoin mode; everything else is acknowledged and
+ * ignored. Each handled event is reported with touch_input_feedback(), so
+ * the feedback latency covers the whole report-to-response path.
+ */
+
+#ifndef TOUCH_UI_H
+#define TOUCH_UI_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    uint32_t taps;                      // Short presses (no action)
+    uint32_t holds;                     // Long presses that posted a mode switch
+    uint32_t rejected;                  // Mode switches the action worker refused
+} touch_ui_stats_t;
+
+/**
+ * @brief Start the dispatcher task and register it with the touch pipeline
+ */
+esp_err_t touch_ui_start(void);
+
+/**
+ * @brief Stop the dispatcher task
+ */
+esp_err_t touch_ui_stop(void);
+
+/**
+ * @brief Get dispatcher statistics
+ */
+void touch_ui_get_stats(touch_ui_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TOUCH_UI_H
@@ -0,0 +1,81 @@
+/**
+ * UI Action Worker
+ *
+ * Anything a touch can trigger that takes longer than a frame - switching
+ * mining mode (stopping and starting miners), saving configuration to
+ * NVS - runs on this worker instead of the UI thread. The UI posts an
+ * action and keeps rendering; an optional callback reports the outcome
+ * (on the worker task - hand it back to the UI thread before touching
+ * widgets).
+ */
+
+#ifndef UI_ACTION_H
+#define UI_ACTION_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "miner_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define UI_ACTION_QUEUE_LEN 4
+
+typedef enum {
+    UI_ACTION_SET_MODE = 0,             // Switch mining mode, persist it, restart miners
+    UI_ACTION_SAVE_CONFIG,              // Persist the current configuration
+} ui_action_type_t;
+
+struct ui_action;
+
+/**
+ * @brief Completion callback, called on the worker task
+ */
+typedef void (*ui_action_done_cb_t)(const struct ui_action *action, esp_err_t result, void *arg);
+
+typedef struct ui_action {
+    ui_action_type_t type;
+    mining_mode_t mode;                 // UI_ACTION_SET_MODE
+    ui_action_done_cb_t done;           // Optional
+    void *arg;
+} ui_action_t;
+
+typedef struct {
+    uint32_t posted;
+    uint32_t rejected;                  // Queue full
+    uint32_t completed;
+    uint32_t failed;
+    uint32_t last_ms;                   // Duration of the last action
+    uint32_t max_ms;
+} ui_action_stats_t;
+
+/**
+ * @brief Start the action worker task
+ */
+esp_err_t ui_action_start(void);
+
+/**
+ * @brief Stop the action worker task (pending actions are discarded)
+ */
+esp_err_t ui_action_stop(void);
+
+/**
+ * @brief Queue an action; never blocks
+ *
+ * @return ESP_OK if queued, ESP_ERR_NO_MEM if the queue is full,
+ *         ESP_ERR_INVALID_STATE if the worker is not running
+ */
+esp_err_t ui_action_post(const ui_action_t *action);
+
+/**
+ * @brief Get worker statistics
+ */
+void ui_action_get_stats(ui_action_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // UI_ACTION_H
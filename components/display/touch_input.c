@@ -0,0 +1,362 @@
+/**
+ * Touch Input Pipeline Implementation
+ */
+
+#include "touch_input.h"
+#include <string.h>
+#include "driver/gpio.h"
+#include "driver/i2c.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "config.h"
+#include "gt911.h"
+#include "spsc_ring.h"
+#include "mem_budget.h"
+
+static const char *TAG = "TOUCH";
+
+#ifndef TOUCH_I2C_PORT
+#define TOUCH_I2C_PORT 0
+#endif
+
+#ifndef TOUCH_I2C_SDA_PIN
+#define TOUCH_I2C_SDA_PIN 19
+#endif
+
+#ifndef TOUCH_I2C_SCL_PIN
+#define TOUCH_I2C_SCL_PIN 20
+#endif
+
+#ifndef TOUCH_I2C_FREQ_HZ
+#define TOUCH_I2C_FREQ_HZ 400000
+#endif
+
+#ifndef TOUCH_INT_PIN
+#define TOUCH_INT_PIN -1
+#endif
+
+#ifndef TOUCH_RST_PIN
+#define TOUCH_RST_PIN 38
+#endif
+
+#ifndef TOUCH_POLL_MS
+#define TOUCH_POLL_MS 20
+#endif
+
+#define TOUCH_STACK_SIZE 3072
+#define TOUCH_STOP_CHECK_MS 100         // Longest sleep with INT wired
+#define TOUCH_LATENCY_ALPHA 0.1f
+
+static TaskHandle_t touch_task_handle = NULL;
+static volatile bool stop_requested = false;
+static TaskHandle_t ui_task = NULL;
+static gt911_t gt911;
+
+// Stamped by the INT handler, read by the touch task
+static volatile uint32_t irq_us = 0;
+
+// Touch task -> UI thread
+static spsc_ring_t ring;
+static touch_event_t ring_slots[TOUCH_EVENT_RING_SIZE];
+static volatile bool ring_ready = false;
+
+// Newest move not yet queued (touch task only)
+static touch_event_t pending_move;
+static bool move_pending = false;
+
+static touch_stats_t stats = {0};
+static portMUX_TYPE stats_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static void IRAM_ATTR touch_isr(void *arg)
+{
+    irq_us = (uint32_t)esp_timer_get_time();
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(touch_task_handle, &woken);
+    portYIELD_FROM_ISR(woken);
+}
+
+/**
+ * @brief Queue the pending move once the UI has drained everything before it
+ */
+static bool touch_flush_move(void)
+{
+    if (!move_pending || spsc_ring_count(&ring) != 0 || !spsc_ring_push(&ring, &pending_move)) {
+        return false;
+    }
+    move_pending = false;
+    portENTER_CRITICAL(&stats_lock);
+    stats.events[TOUCH_EVENT_MOVE]++;
+    portEXIT_CRITICAL(&stats_lock);
+    return true;
+}
+
+/**
+ * @brief Queue an event; moves replace any move the UI has not seen yet
+ */
+static bool touch_emit(const touch_event_t *event)
+{
+    if (event->type == TOUCH_EVENT_MOVE) {
+        if (move_pending) {
+            portENTER_CRITICAL(&stats_lock);
+            stats.coalesced++;
+            portEXIT_CRITICAL(&stats_lock);
+        }
+        pending_move = *event;
+        move_pending = true;
+        return touch_flush_move();
+    }
+
+    // A release carries the last position, so a pending move adds nothing
+    bool queued = spsc_ring_push(&ring, event);
+    portENTER_CRITICAL(&stats_lock);
+    if (move_pending) {
+        stats.coalesced++;
+    }
+    if (queued) {
+        stats.events[event->type]++;
+    } else {
+        stats.dropped++;
+    }
+    portEXIT_CRITICAL(&stats_lock);
+    move_pending = false;
+    return queued;
+}
+
+/**
+ * @brief Touch task - sleep on INT (or poll), read the GT911, queue events
+ */
+static void touch_task(void *param)
+{
+    const bool irq_wired = TOUCH_INT_PIN >= 0;
+    bool pressed = false;
+    uint16_t last_x = 0;
+    uint16_t last_y = 0;
+
+    ESP_LOGI(TAG, "Touch task started (%s)", irq_wired ? "INT wakeup" : "polling");
+
+    while (!stop_requested) {
+        TickType_t wait = pdMS_TO_TICKS(irq_wired ? TOUCH_STOP_CHECK_MS : TOUCH_POLL_MS);
+        bool interrupted = ulTaskNotifyTake(pdTRUE, wait) > 0;
+        if (irq_wired && !interrupted && !move_pending) {
+            continue;
+        }
+
+        // The INT edge is when the controller had the report ready
+        uint32_t report_us = interrupted ? irq_us : (uint32_t)esp_timer_get_time();
+        bool queued = touch_flush_move();
+
+        uint16_t x = last_x;
+        uint16_t y = last_y;
+        uint8_t points = 0;
+        esp_err_t ret = gt911_read(&gt911, &x, &y, &points);
+
+        portENTER_CRITICAL(&stats_lock);
+        stats.wakeups++;
+        if (ret == ESP_OK) {
+            stats.reports++;
+        } else if (ret != ESP_ERR_NOT_FINISHED) {
+            stats.i2c_errors++;
+        }
+        portEXIT_CRITICAL(&stats_lock);
+
+        if (ret == ESP_OK) {
+            touch_event_t event = { .x = x, .y = y, .report_us = report_us };
+            if (points > 0 && !pressed) {
+                event.type = TOUCH_EVENT_PRESS;
+                queued |= touch_emit(&event);
+            } else if (points > 0 && (x != last_x || y != last_y)) {
+                event.type = TOUCH_EVENT_MOVE;
+                queued |= touch_emit(&event);
+            } else if (points == 0 && pressed) {
+                event.type = TOUCH_EVENT_RELEASE;
+                event.x = last_x;
+                event.y = last_y;
+                queued |= touch_emit(&event);
+            }
+            pressed = points > 0;
+            last_x = x;
+            last_y = y;
+        }
+
+        TaskHandle_t notify = ui_task;
+        if (queued && notify != NULL) {
+            xTaskNotifyGive(notify);
+        }
+    }
+
+    ESP_LOGI(TAG, "Touch task stopped");
+    mem_budget_unregister_task(NULL);
+    touch_task_handle = NULL;
+    vTaskDelete(NULL);
+}
+
+static esp_err_t touch_i2c_init(void)
+{
+    i2c_config_t conf = {
+        .mode = I2C_MODE_MASTER,
+        .sda_io_num = TOUCH_I2C_SDA_PIN,
+        .scl_io_num = TOUCH_I2C_SCL_PIN,
+        .sda_pullup_en = GPIO_PULLUP_ENABLE,
+        .scl_pullup_en = GPIO_PULLUP_ENABLE,
+        .master.clk_speed = TOUCH_I2C_FREQ_HZ,
+    };
+    esp_err_t ret = i2c_param_config(TOUCH_I2C_PORT, &conf);
+    if (ret == ESP_OK) {
+        ret = i2c_driver_install(TOUCH_I2C_PORT, I2C_MODE_MASTER, 0, 0, 0);
+    }
+    return ret;
+}
+
+esp_err_t touch_input_start(void)
+{
+    if (touch_task_handle != NULL) {
+        return ESP_OK;
+    }
+
+    esp_err_t ret = touch_i2c_init();
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "I2C init failed: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    ret = gt911_init(&gt911, TOUCH_I2C_PORT, TOUCH_RST_PIN, TOUCH_INT_PIN);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "No GT911 found - touch disabled");
+        i2c_driver_delete(TOUCH_I2C_PORT);
+        return ret;
+    }
+
+    spsc_ring_init(&ring, ring_slots, sizeof(touch_event_t), TOUCH_EVENT_RING_SIZE);
+    move_pending = false;
+    portENTER_CRITICAL(&stats_lock);
+    memset(&stats, 0, sizeof(stats));
+    stats.irq_wakeup = TOUCH_INT_PIN >= 0;
+    portEXIT_CRITICAL(&stats_lock);
+    ring_ready = true;
+    stop_requested = false;
+
+    // Core 0 with the other service tasks; blocked on I2C or INT nearly always
+    BaseType_t created = xTaskCreatePinnedToCore(
+        touch_task,
+        "touch",
+        TOUCH_STACK_SIZE,
+        NULL,
+        3,     // Priority
+        &touch_task_handle,
+        0      // Core 0
+    );
+
+    if (created != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create touch task");
+        touch_task_handle = NULL;
+        ring_ready = false;
+        i2c_driver_delete(TOUCH_I2C_PORT);
+        return ESP_FAIL;
+    }
+    mem_budget_register_task(touch_task_handle, TOUCH_STACK_SIZE);
+
+    const int int_pin = TOUCH_INT_PIN;
+    if (int_pin >= 0) {
+        gpio_config_t int_conf = {
+            .pin_bit_mask = 1ULL << int_pin,
+            .mode = GPIO_MODE_INPUT,
+            .intr_type = GPIO_INTR_POSEDGE,     // One edge per report whatever the pulse polarity
+        };
+        gpio_config(&int_conf);
+
+        // Already installed by another driver is fine
+        ret = gpio_install_isr_service(0);
+        if (ret == ESP_OK || ret == ESP_ERR_INVALID_STATE) {
+            ret = gpio_isr_handler_add(int_pin, touch_isr, NULL);
+        }
+        if (ret != ESP_OK) {
+            ESP_LOGW(TAG, "INT handler unavailable (%s) - touch will lag", esp_err_to_name(ret));
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t touch_input_stop(void)
+{
+    if (touch_task_handle == NULL) {
+        return ESP_OK;
+    }
+
+    if (TOUCH_INT_PIN >= 0) {
+        gpio_isr_handler_remove(TOUCH_INT_PIN);
+    }
+    stop_requested = true;
+
+    int timeout = 30;
+    while (touch_task_handle != NULL && timeout > 0) {
+        vTaskDelay(pdMS_TO_TICKS(100));
+        timeout--;
+    }
+
+    if (touch_task_handle != NULL) {
+        ESP_LOGW(TAG, "Force deleting touch task");
+        mem_budget_unregister_task(touch_task_handle);
+        vTaskDelete(touch_task_handle);
+        touch_task_handle = NULL;
+    }
+
+    ring_ready = false;
+    i2c_driver_delete(TOUCH_I2C_PORT);
+    return ESP_OK;
+}
+
+void touch_input_set_ui_task(TaskHandle_t task)
+{
+    ui_task = task;
+}
+
+/**
+ * @brief Fold one latency sample into an average and maximum
+ */
+static void touch_latency_record(float *avg_us, uint32_t *max_us, uint32_t count, uint32_t sample_us)
+{
+    *avg_us = count <= 1 ? sample_us : *avg_us + TOUCH_LATENCY_ALPHA * (sample_us - *avg_us);
+    if (sample_us > *max_us) {
+        *max_us = sample_us;
+    }
+}
+
+bool touch_input_read(touch_event_t *event)
+{
+    if (!ring_ready || !spsc_ring_pop(&ring, event)) {
+        return false;
+    }
+
+    uint32_t delay_us = (uint32_t)esp_timer_get_time() - event->report_us;
+    portENTER_CRITICAL(&stats_lock);
+    stats.ui_reads++;
+    touch_latency_record(&stats.queue_avg_us, &stats.queue_max_us, stats.ui_reads, delay_us);
+    portEXIT_CRITICAL(&stats_lock);
+    return true;
+}
+
+void touch_input_feedback(const touch_event_t *event)
+{
+    uint32_t latency_us = (uint32_t)esp_timer_get_time() - event->report_us;
+    portENTER_CRITICAL(&stats_lock);
+    stats.feedback_count++;
+    stats.feedback_last_us = latency_us;
+    touch_latency_record(&stats.feedback_avg_us, &stats.feedback_max_us,
+                         stats.feedback_count, latency_us);
+    portEXIT_CRITICAL(&stats_lock);
+}
+
+esp_err_t touch_input_get_stats(touch_stats_t *out_stats)
+{
+    if (!out_stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (touch_task_handle == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    portENTER_CRITICAL(&stats_lock);
+    *out_stats = stats;
+    portEXIT_CRITICAL(&stats_lock);
+    return ESP_OK;
+}
@@ -0,0 +1,188 @@
+/**
+ * Touch UI Dispatcher Implementation
+ */
+
+#include "touch_ui.h"
+#include <stdlib.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "config.h"
+#include "miner_config.h"
+#include "touch_input.h"
+#include "ui_action.h"
+#include "mem_budget.h"
+
+static const char *TAG = "TOUCH_UI";
+
+#ifndef TOUCH_UI_HOLD_MS
+#define TOUCH_UI_HOLD_MS 2000
+#endif
+
+#ifndef TOUCH_UI_SLOP_PX
+#define TOUCH_UI_SLOP_PX 20
+#endif
+
+#define TOUCH_UI_STACK_SIZE 2560
+#define TOUCH_UI_WAIT_MS 100            // Notification wait between stop checks
+
+static TaskHandle_t ui_task_handle = NULL;
+static volatile bool stop_requested = false;
+
+static touch_ui_stats_t stats = {0};
+static portMUX_TYPE stats_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Gesture state (dispatcher task only)
+static bool pressed = false;
+static bool moved = false;
+static touch_event_t press_event;
+
+/**
+ * @brief Long press: switch to the other mining mode on the action worker
+ */
+static void touch_ui_toggle_mode(void)
+{
+    ui_action_t action = {
+        .type = UI_ACTION_SET_MODE,
+        .mode = config_get_mode() == MINING_MODE_DUINOCOIN ? MINING_MODE_BITCOIN
+                                                           : MINING_MODE_DUINOCOIN,
+    };
+    esp_err_t ret = ui_action_post(&action);
+
+    portENTER_CRITICAL(&stats_lock);
+    if (ret == ESP_OK) {
+        stats.holds++;
+    } else {
+        stats.rejected++;
+    }
+    portEXIT_CRITICAL(&stats_lock);
+
+    if (ret == ESP_OK) {
+        ESP_LOGI(TAG, "Long press - switching to %s mode",
+                 action.mode == MINING_MODE_BITCOIN ? "Bitcoin" : "Duino-Coin");
+    } else {
+        ESP_LOGW(TAG, "Mode switch not queued: %s", esp_err_to_name(ret));
+    }
+}
+
+static void touch_ui_handle(const touch_event_t *event)
+{
+    switch (event->type) {
+        case TOUCH_EVENT_PRESS:
+            pressed = true;
+            moved = false;
+            press_event = *event;
+            break;
+        case TOUCH_EVENT_MOVE:
+            if (abs((int)event->x - press_event.x) > TOUCH_UI_SLOP_PX ||
+                abs((int)event->y - press_event.y) > TOUCH_UI_SLOP_PX) {
+                moved = true;
+            }
+            break;
+        case TOUCH_EVENT_RELEASE: {
+            // A drag is not a gesture we act on
+            bool still = pressed && !moved;
+            pressed = false;
+            if (!still) {
+                break;
+            }
+            uint32_t held_ms = (event->report_us - press_event.report_us) / 1000;
+            if (held_ms >= TOUCH_UI_HOLD_MS) {
+                touch_ui_toggle_mode();
+            } else {
+                portENTER_CRITICAL(&stats_lock);
+                stats.taps++;
+                portEXIT_CRITICAL(&stats_lock);
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Dispatcher task - woken by the touch task, drains and handles events
+ */
+static void touch_ui_task(void *param)
+{
+    ESP_LOGI(TAG, "Touch dispatcher started");
+    touch_input_set_ui_task(xTaskGetCurrentTaskHandle());
+
+    while (!stop_requested) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(TOUCH_UI_WAIT_MS));
+
+        touch_event_t event;
+        while (touch_input_read(&event)) {
+            touch_ui_handle(&event);
+            touch_input_feedback(&event);
+        }
+    }
+
+    touch_input_set_ui_task(NULL);
+    ESP_LOGI(TAG, "Touch dispatcher stopped");
+    mem_budget_unregister_task(NULL);
+    ui_task_handle = NULL;
+    vTaskDelete(NULL);
+}
+
+esp_err_t touch_ui_start(void)
+{
+    if (ui_task_handle != NULL) {
+        return ESP_OK;
+    }
+
+    pressed = false;
+    stop_requested = false;
+
+    // Core 0, one above the touch task so a queued event is handled before the next read
+    BaseType_t ret = xTaskCreatePinnedToCore(
+        touch_ui_task,
+        "touch_ui",
+        TOUCH_UI_STACK_SIZE,
+        NULL,
+        4,     // Priority
+        &ui_task_handle,
+        0      // Core 0
+    );
+
+    if (ret != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create touch dispatcher");
+        ui_task_handle = NULL;
+        return ESP_FAIL;
+    }
+    mem_budget_register_task(ui_task_handle, TOUCH_UI_STACK_SIZE);
+    return ESP_OK;
+}
+
+esp_err_t touch_ui_stop(void)
+{
+    if (ui_task_handle == NULL) {
+        return ESP_OK;
+    }
+
+    stop_requested = true;
+    xTaskNotifyGive(ui_task_handle);
+
+    int timeout = 30;
+    while (ui_task_handle != NULL && timeout > 0) {
+        vTaskDelay(pdMS_TO_TICKS(100));
+        timeout--;
+    }
+
+    if (ui_task_handle != NULL) {
+        ESP_LOGW(TAG, "Force deleting touch dispatcher");
+        touch_input_set_ui_task(NULL);
+        mem_budget_unregister_task(ui_task_handle);
+        vTaskDelete(ui_task_handle);
+        ui_task_handle = NULL;
+    }
+    return ESP_OK;
+}
+
+void touch_ui_get_stats(touch_ui_stats_t *out_stats)
+{
+    portENTER_CRITICAL(&stats_lock);
+    *out_stats = stats;
+    portEXIT_CRITICAL(&stats_lock);
+}
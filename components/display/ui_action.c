@@ -0,0 +1,210 @@
+/**
+ * UI Action Worker Implementation
+ */
+
+#include "ui_action.h"
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "duinocoin_miner.h"
+#include "stats_journal.h"
+#include "mem_budget.h"
+
+static const char *TAG = "UI_ACTION";
+
+#define UI_ACTION_STACK_SIZE 4096
+#define UI_ACTION_WAIT_MS 100           // Queue wait between stop checks
+
+static TaskHandle_t action_task_handle = NULL;
+static volatile bool stop_requested = false;
+static QueueHandle_t action_queue = NULL;
+
+static ui_action_stats_t stats = {0};
+static portMUX_TYPE stats_lock = portMUX_INITIALIZER_UNLOCKED;
+
+/**
+ * @brief Switch mining mode: persist it, then stop or start the miners
+ */
+static esp_err_t ui_action_set_mode(mining_mode_t mode)
+{
+    if (config_get_mode() == mode) {
+        return ESP_OK;
+    }
+
+    esp_err_t ret = config_set_mode(mode);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    if (mode != MINING_MODE_DUINOCOIN) {
+        if (duco_miner_is_running()) {
+            // Keep lifetime counters from the last checkpoint interval
+            stats_totals_t totals;
+            if (duco_miner_get_totals(&totals) == ESP_OK) {
+                stats_journal_checkpoint(&totals, true);
+            }
+            duco_miner_stop();
+        }
+        if (mode == MINING_MODE_BITCOIN) {
+            ESP_LOGI(TAG, "Bitcoin mode not implemented yet");
+        }
+        return ESP_OK;
+    }
+
+    if (duco_miner_is_running()) {
+        return ESP_OK;
+    }
+    ret = duco_miner_init();
+    if (ret == ESP_OK) {
+        ret = duco_miner_start();
+    }
+    return ret;
+}
+
+static esp_err_t ui_action_run(const ui_action_t *action)
+{
+    switch (action->type) {
+        case UI_ACTION_SET_MODE:
+            return ui_action_set_mode(action->mode);
+        case UI_ACTION_SAVE_CONFIG: {
+            const miner_config_t *config = config_get_current();
+            return config ? config_save(config) : ESP_ERR_INVALID_STATE;
+        }
+        default:
+            return ESP_ERR_INVALID_ARG;
+    }
+}
+
+/**
+ * @brief Action worker task - runs slow UI actions off the UI thread
+ */
+static void ui_action_task(void *param)
+{
+    ESP_LOGI(TAG, "Action worker started");
+
+    while (!stop_requested) {
+        ui_action_t action;
+        if (xQueueReceive(action_queue, &action, pdMS_TO_TICKS(UI_ACTION_WAIT_MS)) != pdTRUE) {
+            continue;
+        }
+
+        int64_t start = esp_timer_get_time();
+        esp_err_t ret = ui_action_run(&action);
+        uint32_t elapsed_ms = (uint32_t)((esp_timer_get_time() - start) / 1000);
+
+        portENTER_CRITICAL(&stats_lock);
+        if (ret == ESP_OK) {
+            stats.completed++;
+        } else {
+            stats.failed++;
+        }
+        stats.last_ms = elapsed_ms;
+        if (elapsed_ms > stats.max_ms) {
+            stats.max_ms = elapsed_ms;
+        }
+        portEXIT_CRITICAL(&stats_lock);
+
+        if (ret != ESP_OK) {
+            ESP_LOGW(TAG, "Action %d failed: %s", action.type, esp_err_to_name(ret));
+        } else {
+            ESP_LOGI(TAG, "Action %d done in %lu ms", action.type, (unsigned long)elapsed_ms);
+        }
+        if (action.done) {
+            action.done(&action, ret, action.arg);
+        }
+    }
+
+    ESP_LOGI(TAG, "Action worker stopped");
+    mem_budget_unregister_task(NULL);
+    action_task_handle = NULL;
+    vTaskDelete(NULL);
+}
+
+esp_err_t ui_action_start(void)
+{
+    if (action_task_handle != NULL) {
+        return ESP_OK;
+    }
+
+    if (action_queue == NULL) {
+        action_queue = xQueueCreate(UI_ACTION_QUEUE_LEN, sizeof(ui_action_t));
+        if (action_queue == NULL) {
+            ESP_LOGE(TAG, "Failed to create action queue");
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    xQueueReset(action_queue);
+    stop_requested = false;
+
+    // Core 0, never on the UI thread's critical path; NVS writes need the stack
+    BaseType_t ret = xTaskCreatePinnedToCore(
+        ui_action_task,
+        "ui_action",
+        UI_ACTION_STACK_SIZE,
+        NULL,
+        3,     // Priority
+        &action_task_handle,
+        0      // Core 0
+    );
+
+    if (ret != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create action worker");
+        action_task_handle = NULL;
+        return ESP_FAIL;
+    }
+    mem_budget_register_task(action_task_handle, UI_ACTION_STACK_SIZE);
+    return ESP_OK;
+}
+
+esp_err_t ui_action_stop(void)
+{
+    if (action_task_handle == NULL) {
+        return ESP_OK;
+    }
+
+    stop_requested = true;
+
+    int timeout = 30;
+    while (action_task_handle != NULL && timeout > 0) {
+        vTaskDelay(pdMS_TO_TICKS(100));
+        timeout--;
+    }
+
+    if (action_task_handle != NULL) {
+        ESP_LOGW(TAG, "Force deleting action worker");
+        mem_budget_unregister_task(action_task_handle);
+        vTaskDelete(action_task_handle);
+        action_task_handle = NULL;
+    }
+    return ESP_OK;
+}
+
+esp_err_t ui_action_post(const ui_action_t *action)
+{
+    if (!action) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (action_task_handle == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    bool queued = xQueueSend(action_queue, action, 0) == pdTRUE;
+    portENTER_CRITICAL(&stats_lock);
+    if (queued) {
+        stats.posted++;
+    } else {
+        stats.rejected++;
+    }
+    portEXIT_CRITICAL(&stats_lock);
+    return queued ? ESP_OK : ESP_ERR_NO_MEM;
+}
+
+void ui_action_get_stats(ui_action_stats_t *out_stats)
+{
+    portENTER_CRITICAL(&stats_lock);
+    *out_stats = stats;
+    portEXIT_CRITICAL(&stats_lock);
+}
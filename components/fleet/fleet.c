@@ -0,0 +1,357 @@
+/**
+ * LAN Fleet Mode Implementation
+ */
+
+#include "fleet.h"
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_wifi.h"
+#include "esp_heap_caps.h"
+#include "lwip/sockets.h"
+#include "config.h"
+#include "miner_config.h"
+#include "duinocoin_miner.h"
+#include "thermal_governor.h"
+#include "wifi_manager.h"
+#include "mem_budget.h"
+
+static const char *TAG = "FLEET";
+
+#ifndef FLEET_MODE
+#define FLEET_MODE FLEET_MODE_OFF
+#endif
+
+#ifndef FLEET_PORT
+#define FLEET_PORT 45900
+#endif
+
+#ifndef FLEET_INTERVAL_SEC
+#define FLEET_INTERVAL_SEC 10
+#endif
+
+#define FLEET_STACK_SIZE 3072
+#define FLEET_SUMMARY_EVERY 6           // Reports between summary log lines
+#define FLEET_POLL_MAX_MS 1000          // Longest wait for a datagram
+
+static TaskHandle_t fleet_task_handle = NULL;
+static volatile bool stop_requested = false;
+
+// Device table (aggregator only), written by the fleet task
+static fleet_table_t table;
+static fleet_summary_t summary;
+// A mutex, not a spinlock: evaluating or copying a full table is too long
+// to run with interrupts masked
+static SemaphoreHandle_t table_mutex = NULL;
+
+static uint32_t now_ms(void)
+{
+    return (uint32_t)(esp_timer_get_time() / 1000);
+}
+
+/**
+ * @brief Fill this board's report from the local stats
+ */
+static void fleet_build_report(fleet_report_t *report, uint32_t seq)
+{
+    memset(report, 0, sizeof(*report));
+    report->seq = seq;
+    report->interval_s = FLEET_INTERVAL_SEC;
+    report->uptime_s = (uint32_t)(esp_timer_get_time() / 1000000);
+    report->temp_centi_c = FLEET_TEMP_UNKNOWN;
+    esp_wifi_get_mac(WIFI_IF_STA, report->device_id);
+
+    // First rig identifier names the board
+    const miner_config_t *config = config_get_current();
+    if (config) {
+        size_t len = strcspn(config->duco_rig_id, ",");
+        if (len > FLEET_NAME_MAX - 1) {
+            len = FLEET_NAME_MAX - 1;
+        }
+        memcpy(report->name, config->duco_rig_id, len);
+        report->mode = (uint8_t)config->active_mode;
+    }
+
+    if (duco_miner_is_running()) {
+        duco_stats_t stats;
+        if (duco_miner_get_stats(&stats) == ESP_OK) {
+            report->state = (uint8_t)stats.state;
+            report->hashrate = (uint32_t)stats.hashrate.wall_1m;
+            report->shares_accepted = stats.shares_accepted;
+            report->shares_rejected = stats.shares_rejected;
+        }
+    }
+
+    thermal_status_t thermal;
+    if (thermal_governor_get_status(&thermal) == ESP_OK) {
+        if (thermal.sensor_ok) {
+            report->temp_centi_c = (int16_t)(thermal.filtered_c * 100.0f);
+        }
+        if (thermal.effort < 1.0f) {
+            report->flags |= FLEET_FLAG_THROTTLED;
+        }
+        if (thermal.limits.shutdown) {
+            report->flags |= FLEET_FLAG_SHUTDOWN;
+        }
+    }
+
+    wifi_status_t wifi;
+    if (wifi_manager_get_status(&wifi) == ESP_OK) {
+        report->rssi = wifi.rssi;
+    }
+
+    report->free_heap_kb = (uint16_t)(heap_caps_get_free_size(MALLOC_CAP_INTERNAL) / 1024);
+    if (FLEET_MODE == FLEET_MODE_AGGREGATE) {
+        report->flags |= FLEET_FLAG_AGGREGATOR;
+    }
+}
+
+static int fleet_open_socket(void)
+{
+    int sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (sock < 0) {
+        ESP_LOGE(TAG, "Failed to create socket: errno %d", errno);
+        return -1;
+    }
+
+    int on = 1;
+    setsockopt(sock, SOL_SOCKET, SO_BROADCAST, &on, sizeof(on));
+
+    // Only the aggregator listens; reporters send from an ephemeral port
+    if (FLEET_MODE == FLEET_MODE_AGGREGATE) {
+        setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+        struct sockaddr_in addr = {
+            .sin_family = AF_INET,
+            .sin_port = htons(FLEET_PORT),
+            .sin_addr.s_addr = htonl(INADDR_ANY),
+        };
+        if (bind(sock, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+            ESP_LOGE(TAG, "Failed to bind port %d: errno %d", FLEET_PORT, errno);
+            close(sock);
+            return -1;
+        }
+    }
+    return sock;
+}
+
+static void fleet_log_summary(void)
+{
+    static fleet_device_t devices[FLEET_MAX_DEVICES];
+    fleet_summary_t s;
+    size_t count = fleet_get_devices(devices, FLEET_MAX_DEVICES, &s);
+
+    ESP_LOGI(TAG, "Fleet: %u/%u online, %.1f kH/s total (median %.1f kH/s), %u straggler(s), %u hot",
+             s.online, s.devices, s.hashrate / 1000.0, s.median_hashrate / 1000.0,
+             s.stragglers, s.hot);
+    for (size_t i = 0; i < count; i++) {
+        const fleet_device_t *dev = &devices[i];
+        if (dev->health == FLEET_HEALTH_OK) {
+            continue;
+        }
+        ESP_LOGW(TAG, "  %s [%02x%02x] %s: %lu H/s, seen %lu s ago, %lu lost",
+                 dev->report.name, dev->report.device_id[4], dev->report.device_id[5],
+                 fleet_health_name(dev->health), (unsigned long)dev->report.hashrate,
+                 (unsigned long)((now_ms() - dev->last_seen_ms) / 1000),
+                 (unsigned long)dev->lost);
+    }
+}
+
+static void fleet_receive(int sock)
+{
+    // One spare byte so oversized datagrams are rejected, not truncated to fit
+    uint8_t buf[FLEET_DATAGRAM_SIZE + 1];
+    struct sockaddr_in from;
+    socklen_t from_len = sizeof(from);
+
+    int len = recvfrom(sock, buf, sizeof(buf), MSG_DONTWAIT, (struct sockaddr *)&from, &from_len);
+    if (len <= 0) {
+        return;
+    }
+
+    xSemaphoreTake(table_mutex, portMAX_DELAY);
+    fleet_table_receive(&table, buf, len, from.sin_addr.s_addr, now_ms());
+    xSemaphoreGive(table_mutex);
+}
+
+/**
+ * @brief Fleet task - broadcasts reports and, as aggregator, collects them
+ */
+static void fleet_task(void *param)
+{
+    const bool aggregate = FLEET_MODE == FLEET_MODE_AGGREGATE;
+    const struct sockaddr_in dest = {
+        .sin_family = AF_INET,
+        .sin_port = htons(FLEET_PORT),
+        .sin_addr.s_addr = htonl(INADDR_BROADCAST),
+    };
+
+    ESP_LOGI(TAG, "Fleet %s on UDP port %d every %d s",
+             aggregate ? "aggregator" : "reporter", FLEET_PORT, FLEET_INTERVAL_SEC);
+
+    int sock = -1;
+    uint32_t seq = 0;
+    int64_t next_report = esp_timer_get_time();
+
+    while (!stop_requested) {
+        if (sock < 0) {
+            sock = fleet_open_socket();
+            if (sock < 0) {
+                vTaskDelay(pdMS_TO_TICKS(FLEET_INTERVAL_SEC * 1000));
+                continue;
+            }
+        }
+
+        int64_t now = esp_timer_get_time();
+        if (now >= next_report) {
+            next_report = now + (int64_t)FLEET_INTERVAL_SEC * 1000000;
+
+            fleet_report_t report;
+            uint8_t datagram[FLEET_DATAGRAM_SIZE];
+            fleet_build_report(&report, seq++);
+            fleet_encode(&report, datagram);
+
+            // Fails harmlessly while the link is down
+            if (wifi_manager_is_connected()) {
+                sendto(sock, datagram, sizeof(datagram), 0, (const struct sockaddr *)&dest, sizeof(dest));
+            }
+
+            if (aggregate) {
+                // Own report goes straight in - broadcasts do not loop back
+                xSemaphoreTake(table_mutex, portMAX_DELAY);
+                fleet_table_receive(&table, datagram, sizeof(datagram), 0, now_ms());
+                fleet_table_evaluate(&table, now_ms(), &summary);
+                xSemaphoreGive(table_mutex);
+
+                if (seq % FLEET_SUMMARY_EVERY == 0) {
+                    fleet_log_summary();
+                }
+            }
+            continue;
+        }
+
+        int64_t wait_ms = (next_report - now) / 1000 + 1;
+        if (!aggregate) {
+            vTaskDelay(pdMS_TO_TICKS(wait_ms));
+            continue;
+        }
+
+        if (wait_ms > FLEET_POLL_MAX_MS) {
+            wait_ms = FLEET_POLL_MAX_MS;
+        }
+        fd_set readfds;
+        FD_ZERO(&readfds);
+        FD_SET(sock, &readfds);
+        struct timeval tv = {
+            .tv_sec = wait_ms / 1000,
+            .tv_usec = (wait_ms % 1000) * 1000,
+        };
+        if (select(sock + 1, &readfds, NULL, NULL, &tv) > 0) {
+            fleet_receive(sock);
+        }
+    }
+
+    if (sock >= 0) {
+        close(sock);
+    }
+    ESP_LOGI(TAG, "Fleet task stopped");
+    mem_budget_unregister_task(NULL);
+    fleet_task_handle = NULL;
+    vTaskDelete(NULL);
+}
+
+esp_err_t fleet_start(void)
+{
+    if (FLEET_MODE == FLEET_MODE_OFF) {
+        ESP_LOGD(TAG, "Fleet mode off");
+        return ESP_OK;
+    }
+    if (fleet_task_handle != NULL) {
+        return ESP_OK;
+    }
+
+    if (table_mutex == NULL) {
+        table_mutex = xSemaphoreCreateMutex();
+        if (table_mutex == NULL) {
+            ESP_LOGE(TAG, "Failed to create table mutex");
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    xSemaphoreTake(table_mutex, portMAX_DELAY);
+    fleet_table_init(&table);
+    memset(&summary, 0, sizeof(summary));
+    xSemaphoreGive(table_mutex);
+    stop_requested = false;
+
+    // Core 0, low priority - a few microseconds per datagram
+    BaseType_t ret = xTaskCreatePinnedToCore(
+        fleet_task,
+        "fleet",
+        FLEET_STACK_SIZE,
+        NULL,
+        3,     // Priority
+        &fleet_task_handle,
+        0      // Core 0
+    );
+
+    if (ret != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create fleet task");
+        fleet_task_handle = NULL;
+        return ESP_FAIL;
+    }
+    mem_budget_register_task(fleet_task_handle, FLEET_STACK_SIZE);
+    return ESP_OK;
+}
+
+esp_err_t fleet_stop(void)
+{
+    if (fleet_task_handle == NULL) {
+        return ESP_OK;
+    }
+
+    stop_requested = true;
+
+    int timeout = 30;
+    while (fleet_task_handle != NULL && timeout > 0) {
+        vTaskDelay(pdMS_TO_TICKS(100));
+        timeout--;
+    }
+
+    if (fleet_task_handle != NULL) {
+        ESP_LOGW(TAG, "Force deleting fleet task");
+        mem_budget_unregister_task(fleet_task_handle);
+        vTaskDelete(fleet_task_handle);
+        fleet_task_handle = NULL;
+    }
+    return ESP_OK;
+}
+
+bool fleet_is_aggregator(void)
+{
+    return FLEET_MODE == FLEET_MODE_AGGREGATE && fleet_task_handle != NULL;
+}
+
+size_t fleet_get_devices(fleet_device_t *devices, size_t max, fleet_summary_t *out_summary)
+{
+    if (table_mutex == NULL) {
+        // Never started
+        if (out_summary) {
+            memset(out_summary, 0, sizeof(*out_summary));
+        }
+        return 0;
+    }
+
+    xSemaphoreTake(table_mutex, portMAX_DELAY);
+    size_t count = table.count < max ? table.count : max;
+    if (count > 0) {
+        memcpy(devices, table.devices, count * sizeof(fleet_device_t));
+    }
+    if (out_summary) {
+        *out_summary = summary;
+    }
+    xSemaphoreGive(table_mutex);
+    return count;
+}
@@ -0,0 +1,250 @@
+/**
+ * Fleet Wire Format and Aggregation Implementation
+ */
+
+#include "fleet_proto.h"
+#include <string.h>
+
+#define FLEET_MAGIC 0x464D534F          // "OSMF" read little-endian
+#define FLEET_CRC_OFFSET 60
+
+static inline void put_le16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static inline void put_le32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static inline uint16_t get_le16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | p[1] << 8);
+}
+
+static inline uint32_t get_le32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+/**
+ * @brief CRC-32 (IEEE 802.3), bitwise - 60 bytes every few seconds
+ */
+static uint32_t crc32(const uint8_t *data, size_t len)
+{
+    uint32_t crc = 0xFFFFFFFF;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (int k = 0; k < 8; k++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+        }
+    }
+    return ~crc;
+}
+
+void fleet_encode(const fleet_report_t *report, uint8_t out[FLEET_DATAGRAM_SIZE])
+{
+    memset(out, 0, FLEET_DATAGRAM_SIZE);
+    put_le32(out + 0, FLEET_MAGIC);
+    out[4] = FLEET_PROTO_VERSION;
+    out[5] = report->flags;
+    put_le16(out + 6, report->interval_s);
+    put_le32(out + 8, report->seq);
+    memcpy(out + 12, report->device_id, 6);
+    out[18] = report->mode;
+    out[19] = report->state;
+    memcpy(out + 20, report->name, strnlen(report->name, FLEET_NAME_MAX - 1));
+    put_le32(out + 36, report->uptime_s);
+    put_le32(out + 40, report->hashrate);
+    put_le32(out + 44, report->shares_accepted);
+    put_le32(out + 48, report->shares_rejected);
+    put_le16(out + 52, (uint16_t)report->temp_centi_c);
+    put_le16(out + 54, report->free_heap_kb);
+    out[56] = (uint8_t)report->rssi;
+    put_le32(out + FLEET_CRC_OFFSET, crc32(out, FLEET_CRC_OFFSET));
+}
+
+bool fleet_decode(const uint8_t *data, size_t len, fleet_report_t *report)
+{
+    if (len != FLEET_DATAGRAM_SIZE || get_le32(data) != FLEET_MAGIC ||
+        data[4] != FLEET_PROTO_VERSION ||
+        get_le32(data + FLEET_CRC_OFFSET) != crc32(data, FLEET_CRC_OFFSET)) {
+        return false;
+    }
+
+    report->version = data[4];
+    report->flags = data[5];
+    report->interval_s = get_le16(data + 6);
+    report->seq = get_le32(data + 8);
+    memcpy(report->device_id, data + 12, 6);
+    report->mode = data[18];
+    report->state = data[19];
+    memcpy(report->name, data + 20, FLEET_NAME_MAX);
+    report->name[FLEET_NAME_MAX - 1] = '\0';
+    report->uptime_s = get_le32(data + 36);
+    report->hashrate = get_le32(data + 40);
+    report->shares_accepted = get_le32(data + 44);
+    report->shares_rejected = get_le32(data + 48);
+    report->temp_centi_c = (int16_t)get_le16(data + 52);
+    report->free_heap_kb = get_le16(data + 54);
+    report->rssi = (int8_t)data[56];
+    return true;
+}
+
+void fleet_table_init(fleet_table_t *table)
+{
+    memset(table, 0, sizeof(*table));
+}
+
+static uint32_t device_offline_ms(const fleet_device_t *dev)
+{
+    uint32_t interval_s = dev->report.interval_s != 0 ? dev->report.interval_s : 1;
+    return interval_s * 1000 * FLEET_OFFLINE_INTERVALS;
+}
+
+static bool device_online(const fleet_device_t *dev, uint32_t now_ms)
+{
+    return now_ms - dev->last_seen_ms <= device_offline_ms(dev);
+}
+
+/**
+ * @brief Slot for a device: its existing one, a free one, or the stalest offline one
+ */
+static fleet_device_t *table_slot(fleet_table_t *table, const uint8_t device_id[6],
+                                  uint32_t now_ms, bool *is_new)
+{
+    *is_new = false;
+    for (int i = 0; i < table->count; i++) {
+        if (memcmp(table->devices[i].report.device_id, device_id, 6) == 0) {
+            return &table->devices[i];
+        }
+    }
+
+    *is_new = true;
+    if (table->count < FLEET_MAX_DEVICES) {
+        return &table->devices[table->count++];
+    }
+
+    fleet_device_t *stalest = NULL;
+    for (int i = 0; i < table->count; i++) {
+        fleet_device_t *dev = &table->devices[i];
+        if (!device_online(dev, now_ms) &&
+            (stalest == NULL || now_ms - dev->last_seen_ms > now_ms - stalest->last_seen_ms)) {
+            stalest = dev;
+        }
+    }
+    return stalest;
+}
+
+fleet_device_t *fleet_table_receive(fleet_table_t *table, const uint8_t *data, size_t len,
+                                    uint32_t addr, uint32_t now_ms)
+{
+    fleet_report_t report;
+    if (!fleet_decode(data, len, &report)) {
+        table->rejected++;
+        return NULL;
+    }
+
+    bool is_new;
+    fleet_device_t *dev = table_slot(table, report.device_id, now_ms, &is_new);
+    if (dev == NULL) {
+        table->dropped_full++;
+        return NULL;
+    }
+
+    if (is_new) {
+        memset(dev, 0, sizeof(*dev));
+        dev->first_seen_ms = now_ms;
+    } else {
+        const fleet_report_t *prev = &dev->report;
+        if (report.seq == prev->seq && report.uptime_s == prev->uptime_s) {
+            // Same datagram again (e.g. heard on two interfaces)
+            dev->last_seen_ms = now_ms;
+            return dev;
+        }
+        if (report.seq < prev->seq || report.uptime_s < prev->uptime_s) {
+            dev->restarts++;
+        } else if (report.seq > prev->seq + 1) {
+            dev->lost += report.seq - prev->seq - 1;
+        }
+    }
+
+    dev->report = report;
+    dev->addr = addr;
+    dev->last_seen_ms = now_ms;
+    dev->received++;
+    return dev;
+}
+
+void fleet_table_evaluate(fleet_table_t *table, uint32_t now_ms, fleet_summary_t *summary)
+{
+    uint32_t rates[FLEET_MAX_DEVICES];
+    int online = 0;
+
+    // Median of online devices, insertion sorted (at most 32)
+    for (int i = 0; i < table->count; i++) {
+        const fleet_device_t *dev = &table->devices[i];
+        if (!device_online(dev, now_ms)) {
+            continue;
+        }
+        int k = online++;
+        while (k > 0 && rates[k - 1] > dev->report.hashrate) {
+            rates[k] = rates[k - 1];
+            k--;
+        }
+        rates[k] = dev->report.hashrate;
+    }
+    uint32_t median = 0;
+    if (online > 0) {
+        median = online % 2 ? rates[online / 2]
+                            : (uint32_t)(((uint64_t)rates[online / 2 - 1] + rates[online / 2]) / 2);
+    }
+
+    fleet_summary_t s = {
+        .devices = table->count,
+        .online = (uint8_t)online,
+        .median_hashrate = median,
+    };
+    for (int i = 0; i < table->count; i++) {
+        fleet_device_t *dev = &table->devices[i];
+        const fleet_report_t *r = &dev->report;
+
+        if (!device_online(dev, now_ms)) {
+            dev->health = FLEET_HEALTH_OFFLINE;
+        } else if (r->flags & (FLEET_FLAG_THROTTLED | FLEET_FLAG_SHUTDOWN)) {
+            dev->health = FLEET_HEALTH_HOT;
+            s.hot++;
+        } else if (online > 1 && (uint64_t)r->hashrate * 100 < (uint64_t)median * FLEET_STRAGGLER_PCT) {
+            dev->health = FLEET_HEALTH_STRAGGLER;
+            s.stragglers++;
+        } else {
+            dev->health = FLEET_HEALTH_OK;
+        }
+
+        if (dev->health != FLEET_HEALTH_OFFLINE) {
+            s.hashrate += r->hashrate;
+        }
+        s.shares_accepted += r->shares_accepted;
+        s.shares_rejected += r->shares_rejected;
+    }
+
+    if (summary) {
+        *summary = s;
+    }
+}
+
+const char *fleet_health_name(fleet_health_t health)
+{
+    switch (health) {
+        case FLEET_HEALTH_OK: return "ok";
+        case FLEET_HEALTH_STRAGGLER: return "straggler";
+        case FLEET_HEALTH_HOT: return "hot";
+        case FLEET_HEALTH_OFFLINE: return "offline";
+        default: return "unknown";
+    }
+}
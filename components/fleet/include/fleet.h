@@ -0,0 +1,64 @@
+/**
+ * LAN Fleet Mode
+ *
+ * Optional: with FLEET_MODE set in config.h, the board broadcasts a compact
+ * stats report (see fleet_proto.h) on UDP port FLEET_PORT every
+ * FLEET_INTERVAL_SEC. In aggregator mode it also collects every report on
+ * the LAN, including its own, classifies devices (ok / straggler / hot /
+ * offline) and logs a fleet summary; /metrics exports the table.
+ *
+ * The task runs on core 0 and spends a few microseconds per datagram.
+ */
+
+#ifndef FLEET_H
+#define FLEET_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "fleet_proto.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// FLEET_MODE values
+#define FLEET_MODE_OFF 0
+#define FLEET_MODE_REPORT 1             // Broadcast own stats only
+#define FLEET_MODE_AGGREGATE 2          // Broadcast and collect
+
+/**
+ * @brief Start fleet reporting (does nothing when FLEET_MODE is off)
+ *
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t fleet_start(void);
+
+/**
+ * @brief Stop fleet reporting
+ *
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t fleet_stop(void);
+
+/**
+ * @brief Check if this board collects fleet reports
+ */
+bool fleet_is_aggregator(void);
+
+/**
+ * @brief Copy the device table and fleet summary
+ *
+ * @param devices Output array (may be NULL with max 0 for the summary only)
+ * @param max Capacity of devices
+ * @param summary Output summary (may be NULL)
+ * @return Number of devices written
+ */
+size_t fleet_get_devices(fleet_device_t *devices, size_t max, fleet_summary_t *summary);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FLEET_H
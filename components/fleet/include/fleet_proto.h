@@ -0,0 +1,154 @@
+/**
+ * Fleet Wire Format and Aggregation
+ *
+ * Every miner in fleet mode broadcasts one fixed-size report datagram per
+ * interval; any board (or tools/fleet_sim on a PC) can collect them into a
+ * device table and summarize the fleet. Pure C with no ESP-IDF dependencies
+ * so the host tool builds the same code.
+ *
+ * Datagram (FLEET_DATAGRAM_SIZE bytes, little-endian):
+ *
+ *   0  magic "OSMF"        20 name[16]            52 temp_centi_c (i16)
+ *   4  version (u8)        36 uptime_s            54 free_heap_kb (u16)
+ *   5  flags (u8)          40 hashrate (H/s)      56 rssi (i8)
+ *   6  interval_s (u16)    44 shares_accepted     57 reserved[3], zero
+ *   8  seq                 48 shares_rejected     60 CRC-32 of bytes 0..59
+ *  12  device_id[6]
+ *  18  mode (u8)
+ *  19  state (u8)
+ *
+ * A change to the layout bumps FLEET_PROTO_VERSION; receivers drop other
+ * versions instead of misreading them.
+ */
+
+#ifndef FLEET_PROTO_H
+#define FLEET_PROTO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FLEET_PROTO_VERSION 1
+#define FLEET_DATAGRAM_SIZE 64
+#define FLEET_NAME_MAX 16               // Including the NUL
+#define FLEET_MAX_DEVICES 32
+
+#define FLEET_OFFLINE_INTERVALS 3       // Missed reports before a device is offline
+#define FLEET_STRAGGLER_PCT 50          // Below this % of the fleet median hashrate
+
+#define FLEET_TEMP_UNKNOWN INT16_MIN
+
+// Report flags
+#define FLEET_FLAG_THROTTLED 0x01       // Thermal governor below full effort
+#define FLEET_FLAG_SHUTDOWN 0x02        // Thermal hard limit reached
+#define FLEET_FLAG_AGGREGATOR 0x04      // Sender also collects reports
+
+// One device's report, decoded
+typedef struct {
+    uint8_t device_id[6];               // Station MAC
+    char name[FLEET_NAME_MAX];
+    uint8_t version;
+    uint8_t flags;
+    uint16_t interval_s;                // Sender's report interval
+    uint32_t seq;
+    uint8_t mode;                       // mining_mode_t
+    uint8_t state;                      // duco_state_t
+    uint32_t uptime_s;
+    uint32_t hashrate;                  // H/s, wall clock 1 min average
+    uint32_t shares_accepted;           // Lifetime
+    uint32_t shares_rejected;
+    int16_t temp_centi_c;               // FLEET_TEMP_UNKNOWN without a sensor
+    uint16_t free_heap_kb;
+    int8_t rssi;
+} fleet_report_t;
+
+typedef enum {
+    FLEET_HEALTH_OK = 0,
+    FLEET_HEALTH_STRAGGLER,             // Online but well below the fleet median
+    FLEET_HEALTH_HOT,                   // Thermally throttled or shut down
+    FLEET_HEALTH_OFFLINE,               // No report for FLEET_OFFLINE_INTERVALS
+} fleet_health_t;
+
+// Aggregator's view of one device
+typedef struct {
+    fleet_report_t report;              // Latest
+    uint32_t addr;                      // Sender IPv4, network byte order
+    uint32_t first_seen_ms;
+    uint32_t last_seen_ms;
+    uint32_t received;
+    uint32_t lost;                      // Reports missing from sequence gaps
+    uint32_t restarts;                  // Sequence or uptime went backwards
+    fleet_health_t health;              // As of the last fleet_table_evaluate()
+} fleet_device_t;
+
+typedef struct {
+    fleet_device_t devices[FLEET_MAX_DEVICES];
+    uint8_t count;
+    uint32_t rejected;                  // Wrong size, magic, version or CRC
+    uint32_t dropped_full;              // New devices with no free slot
+} fleet_table_t;
+
+typedef struct {
+    uint8_t devices;
+    uint8_t online;
+    uint8_t stragglers;
+    uint8_t hot;
+    uint64_t hashrate;                  // Sum over online devices
+    uint32_t median_hashrate;           // Over online devices
+    uint64_t shares_accepted;           // Sum over all devices
+    uint64_t shares_rejected;
+} fleet_summary_t;
+
+/**
+ * @brief Encode a report into a datagram
+ *
+ * The version field is always FLEET_PROTO_VERSION.
+ */
+void fleet_encode(const fleet_report_t *report, uint8_t out[FLEET_DATAGRAM_SIZE]);
+
+/**
+ * @brief Decode and validate a datagram
+ *
+ * @return false on wrong size, magic, version or checksum
+ */
+bool fleet_decode(const uint8_t *data, size_t len, fleet_report_t *report);
+
+/**
+ * @brief Empty a device table
+ */
+void fleet_table_init(fleet_table_t *table);
+
+/**
+ * @brief Decode a datagram and fold it into the table
+ *
+ * Devices are keyed by device_id. When the table is full, the device
+ * silent the longest is replaced if it is offline.
+ *
+ * @param addr Sender address (for display only)
+ * @param now_ms Caller clock, milliseconds
+ * @return The updated device, or NULL if the datagram was rejected or dropped
+ */
+fleet_device_t *fleet_table_receive(fleet_table_t *table, const uint8_t *data, size_t len,
+                                    uint32_t addr, uint32_t now_ms);
+
+/**
+ * @brief Classify every device and summarize the fleet
+ *
+ * @param summary Output (may be NULL to only refresh device health)
+ */
+void fleet_table_evaluate(fleet_table_t *table, uint32_t now_ms, fleet_summary_t *summary);
+
+/**
+ * @brief Short name of a health value ("ok", "straggler", "hot", "offline")
+ */
+const char *fleet_health_name(fleet_health_t health);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FLEET_PROTO_H
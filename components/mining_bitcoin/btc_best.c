@@ -0,0 +1,73 @@
+/**
+ * Bitcoin Best-Difficulty Store Implementation
+ */
+
+#include "btc_best.h"
+#include <string.h>
+#include "esp_log.h"
+#include "nvs.h"
+
+static const char *TAG = "BTC_BEST";
+
+#define BTC_NVS_NAMESPACE "btc"
+#define BTC_NVS_BEST_DIFF "best_diff"
+
+esp_err_t btc_best_load(double *best)
+{
+    *best = 0.0;
+
+    nvs_handle_t nvs_handle;
+    esp_err_t ret = nvs_open(BTC_NVS_NAMESPACE, NVS_READONLY, &nvs_handle);
+    if (ret == ESP_ERR_NVS_NOT_FOUND) {
+        return ESP_OK;
+    }
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    // Stored as the raw bits of the double
+    uint64_t bits = 0;
+    ret = nvs_get_u64(nvs_handle, BTC_NVS_BEST_DIFF, &bits);
+    nvs_close(nvs_handle);
+
+    if (ret == ESP_ERR_NVS_NOT_FOUND) {
+        return ESP_OK;
+    }
+    if (ret == ESP_OK) {
+        double value;
+        memcpy(&value, &bits, sizeof(value));
+        if (value > 0.0) {
+            *best = value;
+        }
+    }
+    return ret;
+}
+
+esp_err_t btc_best_save(double best)
+{
+    double stored;
+    if (btc_best_load(&stored) == ESP_OK && !(best > stored)) {
+        return ESP_OK;
+    }
+
+    nvs_handle_t nvs_handle;
+    esp_err_t ret = nvs_open(BTC_NVS_NAMESPACE, NVS_READWRITE, &nvs_handle);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    uint64_t bits;
+    memcpy(&bits, &best, sizeof(bits));
+    ret = nvs_set_u64(nvs_handle, BTC_NVS_BEST_DIFF, bits);
+    if (ret == ESP_OK) {
+        ret = nvs_commit(nvs_handle);
+    }
+    nvs_close(nvs_handle);
+
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to save best difficulty: %s", esp_err_to_name(ret));
+    } else {
+        ESP_LOGI(TAG, "New all-time best difficulty %.1f", best);
+    }
+    return ret;
+}
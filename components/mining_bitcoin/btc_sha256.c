@@ -0,0 +1,150 @@
+/**
+ * SHA-256 for Bitcoin Headers Implementation
+ */
+
+#include "btc_sha256.h"
+#include <string.h>
+
+#define ROR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+static const uint32_t K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+static const uint32_t H0[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+};
+
+static inline uint32_t load_be32(const uint8_t *p)
+{
+    return (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | p[3];
+}
+
+static inline void store_be32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)v;
+}
+
+void btc_sha256_init_state(uint32_t state[8])
+{
+    memcpy(state, H0, sizeof(H0));
+}
+
+void btc_sha256_compress(uint32_t state[8], const uint8_t block[64])
+{
+    uint32_t w[64];
+    for (int i = 0; i < 16; i++) {
+        w[i] = load_be32(block + i * 4);
+    }
+    for (int i = 16; i < 64; i++) {
+        uint32_t s0 = ROR(w[i - 15], 7) ^ ROR(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = ROR(w[i - 2], 17) ^ ROR(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+    for (int i = 0; i < 64; i++) {
+        uint32_t t1 = h + (ROR(e, 6) ^ ROR(e, 11) ^ ROR(e, 25)) + ((e & f) ^ (~e & g)) + K[i] + w[i];
+        uint32_t t2 = (ROR(a, 2) ^ ROR(a, 13) ^ ROR(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+}
+
+void btc_sha256(const uint8_t *data, size_t len, uint8_t out[32])
+{
+    uint32_t state[8];
+    uint8_t block[64];
+    size_t done = 0;
+
+    btc_sha256_init_state(state);
+    for (; len - done >= 64; done += 64) {
+        btc_sha256_compress(state, data + done);
+    }
+
+    // Padding: 0x80, zeros, 64-bit big-endian bit length
+    size_t rest = len - done;
+    memset(block, 0, sizeof(block));
+    memcpy(block, data + done, rest);
+    block[rest] = 0x80;
+    if (rest >= 56) {
+        btc_sha256_compress(state, block);
+        memset(block, 0, sizeof(block));
+    }
+    uint64_t bits = (uint64_t)len * 8;
+    store_be32(block + 56, (uint32_t)(bits >> 32));
+    store_be32(block + 60, (uint32_t)bits);
+    btc_sha256_compress(state, block);
+
+    for (int i = 0; i < 8; i++) {
+        store_be32(out + i * 4, state[i]);
+    }
+}
+
+void btc_sha256d(const uint8_t *data, size_t len, uint8_t out[32])
+{
+    uint8_t first[32];
+    btc_sha256(data, len, first);
+    btc_sha256(first, sizeof(first), out);
+}
+
+void btc_sha256_midstate(const uint8_t header[BTC_HEADER_SIZE], uint32_t midstate[8])
+{
+    btc_sha256_init_state(midstate);
+    btc_sha256_compress(midstate, header);
+}
+
+void btc_sha256d_header(const uint32_t midstate[8], const uint8_t tail[16], uint8_t out[32])
+{
+    uint32_t state[8];
+    uint8_t block[64] = {0};
+
+    // Second block of the header: 16 bytes, padding, length 640 bits
+    memcpy(state, midstate, sizeof(state));
+    memcpy(block, tail, 16);
+    block[16] = 0x80;
+    block[62] = 0x02;
+    block[63] = 0x80;
+    btc_sha256_compress(state, block);
+
+    // Second hash over the 32-byte digest
+    memset(block, 0, sizeof(block));
+    for (int i = 0; i < 8; i++) {
+        store_be32(block + i * 4, state[i]);
+    }
+    block[32] = 0x80;
+    block[62] = 0x01;
+    block[63] = 0x00;
+    btc_sha256_init_state(state);
+    btc_sha256_compress(state, block);
+
+    for (int i = 0; i < 8; i++) {
+        store_be32(out + i * 4, state[i]);
+    }
+}
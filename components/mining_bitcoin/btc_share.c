@@ -0,0 +1,163 @@
+/**
+ * Bitcoin Share Filter Implementation
+ */
+
+#include "btc_share.h"
+#include "btc_target.h"
+#include "btc_sha256.h"
+#include <string.h>
+
+#define HDR_NONCE_TAIL 12               // Nonce offset within header bytes 64..79
+
+static inline void store_le32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+/**
+ * @brief Precheck bound: the pool target's top word or the best-tracking floor
+ */
+static void filter_update_precheck(btc_share_filter_t *filter)
+{
+    uint32_t best_floor = UINT32_MAX >> BTC_BEST_MIN_ZERO_BITS;
+    uint32_t pool_top = btc_target_top_word(filter->pool_target);
+    filter->precheck_top = pool_top > best_floor ? pool_top : best_floor;
+}
+
+static void filter_apply_difficulty(btc_share_filter_t *filter, double difficulty)
+{
+    filter->pool_difficulty = difficulty;
+    btc_target_from_difficulty(difficulty, filter->pool_target);
+    filter_update_precheck(filter);
+}
+
+void btc_share_filter_init(btc_share_filter_t *filter, double alltime_best)
+{
+    memset(filter, 0, sizeof(*filter));
+    filter->alltime_best = alltime_best > 0.0 ? alltime_best : 0.0;
+
+    // Zero targets: nothing qualifies until the pool sets a difficulty
+    filter_update_precheck(filter);
+}
+
+void btc_share_new_session(btc_share_filter_t *filter)
+{
+    filter->session_best = 0.0;
+    filter->pool_difficulty = 0.0;
+    filter->pending_difficulty = 0.0;
+    memset(filter->pool_target, 0, sizeof(filter->pool_target));
+    memset(filter->network_target, 0, sizeof(filter->network_target));
+    filter_update_precheck(filter);
+}
+
+void btc_share_set_difficulty(btc_share_filter_t *filter, double difficulty)
+{
+    if (!(difficulty > 0.0)) {
+        return;
+    }
+    if (filter->pool_difficulty == 0.0) {
+        filter_apply_difficulty(filter, difficulty);
+    } else {
+        filter->pending_difficulty = difficulty;
+    }
+}
+
+void btc_share_set_job(btc_share_filter_t *filter, uint32_t nbits)
+{
+    if (filter->pending_difficulty > 0.0) {
+        filter_apply_difficulty(filter, filter->pending_difficulty);
+        filter->pending_difficulty = 0.0;
+    }
+    btc_target_from_nbits(nbits, filter->network_target);
+}
+
+btc_share_verdict_t btc_share_check(btc_share_filter_t *filter, const uint8_t hash[32],
+                                    double *difficulty)
+{
+    if (btc_target_top_word(hash) > filter->precheck_top) {
+        return BTC_SHARE_NONE;
+    }
+    filter->stats.prechecked++;
+
+    double achieved = btc_target_difficulty(hash);
+    if (difficulty) {
+        *difficulty = achieved;
+    }
+    if (achieved > filter->session_best) {
+        filter->session_best = achieved;
+    }
+    if (achieved > filter->alltime_best) {
+        filter->alltime_best = achieved;
+        filter->alltime_dirty = true;
+    }
+
+    if (filter->pool_difficulty == 0.0 || !btc_target_met(hash, filter->pool_target)) {
+        return BTC_SHARE_NONE;
+    }
+    filter->stats.shares++;
+    filter->stats.share_difficulty += filter->pool_difficulty;
+
+    if (btc_target_met(hash, filter->network_target)) {
+        filter->stats.blocks++;
+        return BTC_SHARE_BLOCK;
+    }
+    return BTC_SHARE_SUBMIT;
+}
+
+uint32_t btc_share_scan(btc_share_filter_t *filter, const btc_work_t *work, uint32_t nonce,
+                        uint32_t count, btc_share_t *shares, uint32_t max_shares,
+                        uint32_t *scanned)
+{
+    uint8_t tail[16];
+    uint8_t hash[32];
+    uint32_t found = 0;
+    uint32_t i = 0;
+
+    memcpy(tail, work->header + 64, sizeof(tail));
+
+    while (i < count && found < max_shares) {
+        uint32_t n = nonce + i++;
+        store_le32(tail + HDR_NONCE_TAIL, n);
+        btc_sha256d_header(work->midstate, tail, hash);
+
+        // Hot path: one compare on the leading zeros
+        if (btc_target_top_word(hash) > filter->precheck_top) {
+            continue;
+        }
+
+        double difficulty = 0.0;
+        btc_share_verdict_t verdict = btc_share_check(filter, hash, &difficulty);
+        if (verdict == BTC_SHARE_NONE) {
+            continue;
+        }
+
+        btc_share_t *share = &shares[found++];
+        memcpy(share->job_id, work->job_id, sizeof(share->job_id));
+        memcpy(share->extranonce2, work->extranonce2, sizeof(share->extranonce2));
+        share->extranonce2_size = work->extranonce2_size;
+        share->ntime = work->ntime;
+        share->nonce = n;
+        share->version = work->version;
+        share->difficulty = difficulty;
+        share->block = verdict == BTC_SHARE_BLOCK;
+    }
+
+    filter->stats.hashes += i;
+    if (scanned) {
+        *scanned = i;
+    }
+    return found;
+}
+
+bool btc_share_take_alltime_best(btc_share_filter_t *filter, double *best)
+{
+    if (!filter->alltime_dirty) {
+        return false;
+    }
+    filter->alltime_dirty = false;
+    *best = filter->alltime_best;
+    return true;
+}
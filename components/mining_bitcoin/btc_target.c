@@ -0,0 +1,75 @@
+/**
+ * Bitcoin Targets and Difficulty Implementation
+ */
+
+#include "btc_target.h"
+#include <string.h>
+#include <math.h>
+
+// Difficulty 1 target, 0xFFFF * 2^208
+#define DIFF1_TARGET ldexp(0xFFFF, 208)
+
+void btc_target_from_difficulty(double difficulty, uint8_t target[32])
+{
+    double value = difficulty > 0.0 ? DIFF1_TARGET / difficulty : INFINITY;
+    if (!(value < ldexp(1.0, 256))) {
+        memset(target, 0xFF, 32);
+        return;
+    }
+
+    // Peel off 64-bit words, most significant first
+    for (int word = 3; word >= 0; word--) {
+        double scale = ldexp(1.0, 64 * word);
+        uint64_t w = (uint64_t)(value / scale);
+        value -= (double)w * scale;
+        if (value < 0.0) {
+            value = 0.0;
+        }
+        for (int i = 0; i < 8; i++) {
+            target[word * 8 + i] = (uint8_t)(w >> (8 * i));
+        }
+    }
+}
+
+void btc_target_from_nbits(uint32_t nbits, uint8_t target[32])
+{
+    memset(target, 0, 32);
+
+    uint32_t exponent = nbits >> 24;
+    uint32_t mantissa = nbits & 0x007FFFFF;
+    if ((nbits & 0x00800000) != 0 || mantissa == 0) {
+        return;
+    }
+
+    // value = mantissa * 256^(exponent - 3)
+    for (int i = 0; i < 3; i++) {
+        int pos = (int)exponent - 3 + i;
+        uint8_t byte = (uint8_t)(mantissa >> (8 * i));
+        if (pos >= 32 && byte != 0) {
+            memset(target, 0, 32);
+            return;
+        }
+        if (pos >= 0 && pos < 32) {
+            target[pos] = byte;
+        }
+    }
+}
+
+bool btc_target_met(const uint8_t hash[32], const uint8_t target[32])
+{
+    for (int i = 31; i >= 0; i--) {
+        if (hash[i] != target[i]) {
+            return hash[i] < target[i];
+        }
+    }
+    return true;
+}
+
+double btc_target_difficulty(const uint8_t hash[32])
+{
+    double value = 0.0;
+    for (int i = 31; i >= 0; i--) {
+        value = value * 256.0 + hash[i];
+    }
+    return value > 0.0 ? DIFF1_TARGET / value : INFINITY;
+}
@@ -0,0 +1,200 @@
+/**
+ * Bitcoin Work Generator Implementation
+ */
+
+#include "btc_work.h"
+#include <string.h>
+
+// Header field offsets
+#define HDR_VERSION 0
+#define HDR_PREVHASH 4
+#define HDR_MERKLE 36
+#define HDR_NTIME 68
+#define HDR_NBITS 72
+#define HDR_NONCE 76
+
+static inline void store_le32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+/**
+ * @brief Spread the low bits of counter over the set bits of mask
+ */
+static uint32_t deposit_bits(uint32_t counter, uint32_t mask)
+{
+    uint32_t out = 0;
+    for (uint32_t bit = 1; mask != 0 && counter != 0; bit <<= 1) {
+        if (mask & bit) {
+            if (counter & 1) {
+                out |= bit;
+            }
+            counter >>= 1;
+            mask &= ~bit;
+        }
+    }
+    return out;
+}
+
+static void extranonce2_bytes(const btc_work_gen_t *gen, uint8_t out[BTC_EXTRANONCE_MAX])
+{
+    uint64_t v = gen->extranonce2;
+    for (int i = 0; i < gen->session.extranonce2_size; i++) {
+        out[i] = (uint8_t)v;
+        v >>= 8;
+    }
+}
+
+/**
+ * @brief Pool clock estimate: notified ntime plus time since the notify
+ */
+static uint32_t job_ntime_now(const btc_work_gen_t *gen, uint32_t now_s)
+{
+    return gen->job.ntime + (now_s - gen->job_received_s);
+}
+
+static void gen_set_version(btc_work_gen_t *gen)
+{
+    uint32_t version = gen->job.version ^ deposit_bits(gen->version_roll, gen->session.version_mask);
+    store_le32(gen->header + HDR_VERSION, version);
+}
+
+static void gen_set_ntime(btc_work_gen_t *gen, uint32_t ntime)
+{
+    gen->ntime_next = ntime;
+    store_le32(gen->header + HDR_NTIME, ntime);
+}
+
+static void gen_build_merkle(btc_work_gen_t *gen)
+{
+    uint8_t en2[BTC_EXTRANONCE_MAX];
+    extranonce2_bytes(gen, en2);
+    btc_work_merkle_root(&gen->job, &gen->session, en2, gen->header + HDR_MERKLE);
+    gen->stats.merkle_builds++;
+}
+
+static void gen_build_midstate(btc_work_gen_t *gen)
+{
+    btc_sha256_midstate(gen->header, gen->midstate);
+    gen->stats.midstates++;
+}
+
+void btc_work_merkle_root(const btc_job_t *job, const btc_session_t *session,
+                          const uint8_t *extranonce2, uint8_t root[32])
+{
+    uint8_t coinbase[2 * BTC_COINB_MAX + 2 * BTC_EXTRANONCE_MAX];
+    size_t len = 0;
+
+    memcpy(coinbase + len, job->coinb1, job->coinb1_len);
+    len += job->coinb1_len;
+    memcpy(coinbase + len, session->extranonce1, session->extranonce1_len);
+    len += session->extranonce1_len;
+    memcpy(coinbase + len, extranonce2, session->extranonce2_size);
+    len += session->extranonce2_size;
+    memcpy(coinbase + len, job->coinb2, job->coinb2_len);
+    len += job->coinb2_len;
+
+    btc_sha256d(coinbase, len, root);
+
+    uint8_t pair[64];
+    for (int i = 0; i < job->merkle_count; i++) {
+        memcpy(pair, root, 32);
+        memcpy(pair + 32, job->merkle_branch[i], 32);
+        btc_sha256d(pair, sizeof(pair), root);
+    }
+}
+
+bool btc_work_gen_init(btc_work_gen_t *gen, const btc_session_t *session)
+{
+    if (session->extranonce1_len > BTC_EXTRANONCE_MAX ||
+        session->extranonce2_size == 0 || session->extranonce2_size > BTC_EXTRANONCE_MAX) {
+        return false;
+    }
+
+    memset(gen, 0, sizeof(*gen));
+    gen->session = *session;
+    if (gen->session.ntime_drift_s == 0) {
+        gen->session.ntime_drift_s = BTC_NTIME_DRIFT_DEFAULT;
+    }
+
+    gen->extranonce2_limit = session->extranonce2_size >= 8 ?
+                             UINT64_MAX : (uint64_t)1 << (8 * session->extranonce2_size);
+    int mask_bits = __builtin_popcount(session->version_mask);
+    gen->version_roll_limit = mask_bits >= 32 ? UINT32_MAX : (uint32_t)1 << mask_bits;
+    return true;
+}
+
+bool btc_work_gen_set_job(btc_work_gen_t *gen, const btc_job_t *job, uint32_t now_s)
+{
+    if (job->coinb1_len > BTC_COINB_MAX || job->coinb2_len > BTC_COINB_MAX ||
+        job->merkle_count > BTC_MERKLE_MAX) {
+        return false;
+    }
+
+    gen->job = *job;
+    gen->job.job_id[BTC_JOB_ID_MAX - 1] = '\0';
+    gen->job_received_s = now_s;
+    gen->has_job = true;
+    gen->extranonce2 = 0;
+    gen->version_roll = 0;
+
+    memset(gen->header, 0, sizeof(gen->header));
+    memcpy(gen->header + HDR_PREVHASH, job->prevhash, 32);
+    store_le32(gen->header + HDR_NBITS, job->nbits);
+    gen_set_version(gen);
+    gen_set_ntime(gen, job->ntime);
+    gen_build_merkle(gen);
+    gen_build_midstate(gen);
+    gen->fresh = true;
+    return true;
+}
+
+bool btc_work_gen_next(btc_work_gen_t *gen, btc_work_t *work, uint32_t now_s)
+{
+    if (!gen->has_job) {
+        gen->stats.exhausted++;
+        return false;
+    }
+
+    if (!gen->fresh) {
+        uint32_t ntime_limit = job_ntime_now(gen, now_s) + gen->session.ntime_drift_s;
+
+        if (gen->ntime_next < ntime_limit) {
+            // Second block only - midstate unchanged
+            gen_set_ntime(gen, gen->ntime_next + 1);
+            gen->stats.ntime_rolls++;
+        } else if (gen->version_roll + 1 < gen->version_roll_limit) {
+            gen->version_roll++;
+            gen_set_version(gen);
+            gen_set_ntime(gen, job_ntime_now(gen, now_s));
+            gen_build_midstate(gen);
+            gen->stats.version_rolls++;
+        } else if (gen->extranonce2 + 1 < gen->extranonce2_limit) {
+            gen->extranonce2++;
+            gen->version_roll = 0;
+            gen_set_version(gen);
+            gen_set_ntime(gen, job_ntime_now(gen, now_s));
+            gen_build_merkle(gen);
+            gen_build_midstate(gen);
+            gen->stats.extranonce2_rolls++;
+        } else {
+            gen->stats.exhausted++;
+            return false;
+        }
+    }
+    gen->fresh = false;
+
+    memcpy(work->job_id, gen->job.job_id, sizeof(work->job_id));
+    memcpy(work->header, gen->header, sizeof(work->header));
+    memcpy(work->midstate, gen->midstate, sizeof(work->midstate));
+    memset(work->extranonce2, 0, sizeof(work->extranonce2));
+    extranonce2_bytes(gen, work->extranonce2);
+    work->extranonce2_size = gen->session.extranonce2_size;
+    work->ntime = gen->ntime_next;
+    work->version = gen->job.version ^ deposit_bits(gen->version_roll, gen->session.version_mask);
+    gen->stats.headers++;
+    return true;
+}
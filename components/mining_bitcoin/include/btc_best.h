@@ -0,0 +1,37 @@
+/**
+ * Bitcoin Best-Difficulty Store
+ *
+ * Keeps the all-time best share difficulty in NVS across reboots. New
+ * records get exponentially rarer as hashing goes on, so writing on every
+ * improvement costs a handful of flash writes over the device's life.
+ */
+
+#ifndef BTC_BEST_H
+#define BTC_BEST_H
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Load the persisted all-time best
+ *
+ * @param best Output, 0 if nothing was stored
+ * @return ESP_OK on success (including when nothing was stored)
+ */
+esp_err_t btc_best_load(double *best);
+
+/**
+ * @brief Persist a new all-time best (ignored unless it beats the stored one)
+ *
+ * @return ESP_OK on success
+ */
+esp_err_t btc_best_save(double best);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BTC_BEST_H
@@ -0,0 +1,61 @@
+/**
+ * SHA-256 for Bitcoin Headers
+ *
+ * Plain-C SHA-256 with the pieces header hashing needs exposed: the raw
+ * compression function and the state after the first 64-byte block
+ * (midstate). An 80-byte header spans two blocks; everything that varies
+ * per nonce (ntime, nbits, nonce) lives in the second, so the first block is
+ * compressed once per header and reused for every nonce.
+ */
+
+#ifndef BTC_SHA256_H
+#define BTC_SHA256_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BTC_HEADER_SIZE 80
+
+/**
+ * @brief Load the SHA-256 initial hash value
+ */
+void btc_sha256_init_state(uint32_t state[8]);
+
+/**
+ * @brief Compress one 64-byte block into state
+ */
+void btc_sha256_compress(uint32_t state[8], const uint8_t block[64]);
+
+/**
+ * @brief Single SHA-256 of a buffer
+ */
+void btc_sha256(const uint8_t *data, size_t len, uint8_t out[32]);
+
+/**
+ * @brief Double SHA-256 (Bitcoin's hash) of a buffer
+ */
+void btc_sha256d(const uint8_t *data, size_t len, uint8_t out[32]);
+
+/**
+ * @brief State after compressing the first 64 bytes of a header
+ */
+void btc_sha256_midstate(const uint8_t header[BTC_HEADER_SIZE], uint32_t midstate[8]);
+
+/**
+ * @brief Double SHA-256 of an 80-byte header, starting from its midstate
+ *
+ * @param midstate From btc_sha256_midstate() for the same first 64 bytes
+ * @param tail Header bytes 64..79 (merkle tail, ntime, nbits, nonce)
+ * @param out Header hash, in the byte order SHA-256 produces
+ */
+void btc_sha256d_header(const uint32_t midstate[8], const uint8_t tail[16], uint8_t out[32]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BTC_SHA256_H
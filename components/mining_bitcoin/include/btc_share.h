@@ -0,0 +1,145 @@
+/**
+ * Bitcoin Share Filter
+ *
+ * Decides locally which nonces are worth sending to the pool. Only hashes
+ * meeting the pool target (mining.set_difficulty) are submitted, so the
+ * uplink carries a few shares a minute no matter how low the difficulty a
+ * pool would accept. Along the way the filter keeps the best difficulty
+ * reached this session and ever - for lottery mining, the number users
+ * watch.
+ *
+ * Every hash first meets a one-compare precheck on its top 32 bits
+ * (leading zeros). Only the rare hash that passes is converted to a
+ * difficulty and compared against the full 256-bit targets.
+ *
+ * Difficulty changes follow stratum: mining.set_difficulty takes effect
+ * with the next job, so shares for jobs already being hashed are still
+ * judged by the difficulty they were issued under.
+ *
+ * Pure C; persisting the all-time best is left to the caller (btc_best.h).
+ * Not thread-safe - one filter per hashing worker or behind the caller's
+ * lock.
+ */
+
+#ifndef BTC_SHARE_H
+#define BTC_SHARE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "btc_work.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Hashes with fewer leading zero bits never reach the slow path. Sixteen
+// bits (difficulty ~1.5e-5) is one hash in 65536 - invisible in hashrate,
+// and any session long enough to matter has a best far above it.
+#define BTC_BEST_MIN_ZERO_BITS 16
+
+typedef enum {
+    BTC_SHARE_NONE = 0,                 // Below the pool target
+    BTC_SHARE_SUBMIT,                   // Meets the pool target
+    BTC_SHARE_BLOCK,                    // Meets the network target too
+} btc_share_verdict_t;
+
+// A nonce to submit (mining.submit fields plus its difficulty)
+typedef struct {
+    char job_id[BTC_JOB_ID_MAX];
+    uint8_t extranonce2[BTC_EXTRANONCE_MAX];
+    uint8_t extranonce2_size;
+    uint32_t ntime;
+    uint32_t nonce;
+    uint32_t version;                   // Full rolled version
+    double difficulty;                  // Achieved, not the pool's
+    bool block;
+} btc_share_t;
+
+typedef struct {
+    uint64_t hashes;                    // Scanned by btc_share_scan()
+    uint64_t prechecked;                // Passed the leading-zero precheck
+    uint32_t shares;                    // Met the pool target
+    uint32_t blocks;                    // Met the network target
+    double share_difficulty;            // Sum of pool difficulty over shares (expected work)
+} btc_share_stats_t;
+
+typedef struct {
+    // Active targets (for the current job)
+    double pool_difficulty;
+    uint8_t pool_target[32];
+    uint8_t network_target[32];
+    uint32_t precheck_top;              // Largest top word worth a closer look
+
+    double pending_difficulty;          // Applied at the next job, 0 = none
+
+    double session_best;
+    double alltime_best;
+    bool alltime_dirty;                 // New all-time best not yet persisted
+
+    btc_share_stats_t stats;
+} btc_share_filter_t;
+
+/**
+ * @brief Initialize a filter
+ *
+ * @param alltime_best Persisted all-time best difficulty (0 if none)
+ */
+void btc_share_filter_init(btc_share_filter_t *filter, double alltime_best);
+
+/**
+ * @brief Start a new pool session (resets the session best, keeps stats)
+ */
+void btc_share_new_session(btc_share_filter_t *filter);
+
+/**
+ * @brief Record mining.set_difficulty; takes effect at the next job
+ *
+ * The first difficulty of a filter takes effect immediately.
+ */
+void btc_share_set_difficulty(btc_share_filter_t *filter, double difficulty);
+
+/**
+ * @brief Switch to a new job: applies a pending difficulty and its nbits
+ */
+void btc_share_set_job(btc_share_filter_t *filter, uint32_t nbits);
+
+/**
+ * @brief Judge one header hash (from btc_sha256d_header())
+ *
+ * Updates the best difficulties and counters.
+ *
+ * @param difficulty Achieved difficulty if the hash passed the precheck,
+ *                   otherwise left untouched (may be NULL)
+ */
+btc_share_verdict_t btc_share_check(btc_share_filter_t *filter, const uint8_t hash[32],
+                                    double *difficulty);
+
+/**
+ * @brief Hash a range of nonces for one work item and collect shares
+ *
+ * Stops early once shares is full so none is lost; resume from
+ * nonce + *scanned.
+ *
+ * @param nonce First nonce
+ * @param count Nonces to try
+ * @param shares Output array for shares meeting the pool target
+ * @param max_shares Capacity of shares
+ * @param scanned Nonces actually tried (may be NULL)
+ * @return Number of shares written
+ */
+uint32_t btc_share_scan(btc_share_filter_t *filter, const btc_work_t *work, uint32_t nonce,
+                        uint32_t count, btc_share_t *shares, uint32_t max_shares,
+                        uint32_t *scanned);
+
+/**
+ * @brief Fetch a new all-time best once, for persisting
+ *
+ * @return true (and the best) if it improved since the last call
+ */
+bool btc_share_take_alltime_best(btc_share_filter_t *filter, double *best);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BTC_SHARE_H
@@ -0,0 +1,67 @@
+/**
+ * Bitcoin Targets and Difficulty
+ *
+ * Conversions between pool difficulty (mining.set_difficulty), compact
+ * network targets (nbits) and 256-bit targets, plus the difficulty a
+ * header hash achieved.
+ *
+ * Targets and hashes are 32 bytes in the order SHA-256 produces them and
+ * are read as little-endian numbers, so the leading zeros of a good hash
+ * sit at the end of the array. Difficulty 1 is the pool convention
+ * 0xFFFF * 2^208 (bdiff), shared by all stratum pools.
+ */
+
+#ifndef BTC_TARGET_H
+#define BTC_TARGET_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 256-bit target for a pool difficulty
+ *
+ * Difficulties too small to represent give the all-ones target; precision
+ * is that of a double (top 53 bits), as in every stratum miner.
+ */
+void btc_target_from_difficulty(double difficulty, uint8_t target[32]);
+
+/**
+ * @brief 256-bit target from a compact nbits value
+ *
+ * Negative or overflowing encodings give the all-zero target.
+ */
+void btc_target_from_nbits(uint32_t nbits, uint8_t target[32]);
+
+/**
+ * @brief Does a hash meet a target (hash <= target)?
+ */
+bool btc_target_met(const uint8_t hash[32], const uint8_t target[32]);
+
+/**
+ * @brief Difficulty a hash (or target) corresponds to
+ *
+ * @return Difficulty 1 target divided by the hash; INFINITY for a zero hash
+ */
+double btc_target_difficulty(const uint8_t hash[32]);
+
+/**
+ * @brief Top 32 bits of a hash or target (bytes 28..31)
+ *
+ * A hash whose top word is above the target's cannot meet it; this single
+ * compare rejects all but about one hash in 2^32 at difficulty 1 or more.
+ */
+static inline uint32_t btc_target_top_word(const uint8_t hash[32])
+{
+    return (uint32_t)hash[28] | (uint32_t)hash[29] << 8 |
+           (uint32_t)hash[30] << 16 | (uint32_t)hash[31] << 24;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BTC_TARGET_H
@@ -0,0 +1,147 @@
+/**
+ * Bitcoin Work Generator
+ *
+ * Turns one stratum job (mining.notify) into a stream of distinct block
+ * headers so hashing workers never wait for the next notify. Three fields
+ * are rolled, cheapest first:
+ *
+ *   1. ntime     - second header block only, so the midstate is reused.
+ *                  Kept within the notified ntime plus time elapsed since
+ *                  the notify plus a small allowed drift.
+ *   2. version   - first block only (one compression for a new midstate).
+ *                  Only bits in the mask negotiated via mining.configure
+ *                  version-rolling (BIP310/BIP320) are touched.
+ *   3. extranonce2 - changes the coinbase, so the merkle root and midstate
+ *                  are rebuilt. Limited to the pool-assigned size.
+ *
+ * The generator is not thread-safe; one task (the stratum client or a work
+ * feeder) owns it and hands finished work to the workers.
+ *
+ * Byte order: prevhash and merkle branches are given in header byte order
+ * (stratum sends prevhash as eight byte-swapped 32-bit words - swap before
+ * calling). Integer fields are host values and are written little-endian.
+ */
+
+#ifndef BTC_WORK_H
+#define BTC_WORK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "btc_sha256.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BTC_JOB_ID_MAX 32
+#define BTC_COINB_MAX 256               // Per coinbase half
+#define BTC_MERKLE_MAX 16               // Branches (up to 65536 transactions)
+#define BTC_EXTRANONCE_MAX 8
+#define BTC_NTIME_DRIFT_DEFAULT 60      // Seconds ahead of the job's clock
+
+// A stratum job (mining.notify), decoded to binary
+typedef struct {
+    char job_id[BTC_JOB_ID_MAX];
+    uint8_t prevhash[32];               // Header byte order
+    uint8_t coinb1[BTC_COINB_MAX];
+    uint16_t coinb1_len;
+    uint8_t coinb2[BTC_COINB_MAX];
+    uint16_t coinb2_len;
+    uint8_t merkle_branch[BTC_MERKLE_MAX][32];
+    uint8_t merkle_count;
+    uint32_t version;
+    uint32_t nbits;
+    uint32_t ntime;
+    bool clean_jobs;
+} btc_job_t;
+
+// Per-connection parameters from mining.subscribe / mining.configure
+typedef struct {
+    uint8_t extranonce1[BTC_EXTRANONCE_MAX];
+    uint8_t extranonce1_len;
+    uint8_t extranonce2_size;           // Bytes, 1..BTC_EXTRANONCE_MAX
+    uint32_t version_mask;              // 0 = version rolling not negotiated
+    uint32_t ntime_drift_s;             // Allowed ntime lead, 0 = default
+} btc_session_t;
+
+// One unit of work: a header ready for the nonce loop
+typedef struct {
+    char job_id[BTC_JOB_ID_MAX];
+    uint8_t header[BTC_HEADER_SIZE];    // Nonce field zero
+    uint32_t midstate[8];               // SHA-256 state after header[0..63]
+    uint8_t extranonce2[BTC_EXTRANONCE_MAX];
+    uint8_t extranonce2_size;
+    uint32_t ntime;
+    uint32_t version;                   // Full rolled version (submit version & mask)
+} btc_work_t;
+
+// Generator counters
+typedef struct {
+    uint32_t headers;                   // Work items produced
+    uint32_t ntime_rolls;
+    uint32_t version_rolls;
+    uint32_t extranonce2_rolls;
+    uint32_t midstates;                 // First-block compressions
+    uint32_t merkle_builds;             // Coinbase + merkle root rebuilds
+    uint32_t exhausted;                 // next() calls with no work left
+} btc_work_stats_t;
+
+// Generator state
+typedef struct {
+    btc_session_t session;
+    btc_job_t job;
+    bool has_job;
+    uint32_t job_received_s;            // Caller clock when the job arrived
+
+    uint64_t extranonce2;
+    uint64_t extranonce2_limit;         // Values available in extranonce2_size bytes
+    uint32_t version_roll;              // Counter spread over the mask bits
+    uint32_t version_roll_limit;
+    uint32_t ntime_next;
+
+    uint8_t header[BTC_HEADER_SIZE];    // Current header (nonce zero)
+    uint32_t midstate[8];
+    bool fresh;                         // Header not handed out yet
+
+    btc_work_stats_t stats;
+} btc_work_gen_t;
+
+/**
+ * @brief Initialize a generator for a pool session
+ *
+ * @return false if the session parameters are out of range
+ */
+bool btc_work_gen_init(btc_work_gen_t *gen, const btc_session_t *session);
+
+/**
+ * @brief Switch to a new job
+ *
+ * Restarts extranonce2, version and ntime rolling.
+ *
+ * @param now_s Caller clock in seconds (any monotonic epoch)
+ * @return false if the job does not fit the limits above
+ */
+bool btc_work_gen_set_job(btc_work_gen_t *gen, const btc_job_t *job, uint32_t now_s);
+
+/**
+ * @brief Produce the next distinct header
+ *
+ * @param now_s Same clock as btc_work_gen_set_job()
+ * @return false if there is no job or every rollable value is used up
+ */
+bool btc_work_gen_next(btc_work_gen_t *gen, btc_work_t *work, uint32_t now_s);
+
+/**
+ * @brief Compute the merkle root for one extranonce2 value
+ *
+ * @param root Output, header byte order
+ */
+void btc_work_merkle_root(const btc_job_t *job, const btc_session_t *session,
+                          const uint8_t *extranonce2, uint8_t root[32]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BTC_WORK_H
@@ -0,0 +1,115 @@
+/**
+ * Fixed-Block Pool Allocator Implementation
+ */
+
+#include "block_pool.h"
+#include "esp_log.h"
+#include <string.h>
+
+static const char *TAG = "POOL";
+
+static block_pool_t *registry[BLOCK_POOL_MAX_POOLS];
+static size_t registry_count = 0;
+static portMUX_TYPE registry_lock = portMUX_INITIALIZER_UNLOCKED;
+
+esp_err_t block_pool_init(block_pool_t *pool, const char *name, void *storage,
+                          uint32_t block_size, uint16_t block_count)
+{
+    if (!pool || !storage || block_size == 0 || block_count == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(pool, 0, sizeof(*pool));
+    pool->storage = (uint8_t *)storage;
+    pool->stride = (block_size + BLOCK_POOL_ALIGN - 1) & ~(uint32_t)(BLOCK_POOL_ALIGN - 1);
+    pool->stats.name = name;
+    pool->stats.block_size = block_size;
+    pool->stats.block_count = block_count;
+    portMUX_INITIALIZE(&pool->lock);
+
+    // Thread every block onto the free list, lowest address first
+    for (int i = block_count - 1; i >= 0; i--) {
+        void **block = (void **)(pool->storage + (size_t)i * pool->stride);
+        *block = pool->free_list;
+        pool->free_list = block;
+    }
+
+    portENTER_CRITICAL(&registry_lock);
+    bool registered = false;
+    for (size_t i = 0; i < registry_count; i++) {
+        if (registry[i] == pool) {
+            registered = true;
+        }
+    }
+    if (!registered && registry_count < BLOCK_POOL_MAX_POOLS) {
+        registry[registry_count++] = pool;
+        registered = true;
+    }
+    portEXIT_CRITICAL(&registry_lock);
+
+    if (!registered) {
+        ESP_LOGW(TAG, "Pool registry full - '%s' will not appear in reports", name);
+    }
+    ESP_LOGI(TAG, "Pool '%s': %u x %lu bytes", name, block_count, (unsigned long)block_size);
+    return ESP_OK;
+}
+
+void *block_pool_alloc(block_pool_t *pool)
+{
+    portENTER_CRITICAL(&pool->lock);
+    void **block = (void **)pool->free_list;
+    if (block) {
+        pool->free_list = *block;
+        pool->stats.in_use++;
+        pool->stats.alloc_count++;
+        if (pool->stats.in_use > pool->stats.peak_in_use) {
+            pool->stats.peak_in_use = pool->stats.in_use;
+        }
+    } else {
+        pool->stats.fail_count++;
+    }
+    portEXIT_CRITICAL(&pool->lock);
+    return block;
+}
+
+void block_pool_free(block_pool_t *pool, void *block)
+{
+    if (!block) {
+        return;
+    }
+
+    uint8_t *p = (uint8_t *)block;
+    size_t offset = p - pool->storage;
+    if (p < pool->storage || offset >= (size_t)pool->stride * pool->stats.block_count ||
+        offset % pool->stride != 0) {
+        ESP_LOGE(TAG, "Pool '%s': foreign block %p", pool->stats.name, block);
+        return;
+    }
+
+    portENTER_CRITICAL(&pool->lock);
+    *(void **)block = pool->free_list;
+    pool->free_list = block;
+    pool->stats.in_use--;
+    portEXIT_CRITICAL(&pool->lock);
+}
+
+void block_pool_get_stats(block_pool_t *pool, block_pool_stats_t *stats)
+{
+    portENTER_CRITICAL(&pool->lock);
+    *stats = pool->stats;
+    portEXIT_CRITICAL(&pool->lock);
+}
+
+size_t block_pool_get_all_stats(block_pool_stats_t *stats, size_t max)
+{
+    portENTER_CRITICAL(&registry_lock);
+    size_t count = registry_count < max ? registry_count : max;
+    block_pool_t *pools[BLOCK_POOL_MAX_POOLS];
+    memcpy(pools, registry, count * sizeof(pools[0]));
+    portEXIT_CRITICAL(&registry_lock);
+
+    for (size_t i = 0; i < count; i++) {
+        block_pool_get_stats(pools[i], &stats[i]);
+    }
+    return count;
+}
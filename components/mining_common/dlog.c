@@ -0,0 +1,270 @@
+/**
+ * Deferred Binary Logging Implementation
+ *
+ * The ring is a bounded multi-producer/single-consumer queue: every slot
+ * carries a sequence number, producers claim a slot with one compare-and-
+ * swap on the head and publish it by advancing the slot's sequence, and the
+ * formatter consumes in order. No locks, no allocation, and a full ring
+ * costs the producer one failed check.
+ */
+
+#include "dlog.h"
+#include "mem_budget.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+
+static const char *TAG = "DLOG";
+
+#define DLOG_TASK_STACK_SIZE 3072
+#define DLOG_TASK_PRIORITY 4            // Above the core 0 hashing worker so logs drain
+#define DLOG_IDLE_MS 20
+#define DLOG_LINE_MAX 192
+
+typedef struct {
+    atomic_uint_fast32_t seq;
+    const dlog_site_t *site;
+    const char *tag;
+    int64_t timestamp_us;
+    uint8_t nargs;
+    uint8_t float_mask;
+    uint32_t args[DLOG_MAX_ARGS];
+} dlog_event_t;
+
+static dlog_event_t ring[DLOG_RING_SIZE];
+static atomic_uint_fast32_t head;       // Next slot producers claim
+static uint32_t tail;                   // Next slot the formatter reads
+
+static atomic_int min_level = ESP_LOG_VERBOSE;
+static atomic_uint_fast32_t recorded;
+static atomic_uint_fast32_t dropped;
+static uint32_t emitted;
+static uint32_t high_water;
+static TaskHandle_t formatter_task = NULL;
+
+void dlog_record(const dlog_site_t *site, const char *tag, unsigned nargs, unsigned float_mask, ...)
+{
+    if ((int)site->level > atomic_load_explicit(&min_level, memory_order_relaxed)) {
+        return;
+    }
+
+    uint32_t pos = (uint32_t)atomic_load_explicit(&head, memory_order_relaxed);
+    dlog_event_t *ev;
+    for (;;) {
+        ev = &ring[pos & (DLOG_RING_SIZE - 1)];
+        uint32_t seq = (uint32_t)atomic_load_explicit(&ev->seq, memory_order_acquire);
+        int32_t diff = (int32_t)(seq - pos);
+        if (diff == 0) {
+            uint_fast32_t expected = pos;
+            if (atomic_compare_exchange_weak_explicit(&head, &expected, pos + 1,
+                                                      memory_order_relaxed,
+                                                      memory_order_relaxed)) {
+                break;
+            }
+            pos = (uint32_t)expected;
+        } else if (diff < 0) {
+            // Formatter has not freed this slot yet - ring is full
+            atomic_fetch_add_explicit(&dropped, 1, memory_order_relaxed);
+            return;
+        } else {
+            pos = (uint32_t)atomic_load_explicit(&head, memory_order_relaxed);
+        }
+    }
+
+    ev->site = site;
+    ev->tag = tag;
+    ev->timestamp_us = esp_timer_get_time();
+    ev->nargs = nargs > DLOG_MAX_ARGS ? DLOG_MAX_ARGS : nargs;
+    ev->float_mask = float_mask;
+
+    va_list ap;
+    va_start(ap, float_mask);
+    for (unsigned i = 0; i < ev->nargs; i++) {
+        ev->args[i] = va_arg(ap, uint32_t);
+    }
+    va_end(ap);
+
+    atomic_store_explicit(&ev->seq, pos + 1, memory_order_release);
+    atomic_fetch_add_explicit(&recorded, 1, memory_order_relaxed);
+}
+
+/**
+ * @brief Expand a format string with stored 32-bit arguments
+ *
+ * Length modifiers in the original format are dropped; integers are
+ * re-widened according to the conversion (signed for d/i, unsigned
+ * otherwise) and floats are passed as double.
+ */
+static void dlog_format(const dlog_event_t *ev, char *out, size_t out_len)
+{
+    const char *f = ev->site->fmt;
+    size_t n = 0;
+    unsigned arg = 0;
+
+    while (*f && n + 1 < out_len) {
+        if (*f != '%') {
+            out[n++] = *f++;
+            continue;
+        }
+        if (f[1] == '%') {
+            out[n++] = '%';
+            f += 2;
+            continue;
+        }
+
+        // Copy flags, width and precision; skip length modifiers
+        char spec[24];
+        size_t s = 0;
+        spec[s++] = *f++;
+        while (*f && strchr("-+ #0123456789.", *f) && s < sizeof(spec) - 4) {
+            spec[s++] = *f++;
+        }
+        while (*f && strchr("hlLqjzt", *f)) {
+            f++;
+        }
+        char conv = *f ? *f++ : 'd';
+
+        uint32_t word = arg < ev->nargs ? ev->args[arg] : 0;
+        bool is_float = arg < ev->nargs && (ev->float_mask >> arg) & 1;
+        arg++;
+
+        int written;
+        if (strchr("fFeEgGaA", conv)) {
+            union { uint32_t u; float f; } x = { .u = word };
+            double v = is_float ? x.f : (double)(int32_t)word;
+            spec[s++] = conv;
+            spec[s] = '\0';
+            written = snprintf(out + n, out_len - n, spec, v);
+        } else {
+            long long v = conv == 'd' || conv == 'i' ? (long long)(int32_t)word : (long long)word;
+            if (is_float) {
+                union { uint32_t u; float f; } x = { .u = word };
+                v = (long long)x.f;
+            }
+            if (conv == 'c') {
+                spec[s++] = 'c';
+                spec[s] = '\0';
+                written = snprintf(out + n, out_len - n, spec, (int)v);
+            } else {
+                if (!strchr("diuxXo", conv)) {
+                    conv = 'u';             // %s, %p and friends are not supported
+                }
+                spec[s++] = 'l';
+                spec[s++] = 'l';
+                spec[s++] = conv;
+                spec[s] = '\0';
+                written = snprintf(out + n, out_len - n, spec, v);
+            }
+        }
+        if (written < 0) {
+            break;
+        }
+        n += (size_t)written < out_len - n ? (size_t)written : out_len - n - 1;
+    }
+    out[n] = '\0';
+}
+
+static char level_letter(esp_log_level_t level)
+{
+    switch (level) {
+        case ESP_LOG_ERROR: return 'E';
+        case ESP_LOG_WARN: return 'W';
+        case ESP_LOG_INFO: return 'I';
+        case ESP_LOG_DEBUG: return 'D';
+        default: return 'V';
+    }
+}
+
+/**
+ * @brief Formatter task - drains the ring and writes log lines
+ */
+static void dlog_task(void *param)
+{
+    static char line[DLOG_LINE_MAX];
+    uint32_t reported_drops = 0;
+
+    while (1) {
+        uint32_t drops = (uint32_t)atomic_load_explicit(&dropped, memory_order_relaxed);
+        if (drops != reported_drops) {
+            ESP_LOGW(TAG, "%lu event(s) dropped - ring full", (unsigned long)(drops - reported_drops));
+            reported_drops = drops;
+        }
+
+        uint32_t queued = (uint32_t)atomic_load_explicit(&head, memory_order_relaxed) - tail;
+        if (queued > high_water) {
+            high_water = queued;
+        }
+
+        dlog_event_t *ev = &ring[tail & (DLOG_RING_SIZE - 1)];
+        uint32_t seq = (uint32_t)atomic_load_explicit(&ev->seq, memory_order_acquire);
+        if (seq != tail + 1) {
+            // Empty, or the next producer is still writing its slot
+            vTaskDelay(pdMS_TO_TICKS(DLOG_IDLE_MS));
+            continue;
+        }
+
+        dlog_event_t event = *ev;
+        atomic_store_explicit(&ev->seq, tail + DLOG_RING_SIZE, memory_order_release);
+        tail++;
+
+        dlog_format(&event, line, sizeof(line));
+        // Same shape as ESP_LOGx, stamped with the time the event happened
+        esp_log_write(event.site->level, event.tag, "%c (%lu) %s: %s\n",
+                      level_letter(event.site->level),
+                      (unsigned long)(event.timestamp_us / 1000), event.tag, line);
+        emitted++;
+    }
+}
+
+esp_err_t dlog_init(void)
+{
+    if (formatter_task != NULL) {
+        return ESP_OK;
+    }
+
+    for (uint32_t i = 0; i < DLOG_RING_SIZE; i++) {
+        atomic_init(&ring[i].seq, i);
+    }
+    atomic_init(&head, 0);
+    tail = 0;
+
+    BaseType_t ret = xTaskCreatePinnedToCore(
+        dlog_task,
+        "dlog",
+        DLOG_TASK_STACK_SIZE,
+        NULL,
+        DLOG_TASK_PRIORITY,
+        &formatter_task,
+        0      // Core 0, away from the primary hashing core
+    );
+
+    if (ret != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create formatter task");
+        formatter_task = NULL;
+        return ESP_FAIL;
+    }
+    mem_budget_register_task(formatter_task, DLOG_TASK_STACK_SIZE);
+    return ESP_OK;
+}
+
+void dlog_set_level(esp_log_level_t level)
+{
+    atomic_store_explicit(&min_level, (int)level, memory_order_relaxed);
+}
+
+esp_log_level_t dlog_get_level(void)
+{
+    return (esp_log_level_t)atomic_load_explicit(&min_level, memory_order_relaxed);
+}
+
+void dlog_get_stats(dlog_stats_t *stats)
+{
+    stats->recorded = (uint32_t)atomic_load_explicit(&recorded, memory_order_relaxed);
+    stats->dropped = (uint32_t)atomic_load_explicit(&dropped, memory_order_relaxed);
+    stats->emitted = emitted;
+    stats->high_water = high_water;
+}
@@ -0,0 +1,64 @@
+/**
+ * Time-Budgeted Hashing Slices Implementation
+ */
+
+#include "hash_slice.h"
+#include <string.h>
+
+#define RATE_ALPHA 0.25f                // Weight of each new time-per-hash sample
+#define SLICE_ALPHA 0.1f                // Weight of each new slice length in the average
+
+static void size_batch(hash_slice_t *slice)
+{
+    if (slice->ns_per_hash <= 0.0f) {
+        slice->batch = HASH_SLICE_MIN_BATCH;
+        return;
+    }
+
+    float batch = slice->target_us * 1000.0f / slice->ns_per_hash;
+    if (batch < HASH_SLICE_MIN_BATCH) {
+        slice->batch = HASH_SLICE_MIN_BATCH;
+    } else if (batch > HASH_SLICE_MAX_BATCH) {
+        slice->batch = HASH_SLICE_MAX_BATCH;
+    } else {
+        slice->batch = (uint32_t)batch;
+    }
+}
+
+void hash_slice_init(hash_slice_t *slice, uint32_t target_us)
+{
+    memset(slice, 0, sizeof(*slice));
+    slice->target_us = target_us;
+    size_batch(slice);
+}
+
+void hash_slice_set_target(hash_slice_t *slice, uint32_t target_us)
+{
+    if (target_us != slice->target_us) {
+        slice->target_us = target_us;
+        size_batch(slice);
+    }
+}
+
+uint32_t hash_slice_record(hash_slice_t *slice, uint32_t hashes, uint32_t elapsed_us)
+{
+    slice->slices++;
+    slice->last_us = elapsed_us;
+    slice->avg_us = slice->slices == 1 ? elapsed_us
+                                       : slice->avg_us + SLICE_ALPHA * (elapsed_us - slice->avg_us);
+    if (elapsed_us > slice->max_us) {
+        slice->max_us = elapsed_us;
+    }
+    if (elapsed_us > 2 * slice->target_us) {
+        slice->overruns++;
+    }
+
+    if (hashes > 0) {
+        float sample = elapsed_us * 1000.0f / hashes;
+        slice->ns_per_hash = slice->ns_per_hash <= 0.0f
+                             ? sample
+                             : slice->ns_per_hash + RATE_ALPHA * (sample - slice->ns_per_hash);
+    }
+    size_batch(slice);
+    return slice->batch;
+}
@@ -0,0 +1,97 @@
+/**
+ * Fixed-Block Pool Allocator
+ *
+ * Hands out equal-sized blocks from statically reserved storage, so network
+ * and HTTP buffers that are taken and returned thousands of times a day
+ * never touch (or fragment) the heap. Allocation and release are O(1) and
+ * safe from any task on either core.
+ *
+ * Pools register themselves by name so the memory budget report can show
+ * their usage next to the heap figures.
+ */
+
+#ifndef BLOCK_POOL_H
+#define BLOCK_POOL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BLOCK_POOL_MAX_POOLS 8
+#define BLOCK_POOL_ALIGN 8
+
+// Reserve aligned storage for a pool: BLOCK_POOL_STORAGE(rx_storage, 512, 4);
+#define BLOCK_POOL_STORAGE(name, block_size, block_count) \
+    static uint8_t name[(((block_size) + BLOCK_POOL_ALIGN - 1) & ~(BLOCK_POOL_ALIGN - 1)) * (block_count)] \
+        __attribute__((aligned(BLOCK_POOL_ALIGN)))
+
+// Usage counters
+typedef struct {
+    const char *name;
+    uint32_t block_size;
+    uint16_t block_count;
+    uint16_t in_use;
+    uint16_t peak_in_use;           // High-water mark since init
+    uint32_t alloc_count;
+    uint32_t fail_count;            // Requests refused because the pool was empty
+} block_pool_stats_t;
+
+// Pool state
+typedef struct {
+    uint8_t *storage;
+    void *free_list;                // Singly linked through the free blocks
+    uint32_t stride;                // Block size rounded up to BLOCK_POOL_ALIGN
+    block_pool_stats_t stats;
+    portMUX_TYPE lock;
+} block_pool_t;
+
+/**
+ * @brief Initialize a pool over caller-provided storage and register it
+ *
+ * @param pool Pool to initialize (must outlive all users)
+ * @param name Name shown in reports (must be a static string)
+ * @param storage Storage declared with BLOCK_POOL_STORAGE()
+ * @param block_size Usable bytes per block
+ * @param block_count Number of blocks
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG on bad parameters
+ */
+esp_err_t block_pool_init(block_pool_t *pool, const char *name, void *storage,
+                          uint32_t block_size, uint16_t block_count);
+
+/**
+ * @brief Take a block
+ *
+ * @return Block of at least block_size bytes, or NULL if the pool is empty
+ */
+void *block_pool_alloc(block_pool_t *pool);
+
+/**
+ * @brief Return a block (NULL is ignored)
+ */
+void block_pool_free(block_pool_t *pool, void *block);
+
+/**
+ * @brief Get a pool's usage counters
+ */
+void block_pool_get_stats(block_pool_t *pool, block_pool_stats_t *stats);
+
+/**
+ * @brief Get the usage counters of every registered pool
+ *
+ * @param stats Output array
+ * @param max Capacity of stats
+ * @return Number of entries written
+ */
+size_t block_pool_get_all_stats(block_pool_stats_t *stats, size_t max);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BLOCK_POOL_H
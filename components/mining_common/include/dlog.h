@@ -0,0 +1,134 @@
+/**
+ * Deferred Binary Logging
+ *
+ * Hot-path code records a compact binary event - call site, tag, timestamp
+ * and up to DLOG_MAX_ARGS 32-bit integer/float arguments - into a lock-free
+ * ring in a few dozen cycles. A formatter task on core 0 turns events into
+ * normal ESP-IDF log lines later, so printf formatting and UART stalls never
+ * land on the mining path. When the ring overflows, events are dropped and
+ * counted; the formatter reports each run of drops.
+ *
+ * Levels work like ESP_LOGx:
+ * - compile time: call sites above LOG_LOCAL_LEVEL compile to nothing
+ * - run time: events below dlog_set_level() are not recorded at all, and
+ *   esp_log_level_set() per tag still applies when lines are emitted
+ *
+ * Usage mirrors ESP_LOGx, with restrictions: at most 4 arguments, each an
+ * integer of up to 32 bits or a float/double (stored as float). Strings and
+ * pointers are not supported, since they may not outlive the event. The tag
+ * must point to storage that lives forever (the usual static TAG does).
+ *
+ *   DLOG_I(TAG, "[%u] Share found! Nonce: %lu, Hashrate: %.2f H/s", idx, nonce, rate);
+ */
+
+#ifndef DLOG_H
+#define DLOG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "esp_log.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DLOG_MAX_ARGS 4
+#define DLOG_RING_SIZE 128              // Events (power of two)
+
+// Static per-call-site descriptor
+typedef struct {
+    const char *fmt;
+    esp_log_level_t level;
+} dlog_site_t;
+
+// Counters
+typedef struct {
+    uint32_t recorded;
+    uint32_t emitted;
+    uint32_t dropped;                   // Ring full at record time
+    uint32_t high_water;                // Most events queued at once
+} dlog_stats_t;
+
+/**
+ * @brief Set up the ring and start the formatter task on core 0
+ *
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t dlog_init(void);
+
+/**
+ * @brief Runtime threshold: events less severe than level are not recorded
+ */
+void dlog_set_level(esp_log_level_t level);
+
+/**
+ * @brief Current runtime threshold
+ */
+esp_log_level_t dlog_get_level(void);
+
+/**
+ * @brief Get the ring counters
+ */
+void dlog_get_stats(dlog_stats_t *stats);
+
+/**
+ * @brief Record an event (use the DLOG_x macros instead)
+ *
+ * @param site Call site
+ * @param tag Log tag
+ * @param nargs Number of arguments that follow
+ * @param float_mask Bit i set if argument i is float bits
+ * @param ... nargs uint32_t argument words
+ */
+void dlog_record(const dlog_site_t *site, const char *tag, unsigned nargs, unsigned float_mask, ...);
+
+// Argument encoding: every argument becomes one 32-bit word
+static inline uint32_t dlog_int_bits(long long v) { return (uint32_t)v; }
+static inline uint32_t dlog_float_bits(double v)
+{
+    union { float f; uint32_t u; } x = { .f = (float)v };
+    return x.u;
+}
+
+#define DLOG_IS_FLOAT(x) _Generic((x), float: 1u, double: 1u, default: 0u)
+#define DLOG_BITS(x) _Generic((x), float: dlog_float_bits, double: dlog_float_bits, \
+                              default: dlog_int_bits)(x)
+
+#define DLOG_NARGS(...) DLOG_NARGS_(0, ##__VA_ARGS__, 4, 3, 2, 1, 0)
+#define DLOG_NARGS_(_0, _1, _2, _3, _4, n, ...) n
+#define DLOG_CAT(a, b) DLOG_CAT_(a, b)
+#define DLOG_CAT_(a, b) a##b
+
+#define DLOG_MASK_0() 0u
+#define DLOG_MASK_1(a) DLOG_IS_FLOAT(a)
+#define DLOG_MASK_2(a, b) (DLOG_MASK_1(a) | DLOG_IS_FLOAT(b) << 1)
+#define DLOG_MASK_3(a, b, c) (DLOG_MASK_2(a, b) | DLOG_IS_FLOAT(c) << 2)
+#define DLOG_MASK_4(a, b, c, d) (DLOG_MASK_3(a, b, c) | DLOG_IS_FLOAT(d) << 3)
+
+#define DLOG_WORDS_0()
+#define DLOG_WORDS_1(a) , DLOG_BITS(a)
+#define DLOG_WORDS_2(a, b) DLOG_WORDS_1(a), DLOG_BITS(b)
+#define DLOG_WORDS_3(a, b, c) DLOG_WORDS_2(a, b), DLOG_BITS(c)
+#define DLOG_WORDS_4(a, b, c, d) DLOG_WORDS_3(a, b, c), DLOG_BITS(d)
+
+#define DLOG_AT(lvl, tag, format, ...) do {                                             \
+        if (LOG_LOCAL_LEVEL >= (lvl)) {                                                 \
+            static const dlog_site_t _dlog_site = { .fmt = (format), .level = (lvl) };  \
+            dlog_record(&_dlog_site, (tag), DLOG_NARGS(__VA_ARGS__),                    \
+                        DLOG_CAT(DLOG_MASK_, DLOG_NARGS(__VA_ARGS__))(__VA_ARGS__)      \
+                        DLOG_CAT(DLOG_WORDS_, DLOG_NARGS(__VA_ARGS__))(__VA_ARGS__));   \
+        }                                                                               \
+    } while (0)
+
+#define DLOG_E(tag, format, ...) DLOG_AT(ESP_LOG_ERROR, tag, format, ##__VA_ARGS__)
+#define DLOG_W(tag, format, ...) DLOG_AT(ESP_LOG_WARN, tag, format, ##__VA_ARGS__)
+#define DLOG_I(tag, format, ...) DLOG_AT(ESP_LOG_INFO, tag, format, ##__VA_ARGS__)
+#define DLOG_D(tag, format, ...) DLOG_AT(ESP_LOG_DEBUG, tag, format, ##__VA_ARGS__)
+#define DLOG_V(tag, format, ...) DLOG_AT(ESP_LOG_VERBOSE, tag, format, ##__VA_ARGS__)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DLOG_H
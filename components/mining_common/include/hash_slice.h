@@ -0,0 +1,66 @@
+/**
+ * Time-Budgeted Hashing Slices
+ *
+ * Sizes hashing batches so each one takes a target wall time instead of a
+ * fixed number of hashes. Workers check for stop requests, stale jobs and
+ * feed the task watchdog only between batches, so bounding batch time
+ * bounds their response time on any core speed or kernel.
+ *
+ * The rate estimate is an EWMA of measured time per hash; a batch that was
+ * slowed by preemption inflates it briefly and the next batch is shorter.
+ * Pure C with no ESP-IDF dependencies.
+ */
+
+#ifndef HASH_SLICE_H
+#define HASH_SLICE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define HASH_SLICE_MIN_BATCH 64         // Also the first batch, before any measurement
+#define HASH_SLICE_MAX_BATCH (1u << 20)
+
+// Slice sizing state and metrics (owned by one worker)
+typedef struct {
+    uint32_t target_us;                 // Wall time per batch to aim for
+    float ns_per_hash;                  // EWMA, 0 until the first batch
+    uint32_t batch;                     // Hashes in the next batch
+
+    // Metrics
+    uint32_t slices;
+    uint32_t last_us;
+    float avg_us;                       // EWMA of achieved slice length
+    uint32_t max_us;                    // Longest slice since init
+    uint32_t overruns;                  // Slices longer than twice the target
+} hash_slice_t;
+
+/**
+ * @brief Initialize slice sizing
+ *
+ * @param target_us Wall time per batch
+ */
+void hash_slice_init(hash_slice_t *slice, uint32_t target_us);
+
+/**
+ * @brief Change the target (keeps the rate estimate)
+ */
+void hash_slice_set_target(hash_slice_t *slice, uint32_t target_us);
+
+/**
+ * @brief Record a finished batch and size the next one
+ *
+ * @param hashes Hashes computed in the batch
+ * @param elapsed_us Wall time the batch took
+ * @return Hashes for the next batch
+ */
+uint32_t hash_slice_record(hash_slice_t *slice, uint32_t hashes, uint32_t elapsed_us);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HASH_SLICE_H
@@ -0,0 +1,117 @@
+/**
+ * Memory Budget
+ *
+ * Tracks where RAM goes on a long-running board:
+ * - per-task stack high-water marks against the configured stack size,
+ *   so stacks can be shrunk from measurements instead of guesses
+ * - internal SRAM and PSRAM heap: free, all-time minimum and largest free
+ *   block, sampled periodically into a history ring so fragmentation
+ *   trends show up over weeks of uptime
+ * - block pool usage (see block_pool.h)
+ *
+ * Tasks are registered when created and unregistered before they delete
+ * themselves; the last measured high-water mark is kept after exit.
+ */
+
+#ifndef MEM_BUDGET_H
+#define MEM_BUDGET_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MEM_BUDGET_MAX_TASKS 12
+#define MEM_BUDGET_HISTORY 60           // Heap samples kept (1 h at the default interval)
+
+// Stack usage of one task
+typedef struct {
+    char name[16];
+    uint32_t stack_size;                // Configured stack, bytes
+    uint32_t stack_free_min;            // Least free stack ever seen, bytes
+    bool running;                       // False once the task has exited
+} mem_task_usage_t;
+
+// One heap sample
+typedef struct {
+    uint32_t uptime_s;
+    uint32_t internal_free;
+    uint32_t internal_largest;          // Largest free block
+    uint32_t psram_free;
+    uint32_t psram_largest;
+} mem_heap_sample_t;
+
+// Current budget
+typedef struct {
+    mem_heap_sample_t heap;             // Latest sample
+    uint32_t internal_total;
+    uint32_t internal_min_free;         // All-time minimum since boot
+    uint32_t internal_largest_min;      // Smallest largest-block seen since boot
+    uint32_t psram_total;               // 0 if no PSRAM
+    uint32_t psram_min_free;
+    uint8_t task_count;
+    mem_task_usage_t tasks[MEM_BUDGET_MAX_TASKS];
+    uint32_t samples;
+} mem_budget_snapshot_t;
+
+/**
+ * @brief Start periodic sampling
+ *
+ * Interval comes from MEM_BUDGET_INTERVAL_SEC in config.h.
+ *
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t mem_budget_init(void);
+
+/**
+ * @brief Track a task's stack usage
+ *
+ * @param task Task handle (NULL = calling task)
+ * @param stack_size Stack size the task was created with, bytes
+ */
+void mem_budget_register_task(TaskHandle_t task, uint32_t stack_size);
+
+/**
+ * @brief Stop tracking a task, keeping its final high-water mark
+ *
+ * Must be called before the task is deleted.
+ *
+ * @param task Task handle (NULL = calling task)
+ */
+void mem_budget_unregister_task(TaskHandle_t task);
+
+/**
+ * @brief Take a sample now (also runs on the periodic timer)
+ */
+void mem_budget_sample(void);
+
+/**
+ * @brief Get the current budget
+ */
+esp_err_t mem_budget_get(mem_budget_snapshot_t *snapshot);
+
+/**
+ * @brief Copy heap history, oldest first
+ *
+ * @param samples Output array
+ * @param max Capacity of samples
+ * @return Number of samples written
+ */
+size_t mem_budget_get_history(mem_heap_sample_t *samples, size_t max);
+
+/**
+ * @brief Log the full budget (tasks, heaps, pools)
+ */
+void mem_budget_log(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MEM_BUDGET_H
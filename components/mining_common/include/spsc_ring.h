@@ -0,0 +1,120 @@
+/**
+ * Lock-Free Single-Producer/Single-Consumer Ring
+ *
+ * Fixed-capacity ring of fixed-size slots for handing work between exactly
+ * one producer task and one consumer task. The caller supplies the slot
+ * storage, so nothing is allocated; push and pop are wait-free and take no
+ * locks. Head and tail live on separate cache lines so the two cores do not
+ * bounce a shared line on every operation.
+ *
+ * No ESP-IDF dependencies (C11 atomics only).
+ */
+
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdatomic.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Data cache line size (ESP32-S3 default; host CPUs use 64)
+#ifndef SPSC_CACHE_LINE
+#if defined(__x86_64__) || defined(__aarch64__)
+#define SPSC_CACHE_LINE 64
+#else
+#define SPSC_CACHE_LINE 32
+#endif
+#endif
+
+// Ring state
+typedef struct {
+    // Written by the producer only
+    _Alignas(SPSC_CACHE_LINE) atomic_uint_fast32_t head;
+    uint32_t cached_tail;           // Producer's last view of tail
+
+    // Written by the consumer only
+    _Alignas(SPSC_CACHE_LINE) atomic_uint_fast32_t tail;
+    uint32_t cached_head;           // Consumer's last view of head
+
+    // Read-only after init
+    _Alignas(SPSC_CACHE_LINE) uint8_t *slots;
+    uint32_t slot_size;
+    uint32_t mask;                  // capacity - 1
+} spsc_ring_t;
+
+/**
+ * @brief Initialize a ring over caller-provided storage
+ *
+ * @param ring Ring to initialize
+ * @param storage capacity * slot_size bytes, must outlive the ring
+ * @param slot_size Size of one element
+ * @param capacity Number of slots (power of two)
+ * @return true on success, false if capacity is not a power of two
+ */
+bool spsc_ring_init(spsc_ring_t *ring, void *storage, uint32_t slot_size, uint32_t capacity);
+
+/**
+ * @brief Discard all queued elements
+ *
+ * Only safe while neither producer nor consumer is running.
+ */
+void spsc_ring_reset(spsc_ring_t *ring);
+
+/**
+ * @brief Number of queued elements (approximate while both sides run)
+ */
+uint32_t spsc_ring_count(spsc_ring_t *ring);
+
+/**
+ * @brief Producer: copy an element into the ring
+ *
+ * @return false if the ring is full
+ */
+static inline bool spsc_ring_push(spsc_ring_t *ring, const void *elem)
+{
+    uint32_t head = (uint32_t)atomic_load_explicit(&ring->head, memory_order_relaxed);
+
+    if (head - ring->cached_tail > ring->mask) {
+        ring->cached_tail = (uint32_t)atomic_load_explicit(&ring->tail, memory_order_acquire);
+        if (head - ring->cached_tail > ring->mask) {
+            return false;
+        }
+    }
+
+    memcpy(ring->slots + (size_t)(head & ring->mask) * ring->slot_size, elem, ring->slot_size);
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+    return true;
+}
+
+/**
+ * @brief Consumer: copy the oldest element out of the ring
+ *
+ * @return false if the ring is empty
+ */
+static inline bool spsc_ring_pop(spsc_ring_t *ring, void *elem)
+{
+    uint32_t tail = (uint32_t)atomic_load_explicit(&ring->tail, memory_order_relaxed);
+
+    if (tail == ring->cached_head) {
+        ring->cached_head = (uint32_t)atomic_load_explicit(&ring->head, memory_order_acquire);
+        if (tail == ring->cached_head) {
+            return false;
+        }
+    }
+
+    memcpy(elem, ring->slots + (size_t)(tail & ring->mask) * ring->slot_size, ring->slot_size);
+    atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+    return true;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SPSC_RING_H
@@ -0,0 +1,100 @@
+/**
+ * Thermal Control Loop
+ *
+ * Pure PI controller that turns on-die temperature readings into hashing
+ * limits (worker count, slice length, duty cycle). Has no ESP-IDF dependencies
+ * so it can be driven on the host from a simulated thermal model.
+ */
+
+#ifndef THERMAL_CONTROL_H
+#define THERMAL_CONTROL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Controller tuning and limits
+typedef struct {
+    float setpoint_c;       // Temperature to hold (just under the throttle point)
+    float shutdown_c;       // Hard limit - mining stops at or above this
+    float resume_c;         // Mining resumes after a shutdown once below this
+    float kp;               // Proportional gain (effort per degree C)
+    float ki;               // Integral gain (effort per degree C per second)
+    float filter_alpha;     // EWMA weight of each new sensor reading (0-1]
+    float min_effort;       // Lowest effort while not shut down (0-1)
+    uint8_t max_workers;    // Hashing workers available at full effort
+    uint32_t min_slice_us;  // Hashing time per batch at the lowest duty cycle
+    uint32_t max_slice_us;  // Hashing time per batch at 100% duty cycle
+    uint8_t fail_limit;     // Consecutive failed sensor reads before failing safe
+} thermal_control_params_t;
+
+// Hashing limits produced by the controller
+typedef struct {
+    uint8_t workers;        // Number of workers allowed to hash
+    uint32_t slice_us;      // Hashing time between pacing points
+    uint8_t duty_pct;       // Percentage of wall time each worker may hash
+    bool shutdown;          // True when above the hard limit
+} thermal_limits_t;
+
+// Controller state
+typedef struct {
+    thermal_control_params_t params;
+    float filtered_c;       // Smoothed temperature
+    float integral;         // Integrator term (0-1)
+    float effort;           // Last output effort (0-1)
+    bool shutdown;          // Latched until temperature drops below resume_c
+    bool primed;            // Filter has seen its first sample
+    uint8_t failed_reads;   // Consecutive failed sensor reads
+} thermal_control_t;
+
+/**
+ * @brief Initialize controller state
+ *
+ * Starts at full effort so an idle, cool chip hashes at full speed immediately.
+ *
+ * @param ctl Controller state to initialize
+ * @param params Tuning parameters (copied)
+ */
+void thermal_control_init(thermal_control_t *ctl, const thermal_control_params_t *params);
+
+/**
+ * @brief Advance the controller by one sample
+ *
+ * @param ctl Controller state
+ * @param temp_c Raw temperature reading in Celsius
+ * @param dt_sec Seconds since the previous sample
+ * @param out Limits to apply until the next sample
+ */
+void thermal_control_step(thermal_control_t *ctl, float temp_c, float dt_sec,
+                          thermal_limits_t *out);
+
+/**
+ * @brief Account for a sample whose sensor read failed
+ *
+ * Until fail_limit consecutive reads have failed the previous limits stay in
+ * force. From then on the controller fails safe: a latched shutdown holds,
+ * otherwise hashing drops to min_effort. The next good reading restarts the
+ * filter and lets the integrator climb back up from min_effort.
+ *
+ * @param ctl Controller state
+ * @param out Failsafe limits, written only when the function returns true
+ * @return true once the controller is running blind on failsafe limits
+ */
+bool thermal_control_sensor_failed(thermal_control_t *ctl, thermal_limits_t *out);
+
+/**
+ * @brief Limits for running unthrottled (no sensor or governor disabled)
+ *
+ * @param params Tuning parameters
+ * @param out Limits at full effort
+ */
+void thermal_control_full_limits(const thermal_control_params_t *params, thermal_limits_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // THERMAL_CONTROL_H
@@ -0,0 +1,101 @@
+/**
+ * Thermal Governor
+ *
+ * Samples the on-die temperature sensor and adjusts hashing limits to hold
+ * the chip just under TEMP_THROTTLE_THRESHOLD, stopping mining entirely at
+ * TEMP_SHUTDOWN_THRESHOLD. Hashing workers call thermal_governor_pace() at
+ * every batch boundary to apply the current limits.
+ */
+
+#ifndef THERMAL_GOVERNOR_H
+#define THERMAL_GOVERNOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "thermal_control.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Governor status (for stats/display)
+typedef struct {
+    bool sensor_ok;             // False if the sensor could not be read
+    float temperature_c;        // Last raw reading
+    float filtered_c;           // Smoothed reading used by the controller
+    float effort;               // Allowed fraction of full throughput (0-1)
+    thermal_limits_t limits;    // Limits currently in force
+    uint32_t throttled_seconds; // Time spent below full effort
+    uint32_t shutdown_count;    // Number of hard-limit trips
+} thermal_status_t;
+
+// Per-worker pacing state (owned by each hashing worker)
+typedef struct {
+    uint8_t worker_index;       // 0-based worker number
+    uint32_t sleep_debt_us;     // Off-time owed but shorter than one tick
+    uint32_t busy_us;           // Core 0: hashing since lower priorities last ran
+} thermal_pacer_t;
+
+/**
+ * @brief Initialize the thermal governor
+ *
+ * Installs the temperature sensor. If the sensor is unavailable the governor
+ * still works but always reports full-speed limits.
+ *
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t thermal_governor_init(void);
+
+/**
+ * @brief Start the governor sampling task
+ *
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t thermal_governor_start(void);
+
+/**
+ * @brief Stop the governor sampling task
+ *
+ * Limits are reset to full speed.
+ *
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t thermal_governor_stop(void);
+
+/**
+ * @brief Get the limits currently in force
+ *
+ * @param limits Pointer to limits structure to populate
+ */
+void thermal_governor_get_limits(thermal_limits_t *limits);
+
+/**
+ * @brief Get governor status
+ *
+ * @param status Pointer to status structure to populate
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t thermal_governor_get_status(thermal_status_t *status);
+
+/**
+ * @brief Apply limits at a hashing batch boundary
+ *
+ * Sleeps long enough to honour the duty cycle for the batch just completed.
+ * When the off-time is below one tick the worker yields; a worker on core 0
+ * also sleeps one tick every THERMAL_CORE0_YIELD_MS of hashing so
+ * lower-priority tasks there (app_main, IDLE0) still run.
+ *
+ * @param pacer Calling worker's pacing state
+ * @param batch_elapsed_us Time spent hashing the batch just completed
+ * @return Hashing time for the next batch in microseconds, or 0 if this worker
+ *         must pause (mining shut down or worker parked); call again later
+ *         with 0 elapsed
+ */
+uint32_t thermal_governor_pace(thermal_pacer_t *pacer, uint32_t batch_elapsed_us);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // THERMAL_GOVERNOR_H
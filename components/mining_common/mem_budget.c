@@ -0,0 +1,290 @@
+/**
+ * Memory Budget Implementation
+ */
+
+#include "mem_budget.h"
+#include "block_pool.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "freertos/semphr.h"
+#include <string.h>
+
+// Include user configuration
+#include "config.h"
+
+#ifndef MEM_BUDGET_INTERVAL_SEC
+#define MEM_BUDGET_INTERVAL_SEC 60
+#endif
+
+static const char *TAG = "MEM";
+
+#define MEM_BUDGET_STACK_WARN 512       // Warn when a task's headroom drops below this
+
+typedef struct {
+    TaskHandle_t handle;                // NULL once the task has exited
+    mem_task_usage_t usage;
+} tracked_task_t;
+
+static tracked_task_t tasks[MEM_BUDGET_MAX_TASKS];
+static uint8_t task_count = 0;
+
+static mem_budget_snapshot_t budget;
+static mem_heap_sample_t history[MEM_BUDGET_HISTORY];
+static uint16_t history_pos = 0;
+static uint16_t history_fill = 0;
+
+static portMUX_TYPE budget_lock = portMUX_INITIALIZER_UNLOCKED;
+static esp_timer_handle_t sample_timer = NULL;
+
+// Stack scans walk task memory, far too long for budget_lock. This mutex is
+// held across a scan instead; unregistering waits on it, so a handle being
+// scanned cannot belong to a task that has already been deleted.
+static SemaphoreHandle_t scan_mutex = NULL;
+
+static void scan_begin(void)
+{
+    if (scan_mutex != NULL) {
+        xSemaphoreTake(scan_mutex, portMAX_DELAY);
+    }
+}
+
+static void scan_end(void)
+{
+    if (scan_mutex != NULL) {
+        xSemaphoreGive(scan_mutex);
+    }
+}
+
+/**
+ * @brief Fold a high-water mark into a slot if it still tracks the same task (budget_lock held)
+ */
+static void publish_stack(tracked_task_t *t, TaskHandle_t handle, uint32_t free_min)
+{
+    if (t->handle == handle && free_min < t->usage.stack_free_min) {
+        t->usage.stack_free_min = free_min;
+    }
+}
+
+static void sample_timer_cb(void *arg)
+{
+    mem_budget_sample();
+}
+
+esp_err_t mem_budget_init(void)
+{
+    if (sample_timer != NULL) {
+        return ESP_OK;
+    }
+
+    if (scan_mutex == NULL) {
+        scan_mutex = xSemaphoreCreateMutex();
+        if (scan_mutex == NULL) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    budget.internal_total = heap_caps_get_total_size(MALLOC_CAP_INTERNAL);
+    budget.psram_total = heap_caps_get_total_size(MALLOC_CAP_SPIRAM);
+    budget.internal_largest_min = UINT32_MAX;
+    mem_budget_sample();
+
+    esp_timer_create_args_t timer_args = {
+        .callback = sample_timer_cb,
+        .name = "mem_budget",
+    };
+    esp_err_t ret = esp_timer_create(&timer_args, &sample_timer);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create timer: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    ret = esp_timer_start_periodic(sample_timer, (uint64_t)MEM_BUDGET_INTERVAL_SEC * 1000000);
+    if (ret != ESP_OK) {
+        esp_timer_delete(sample_timer);
+        sample_timer = NULL;
+        return ret;
+    }
+
+    ESP_LOGI(TAG, "Internal heap: %lu / %lu bytes free, PSRAM: %lu / %lu bytes free",
+             (unsigned long)budget.heap.internal_free, (unsigned long)budget.internal_total,
+             (unsigned long)budget.heap.psram_free, (unsigned long)budget.psram_total);
+    return ESP_OK;
+}
+
+void mem_budget_register_task(TaskHandle_t task, uint32_t stack_size)
+{
+    if (task == NULL) {
+        task = xTaskGetCurrentTaskHandle();
+    }
+    const char *name = pcTaskGetName(task);
+
+    portENTER_CRITICAL(&budget_lock);
+    // A restarted task reuses its old slot so history is not lost
+    tracked_task_t *slot = NULL;
+    for (uint8_t i = 0; i < task_count; i++) {
+        if (strncmp(tasks[i].usage.name, name, sizeof(tasks[i].usage.name)) == 0) {
+            slot = &tasks[i];
+            break;
+        }
+    }
+    if (slot == NULL && task_count < MEM_BUDGET_MAX_TASKS) {
+        slot = &tasks[task_count++];
+        memset(slot, 0, sizeof(*slot));
+        strncpy(slot->usage.name, name, sizeof(slot->usage.name) - 1);
+        slot->usage.stack_free_min = UINT32_MAX;
+    }
+    if (slot) {
+        slot->handle = task;
+        slot->usage.stack_size = stack_size;
+        slot->usage.running = true;
+    }
+    portEXIT_CRITICAL(&budget_lock);
+
+    if (slot == NULL) {
+        ESP_LOGW(TAG, "Task table full - not tracking '%s'", name);
+    }
+}
+
+void mem_budget_unregister_task(TaskHandle_t task)
+{
+    if (task == NULL) {
+        task = xTaskGetCurrentTaskHandle();
+    }
+
+    // The task is still alive here - take its final high-water mark unlocked
+    scan_begin();
+    uint32_t free_min = uxTaskGetStackHighWaterMark(task);
+
+    portENTER_CRITICAL(&budget_lock);
+    for (uint8_t i = 0; i < task_count; i++) {
+        if (tasks[i].handle == task) {
+            publish_stack(&tasks[i], task, free_min);
+            tasks[i].handle = NULL;
+            tasks[i].usage.running = false;
+        }
+    }
+    portEXIT_CRITICAL(&budget_lock);
+    scan_end();
+}
+
+void mem_budget_sample(void)
+{
+    mem_heap_sample_t sample = {
+        .uptime_s = (uint32_t)(esp_timer_get_time() / 1000000),
+        .internal_free = heap_caps_get_free_size(MALLOC_CAP_INTERNAL),
+        .internal_largest = heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL),
+        .psram_free = heap_caps_get_free_size(MALLOC_CAP_SPIRAM),
+        .psram_largest = heap_caps_get_largest_free_block(MALLOC_CAP_SPIRAM),
+    };
+    uint32_t internal_min = heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL);
+    uint32_t psram_min = heap_caps_get_minimum_free_size(MALLOC_CAP_SPIRAM);
+
+    // Copy the handles out, scan the stacks unlocked, publish under the lock
+    TaskHandle_t handles[MEM_BUDGET_MAX_TASKS];
+    uint32_t free_min[MEM_BUDGET_MAX_TASKS];
+    scan_begin();
+    portENTER_CRITICAL(&budget_lock);
+    uint8_t count = task_count;
+    for (uint8_t i = 0; i < count; i++) {
+        handles[i] = tasks[i].handle;
+    }
+    portEXIT_CRITICAL(&budget_lock);
+
+    for (uint8_t i = 0; i < count; i++) {
+        // ESP-IDF reports the high-water mark in bytes
+        free_min[i] = handles[i] != NULL ? uxTaskGetStackHighWaterMark(handles[i]) : UINT32_MAX;
+    }
+
+    portENTER_CRITICAL(&budget_lock);
+    for (uint8_t i = 0; i < count; i++) {
+        if (handles[i] != NULL) {
+            publish_stack(&tasks[i], handles[i], free_min[i]);
+        }
+    }
+
+    budget.heap = sample;
+    budget.internal_min_free = internal_min;
+    budget.psram_min_free = psram_min;
+    if (sample.internal_largest < budget.internal_largest_min) {
+        budget.internal_largest_min = sample.internal_largest;
+    }
+    budget.samples++;
+
+    history[history_pos] = sample;
+    history_pos = (history_pos + 1) % MEM_BUDGET_HISTORY;
+    if (history_fill < MEM_BUDGET_HISTORY) {
+        history_fill++;
+    }
+    portEXIT_CRITICAL(&budget_lock);
+    scan_end();
+}
+
+esp_err_t mem_budget_get(mem_budget_snapshot_t *snapshot)
+{
+    if (!snapshot) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    portENTER_CRITICAL(&budget_lock);
+    *snapshot = budget;
+    snapshot->task_count = task_count;
+    for (uint8_t i = 0; i < task_count; i++) {
+        snapshot->tasks[i] = tasks[i].usage;
+    }
+    portEXIT_CRITICAL(&budget_lock);
+    return ESP_OK;
+}
+
+size_t mem_budget_get_history(mem_heap_sample_t *samples, size_t max)
+{
+    portENTER_CRITICAL(&budget_lock);
+    size_t count = history_fill < max ? history_fill : max;
+    size_t start = (history_pos + MEM_BUDGET_HISTORY - count) % MEM_BUDGET_HISTORY;
+    for (size_t i = 0; i < count; i++) {
+        samples[i] = history[(start + i) % MEM_BUDGET_HISTORY];
+    }
+    portEXIT_CRITICAL(&budget_lock);
+    return count;
+}
+
+void mem_budget_log(void)
+{
+    static mem_budget_snapshot_t snap;  // Keep the caller's stack small
+    mem_budget_get(&snap);
+
+    ESP_LOGI(TAG, "Internal: %lu free (min %lu), largest block %lu (min %lu) of %lu",
+             (unsigned long)snap.heap.internal_free, (unsigned long)snap.internal_min_free,
+             (unsigned long)snap.heap.internal_largest, (unsigned long)snap.internal_largest_min,
+             (unsigned long)snap.internal_total);
+    if (snap.psram_total > 0) {
+        ESP_LOGI(TAG, "PSRAM: %lu free (min %lu), largest block %lu of %lu",
+                 (unsigned long)snap.heap.psram_free, (unsigned long)snap.psram_min_free,
+                 (unsigned long)snap.heap.psram_largest, (unsigned long)snap.psram_total);
+    }
+
+    for (uint8_t i = 0; i < snap.task_count; i++) {
+        const mem_task_usage_t *t = &snap.tasks[i];
+        if (t->stack_free_min == UINT32_MAX) {
+            continue;
+        }
+        uint32_t used = t->stack_size > t->stack_free_min ? t->stack_size - t->stack_free_min : 0;
+        if (t->stack_free_min < MEM_BUDGET_STACK_WARN) {
+            ESP_LOGW(TAG, "Stack %-15s %5lu / %5lu bytes used - only %lu left",
+                     t->name, (unsigned long)used, (unsigned long)t->stack_size,
+                     (unsigned long)t->stack_free_min);
+        } else {
+            ESP_LOGI(TAG, "Stack %-15s %5lu / %5lu bytes used%s",
+                     t->name, (unsigned long)used, (unsigned long)t->stack_size,
+                     t->running ? "" : " (exited)");
+        }
+    }
+
+    block_pool_stats_t pools[BLOCK_POOL_MAX_POOLS];
+    size_t pool_count = block_pool_get_all_stats(pools, BLOCK_POOL_MAX_POOLS);
+    for (size_t i = 0; i < pool_count; i++) {
+        ESP_LOGI(TAG, "Pool %-16s %u/%u in use (peak %u), %lu allocs, %lu failures",
+                 pools[i].name, pools[i].in_use, pools[i].block_count, pools[i].peak_in_use,
+                 (unsigned long)pools[i].alloc_count, (unsigned long)pools[i].fail_count);
+    }
+}
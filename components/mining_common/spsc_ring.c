@@ -0,0 +1,35 @@
+/**
+ * Lock-Free SPSC Ring Implementation
+ */
+
+#include "spsc_ring.h"
+
+bool spsc_ring_init(spsc_ring_t *ring, void *storage, uint32_t slot_size, uint32_t capacity)
+{
+    if (!ring || !storage || slot_size == 0 || capacity == 0 ||
+        (capacity & (capacity - 1)) != 0) {
+        return false;
+    }
+
+    ring->slots = (uint8_t *)storage;
+    ring->slot_size = slot_size;
+    ring->mask = capacity - 1;
+    spsc_ring_reset(ring);
+    return true;
+}
+
+void spsc_ring_reset(spsc_ring_t *ring)
+{
+    atomic_store_explicit(&ring->head, 0, memory_order_relaxed);
+    atomic_store_explicit(&ring->tail, 0, memory_order_relaxed);
+    ring->cached_head = 0;
+    ring->cached_tail = 0;
+    atomic_thread_fence(memory_order_seq_cst);
+}
+
+uint32_t spsc_ring_count(spsc_ring_t *ring)
+{
+    uint32_t head = (uint32_t)atomic_load_explicit(&ring->head, memory_order_acquire);
+    uint32_t tail = (uint32_t)atomic_load_explicit(&ring->tail, memory_order_acquire);
+    return head - tail;
+}
@@ -0,0 +1,133 @@
+/**
+ * Thermal Control Loop Implementation
+ *
+ * The controller output is a single "effort" value (0-1) meaning the fraction
+ * of full hashing throughput allowed. Effort is spread over as few workers as
+ * possible, each running at the highest duty cycle, since parking a worker
+ * sheds more heat than duty-cycling all of them.
+ */
+
+#include "thermal_control.h"
+#include <string.h>
+
+static float clampf(float v, float lo, float hi)
+{
+    if (v < lo) return lo;
+    if (v > hi) return hi;
+    return v;
+}
+
+/**
+ * @brief Convert an effort value into concrete worker/slice/duty limits
+ */
+static void effort_to_limits(const thermal_control_params_t *p, float effort,
+                             thermal_limits_t *out)
+{
+    uint8_t max_workers = p->max_workers > 0 ? p->max_workers : 1;
+    float capacity = effort * max_workers;
+
+    uint8_t workers = (uint8_t)capacity;
+    if ((float)workers < capacity) workers++;
+    if (workers < 1) workers = 1;
+    if (workers > max_workers) workers = max_workers;
+
+    float duty = clampf(capacity / workers, 0.01f, 1.0f);
+
+    out->workers = workers;
+    out->duty_pct = (uint8_t)(duty * 100.0f + 0.5f);
+    if (out->duty_pct < 1) out->duty_pct = 1;
+    // Shorter slices at low duty keep on/off periods short and heat output smooth
+    out->slice_us = p->min_slice_us + (uint32_t)((p->max_slice_us - p->min_slice_us) * duty);
+    out->shutdown = false;
+}
+
+static void shutdown_limits(const thermal_control_params_t *p, thermal_limits_t *out)
+{
+    out->workers = 0;
+    out->slice_us = p->min_slice_us;
+    out->duty_pct = 0;
+    out->shutdown = true;
+}
+
+void thermal_control_init(thermal_control_t *ctl, const thermal_control_params_t *params)
+{
+    memset(ctl, 0, sizeof(*ctl));
+    ctl->params = *params;
+    if (ctl->params.max_slice_us < ctl->params.min_slice_us) {
+        ctl->params.max_slice_us = ctl->params.min_slice_us;
+    }
+    ctl->integral = 1.0f;
+    ctl->effort = 1.0f;
+}
+
+void thermal_control_full_limits(const thermal_control_params_t *params, thermal_limits_t *out)
+{
+    effort_to_limits(params, 1.0f, out);
+}
+
+void thermal_control_step(thermal_control_t *ctl, float temp_c, float dt_sec,
+                          thermal_limits_t *out)
+{
+    const thermal_control_params_t *p = &ctl->params;
+
+    // After an outage the filtered value is stale - start again from this reading
+    if (ctl->failed_reads > 0 && ctl->failed_reads >= p->fail_limit) {
+        ctl->primed = false;
+    }
+    ctl->failed_reads = 0;
+
+    if (!ctl->primed) {
+        ctl->filtered_c = temp_c;
+        ctl->primed = true;
+    } else {
+        ctl->filtered_c += p->filter_alpha * (temp_c - ctl->filtered_c);
+    }
+
+    // Hard limit uses the raw reading so a fast spike still trips it
+    if (temp_c >= p->shutdown_c) {
+        ctl->shutdown = true;
+    } else if (ctl->shutdown && ctl->filtered_c < p->resume_c) {
+        // Restart gently and let the integrator climb back up
+        ctl->shutdown = false;
+        ctl->integral = p->min_effort;
+    }
+
+    if (ctl->shutdown) {
+        ctl->effort = 0.0f;
+        shutdown_limits(p, out);
+        return;
+    }
+
+    // Positive error = thermal headroom
+    float error = p->setpoint_c - ctl->filtered_c;
+
+    // Clamping the integrator to the output range prevents wind-up while
+    // the chip is cold and the controller is saturated at full effort
+    ctl->integral = clampf(ctl->integral + p->ki * error * dt_sec, p->min_effort, 1.0f);
+    ctl->effort = clampf(p->kp * error + ctl->integral, p->min_effort, 1.0f);
+
+    effort_to_limits(p, ctl->effort, out);
+}
+
+bool thermal_control_sensor_failed(thermal_control_t *ctl, thermal_limits_t *out)
+{
+    const thermal_control_params_t *p = &ctl->params;
+
+    if (ctl->failed_reads < UINT8_MAX) {
+        ctl->failed_reads++;
+    }
+    if (ctl->failed_reads < p->fail_limit) {
+        return false;
+    }
+
+    // Blind: never more than minimum effort, and recover from there
+    ctl->integral = p->min_effort;
+    if (ctl->shutdown) {
+        ctl->effort = 0.0f;
+        shutdown_limits(p, out);
+    } else {
+        ctl->effort = p->min_effort;
+        effort_to_limits(p, ctl->effort, out);
+    }
+    return true;
+}
@@ -0,0 +1,309 @@
+/**
+ * Thermal Governor Implementation
+ */
+
+#include "thermal_governor.h"
+#include "mem_budget.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "driver/temperature_sensor.h"
+#include <string.h>
+
+// Include user configuration
+#include "config.h"
+
+static const char *TAG = "THERMAL";
+
+#ifndef TEMP_THROTTLE_THRESHOLD
+#define TEMP_THROTTLE_THRESHOLD 80
+#endif
+#ifndef TEMP_SHUTDOWN_THRESHOLD
+#define TEMP_SHUTDOWN_THRESHOLD 90
+#endif
+#ifndef TEMP_CONTROL_MARGIN
+#define TEMP_CONTROL_MARGIN 2
+#endif
+#ifndef HASH_SLICE_TARGET_MS
+#define HASH_SLICE_TARGET_MS 5
+#endif
+#ifndef THERMAL_CORE0_YIELD_MS
+#define THERMAL_CORE0_YIELD_MS 100
+#endif
+#ifndef THERMAL_SENSOR_FAIL_LIMIT
+#define THERMAL_SENSOR_FAIL_LIMIT 3
+#endif
+
+#define GOVERNOR_SAMPLE_MS 1000
+#define GOVERNOR_STACK_SIZE 3072
+#define GOVERNOR_MAX_WORKERS 2      // One hashing worker per core
+#define GOVERNOR_MIN_SLICE_US 1000  // Slice at the lowest duty cycle
+
+static temperature_sensor_handle_t sensor = NULL;
+static TaskHandle_t governor_task_handle = NULL;
+static bool stop_requested = false;
+
+static thermal_control_t controller;
+static thermal_status_t status = {0};
+static portMUX_TYPE status_lock = portMUX_INITIALIZER_UNLOCKED;
+
+/**
+ * @brief Publish new limits to hashing workers
+ *
+ * @param sensor_ok False while running blind on failsafe limits (raw_c unused)
+ */
+static void publish(bool sensor_ok, float raw_c, const thermal_limits_t *limits)
+{
+    portENTER_CRITICAL(&status_lock);
+    status.sensor_ok = sensor_ok;
+    if (sensor_ok) {
+        status.temperature_c = raw_c;
+        status.filtered_c = controller.filtered_c;
+    }
+    status.effort = controller.effort;
+    if (limits->shutdown && !status.limits.shutdown) {
+        status.shutdown_count++;
+    }
+    status.limits = *limits;
+    portEXIT_CRITICAL(&status_lock);
+}
+
+/**
+ * @brief Governor task - samples the sensor and runs the control loop
+ */
+static void thermal_governor_task(void *param)
+{
+    ESP_LOGI(TAG, "Governor task started (setpoint %.1f C, shutdown %.1f C)",
+             controller.params.setpoint_c, controller.params.shutdown_c);
+
+    int64_t last_sample = esp_timer_get_time();
+    bool was_shutdown = false;
+    bool blind = false;
+
+    while (!stop_requested) {
+        vTaskDelay(pdMS_TO_TICKS(GOVERNOR_SAMPLE_MS));
+
+        int64_t now = esp_timer_get_time();
+        float dt_sec = (now - last_sample) / 1000000.0f;
+        last_sample = now;
+
+        float temp_c;
+        thermal_limits_t limits;
+        if (temperature_sensor_get_celsius(sensor, &temp_c) != ESP_OK) {
+            if (!thermal_control_sensor_failed(&controller, &limits)) {
+                ESP_LOGW(TAG, "Failed to read temperature sensor");
+                continue;
+            }
+            // Running blind - never hash harder than minimum effort
+            if (!blind) {
+                ESP_LOGE(TAG, "Temperature sensor failed %u times in a row - %s",
+                         controller.failed_reads,
+                         limits.shutdown ? "staying shut down" : "hashing at minimum effort");
+                blind = true;
+            }
+            publish(false, 0.0f, &limits);
+            continue;
+        }
+
+        thermal_control_step(&controller, temp_c, dt_sec, &limits);
+        publish(true, temp_c, &limits);
+        if (blind) {
+            ESP_LOGW(TAG, "Temperature sensor recovered at %.1f C", temp_c);
+            blind = false;
+        }
+
+        if (controller.effort < 1.0f) {
+            portENTER_CRITICAL(&status_lock);
+            status.throttled_seconds += GOVERNOR_SAMPLE_MS / 1000;
+            portEXIT_CRITICAL(&status_lock);
+        }
+
+        if (limits.shutdown != was_shutdown) {
+            if (limits.shutdown) {
+                ESP_LOGE(TAG, "%.1f C reached hard limit - mining stopped", temp_c);
+            } else {
+                ESP_LOGW(TAG, "Cooled to %.1f C - mining resumed", controller.filtered_c);
+            }
+            was_shutdown = limits.shutdown;
+        }
+
+        ESP_LOGD(TAG, "%.1f C (filtered %.1f) effort %.2f -> %u workers, %u%% duty, slice %lu us",
+                 temp_c, controller.filtered_c, controller.effort, limits.workers,
+                 limits.duty_pct, (unsigned long)limits.slice_us);
+    }
+
+    ESP_LOGI(TAG, "Governor task stopped");
+    mem_budget_unregister_task(NULL);
+    governor_task_handle = NULL;
+    vTaskDelete(NULL);
+}
+
+esp_err_t thermal_governor_init(void)
+{
+    ESP_LOGI(TAG, "Initializing thermal governor...");
+
+    thermal_control_params_t params = {
+        .setpoint_c = TEMP_THROTTLE_THRESHOLD - TEMP_CONTROL_MARGIN,
+        .shutdown_c = TEMP_SHUTDOWN_THRESHOLD,
+        .resume_c = TEMP_THROTTLE_THRESHOLD - TEMP_CONTROL_MARGIN,
+        .kp = 0.10f,
+        .ki = 0.02f,
+        .filter_alpha = 0.3f,
+        .min_effort = 0.10f,
+        .max_workers = GOVERNOR_MAX_WORKERS,
+        .min_slice_us = GOVERNOR_MIN_SLICE_US,
+        .max_slice_us = HASH_SLICE_TARGET_MS * 1000,
+        .fail_limit = THERMAL_SENSOR_FAIL_LIMIT,
+    };
+    thermal_control_init(&controller, &params);
+
+    memset(&status, 0, sizeof(status));
+    thermal_control_full_limits(&params, &status.limits);
+    status.effort = 1.0f;
+
+    if (sensor == NULL) {
+        temperature_sensor_config_t sensor_config = TEMPERATURE_SENSOR_CONFIG_DEFAULT(20, 100);
+        esp_err_t ret = temperature_sensor_install(&sensor_config, &sensor);
+        if (ret == ESP_OK) {
+            ret = temperature_sensor_enable(sensor);
+        }
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Temperature sensor unavailable: %s - running unthrottled",
+                     esp_err_to_name(ret));
+            sensor = NULL;
+            return ret;
+        }
+    }
+
+    status.sensor_ok = true;
+    ESP_LOGI(TAG, "Thermal governor initialized");
+    return ESP_OK;
+}
+
+esp_err_t thermal_governor_start(void)
+{
+    if (governor_task_handle != NULL) {
+        ESP_LOGW(TAG, "Governor already running");
+        return ESP_OK;
+    }
+
+    if (sensor == NULL) {
+        ESP_LOGE(TAG, "Temperature sensor not initialized");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    stop_requested = false;
+
+    // Core 0, low priority - must never compete with hashing on core 1
+    BaseType_t ret = xTaskCreatePinnedToCore(
+        thermal_governor_task,
+        "thermal_gov",
+        GOVERNOR_STACK_SIZE,
+        NULL,
+        3,     // Priority
+        &governor_task_handle,
+        0      // Core 0
+    );
+
+    if (ret != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create governor task");
+        return ESP_FAIL;
+    }
+    mem_budget_register_task(governor_task_handle, GOVERNOR_STACK_SIZE);
+
+    return ESP_OK;
+}
+
+esp_err_t thermal_governor_stop(void)
+{
+    if (governor_task_handle == NULL) {
+        return ESP_OK;
+    }
+
+    stop_requested = true;
+
+    int timeout = 30;
+    while (governor_task_handle != NULL && timeout > 0) {
+        vTaskDelay(pdMS_TO_TICKS(100));
+        timeout--;
+    }
+
+    if (governor_task_handle != NULL) {
+        ESP_LOGW(TAG, "Force deleting governor task");
+        mem_budget_unregister_task(governor_task_handle);
+        vTaskDelete(governor_task_handle);
+        governor_task_handle = NULL;
+    }
+
+    // Never leave workers throttled by a governor that is no longer running
+    thermal_limits_t limits;
+    thermal_control_full_limits(&controller.params, &limits);
+    portENTER_CRITICAL(&status_lock);
+    status.limits = limits;
+    status.effort = 1.0f;
+    portEXIT_CRITICAL(&status_lock);
+
+    return ESP_OK;
+}
+
+void thermal_governor_get_limits(thermal_limits_t *limits)
+{
+    portENTER_CRITICAL(&status_lock);
+    *limits = status.limits;
+    portEXIT_CRITICAL(&status_lock);
+}
+
+esp_err_t thermal_governor_get_status(thermal_status_t *out_status)
+{
+    if (!out_status) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    portENTER_CRITICAL(&status_lock);
+    memcpy(out_status, &status, sizeof(thermal_status_t));
+    portEXIT_CRITICAL(&status_lock);
+    return ESP_OK;
+}
+
+uint32_t thermal_governor_pace(thermal_pacer_t *pacer, uint32_t batch_elapsed_us)
+{
+    thermal_limits_t limits;
+    thermal_governor_get_limits(&limits);
+
+    if (limits.shutdown || pacer->worker_index >= limits.workers) {
+        pacer->sleep_debt_us = 0;
+        pacer->busy_us = 0;
+        return 0;
+    }
+
+    pacer->busy_us += batch_elapsed_us;
+
+    if (limits.duty_pct < 100 && limits.duty_pct > 0) {
+        // Off-time so that on / (on + off) == duty
+        pacer->sleep_debt_us += (uint32_t)((uint64_t)batch_elapsed_us *
+                                           (100 - limits.duty_pct) / limits.duty_pct);
+        uint32_t tick_us = portTICK_PERIOD_MS * 1000;
+        if (pacer->sleep_debt_us >= tick_us) {
+            TickType_t ticks = pacer->sleep_debt_us / tick_us;
+            pacer->sleep_debt_us -= ticks * tick_us;
+            pacer->busy_us = 0;
+            vTaskDelay(ticks);
+            return limits.slice_us;
+        }
+    } else {
+        pacer->sleep_debt_us = 0;
+    }
+
+    // A yield only reaches equal priorities; on core 0 a worker outranks
+    // app_main and IDLE0, so now and then give up a tick or they (and the
+    // IDLE watchdog) starve. Not every slice: a 5 ms slice against a 10 ms
+    // tick would halve the worker's hashrate.
+    if (xPortGetCoreID() == 0 && pacer->busy_us >= THERMAL_CORE0_YIELD_MS * 1000) {
+        pacer->busy_us = 0;
+        vTaskDelay(1);
+    } else {
+        taskYIELD();
+    }
+    return limits.slice_us;
+}
@@ -0,0 +1,166 @@
+/**
+ * DUCO-S1 Replay Corpus Recorder Implementation
+ *
+ * The corpus lives in the storage partition directly after the stats
+ * journal. Records are appended as text; the end of the corpus is the first
+ * erased (0xFF) byte. The region is never wrapped - once full, recording
+ * stops, which keeps the corpus a stable workload. Erase the region with
+ * esptool to start a new corpus.
+ */
+
+#include "duco_corpus.h"
+#include "duco_sha1_mb.h"
+#include "stats_journal.h"
+#include "esp_log.h"
+#include "esp_partition.h"
+#include <string.h>
+#include <stdio.h>
+
+// Include user configuration
+#include "config.h"
+
+#ifndef DUCO_CORPUS_RECORD
+#define DUCO_CORPUS_RECORD 0
+#endif
+
+static const char *TAG = "CORPUS";
+
+#define CORPUS_PARTITION "storage"
+#define CORPUS_OFFSET 0x20000               // After the 128 KB stats journal
+#define CORPUS_SIZE 0x40000                 // 256 KB, roughly 2500 records
+#define CORPUS_SECTOR_SIZE 4096
+#define CORPUS_SCAN_CHUNK 256
+#define CORPUS_MAGIC "# duco-corpus v1\n"
+
+static const esp_partition_t *partition = NULL;
+static uint32_t write_offset = 0;           // Relative to CORPUS_OFFSET
+static bool recording = false;
+static uint32_t records = 0;
+
+/**
+ * @brief Append raw bytes at the end of the corpus
+ */
+static esp_err_t corpus_append(const char *data, size_t len)
+{
+    if (write_offset + len > CORPUS_SIZE) {
+        ESP_LOGW(TAG, "Corpus region full after %lu records - recording stopped",
+                 (unsigned long)records);
+        recording = false;
+        return ESP_ERR_NO_MEM;
+    }
+
+    esp_err_t ret = esp_partition_write(partition, CORPUS_OFFSET + write_offset, data, len);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Write failed: %s", esp_err_to_name(ret));
+        recording = false;
+        return ret;
+    }
+    write_offset += len;
+    return ESP_OK;
+}
+
+/**
+ * @brief Find the first erased byte of the region
+ *
+ * @return Offset of the end of the corpus, or UINT32_MAX if the region does
+ *         not hold a corpus
+ */
+static uint32_t corpus_find_end(void)
+{
+    char chunk[CORPUS_SCAN_CHUNK];
+
+    if (esp_partition_read(partition, CORPUS_OFFSET, chunk, sizeof(CORPUS_MAGIC) - 1) != ESP_OK) {
+        return UINT32_MAX;
+    }
+    if ((uint8_t)chunk[0] == 0xFF) {
+        return 0;                           // Blank region
+    }
+    if (memcmp(chunk, CORPUS_MAGIC, sizeof(CORPUS_MAGIC) - 1) != 0) {
+        return UINT32_MAX;                  // Something else lives here
+    }
+
+    for (uint32_t offset = 0; offset < CORPUS_SIZE; offset += CORPUS_SCAN_CHUNK) {
+        if (esp_partition_read(partition, CORPUS_OFFSET + offset, chunk, sizeof(chunk)) != ESP_OK) {
+            return UINT32_MAX;
+        }
+        for (uint32_t i = 0; i < sizeof(chunk); i++) {
+            if ((uint8_t)chunk[i] == 0xFF) {
+                return offset + i;
+            }
+        }
+    }
+    return CORPUS_SIZE;
+}
+
+bool duco_corpus_enabled(void)
+{
+    return recording;
+}
+
+esp_err_t duco_corpus_init(uint8_t rigs)
+{
+    if (!DUCO_CORPUS_RECORD) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY,
+                                         CORPUS_PARTITION);
+    if (partition == NULL || partition->size < CORPUS_OFFSET + CORPUS_SIZE) {
+        ESP_LOGE(TAG, "No room for a corpus in partition '%s'", CORPUS_PARTITION);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    write_offset = corpus_find_end();
+    if (write_offset == UINT32_MAX) {
+        ESP_LOGW(TAG, "Region does not hold a corpus - erasing");
+        esp_err_t ret = esp_partition_erase_range(partition, CORPUS_OFFSET, CORPUS_SIZE);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Erase failed: %s", esp_err_to_name(ret));
+            return ret;
+        }
+        write_offset = 0;
+    }
+
+    recording = true;
+    if (write_offset == 0 && corpus_append(CORPUS_MAGIC, sizeof(CORPUS_MAGIC) - 1) != ESP_OK) {
+        return ESP_FAIL;
+    }
+
+    stats_totals_t totals = {0};
+    stats_journal_get_totals(&totals);
+
+    char header[DUCO_CORPUS_MAX_LINE];
+    int len = snprintf(header, sizeof(header), "# session boot=%lu rigs=%u kernel=%s lanes=%d\n",
+                       (unsigned long)totals.boot_count, rigs, duco_sha1_mb_variant(),
+                       DUCO_SHA1_LANES);
+    esp_err_t ret = corpus_append(header, len);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    ESP_LOGI(TAG, "Recording accepted jobs at storage+0x%x (%lu / %d bytes used)",
+             CORPUS_OFFSET, (unsigned long)write_offset, CORPUS_SIZE);
+    return ESP_OK;
+}
+
+esp_err_t duco_corpus_record(const char *last_hash, const char *expected_hash,
+                             uint32_t difficulty, uint32_t nonce, int64_t solve_us)
+{
+    if (!recording) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    char line[DUCO_CORPUS_MAX_LINE];
+    int len = duco_corpus_format(line, sizeof(line) - 1, last_hash, expected_hash,
+                                 difficulty, nonce, solve_us);
+    if (len < 0) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    line[len++] = '\n';
+
+    esp_err_t ret = corpus_append(line, len);
+    if (ret == ESP_OK) {
+        records++;
+    }
+    return ret;
+}
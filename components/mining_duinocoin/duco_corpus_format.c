@@ -0,0 +1,70 @@
+/**
+ * DUCO-S1 Corpus Record Formatting (shared with host tools)
+ */
+
+#include "duco_corpus.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+int duco_corpus_format(char *buf, size_t len, const char *last_hash, const char *expected_hash,
+                       uint32_t difficulty, uint32_t nonce, int64_t solve_us)
+{
+    int n = snprintf(buf, len, "J,%s,%s,%lu,%lu,%lld", last_hash, expected_hash,
+                     (unsigned long)difficulty, (unsigned long)nonce, (long long)solve_us);
+    return (n < 0 || (size_t)n >= len) ? -1 : n;
+}
+
+/**
+ * @brief Copy one 40-char hex field and advance past its comma
+ */
+static const char *parse_hash(const char *p, char *out)
+{
+    for (int i = 0; i < 40; i++) {
+        if (!isxdigit((unsigned char)p[i])) {
+            return NULL;
+        }
+        out[i] = p[i];
+    }
+    out[40] = '\0';
+    return p[40] == ',' ? p + 41 : NULL;
+}
+
+bool duco_corpus_parse(const char *line, char *last_hash, char *expected_hash,
+                       uint32_t *difficulty, uint32_t *nonce, int64_t *solve_us)
+{
+    if (strncmp(line, "J,", 2) != 0) {
+        return false;
+    }
+
+    const char *p = parse_hash(line + 2, last_hash);
+    if (p) {
+        p = parse_hash(p, expected_hash);
+    }
+    if (!p) {
+        return false;
+    }
+
+    char *end;
+    unsigned long diff = strtoul(p, &end, 10);
+    if (end == p || *end != ',') {
+        return false;
+    }
+    p = end + 1;
+    unsigned long n = strtoul(p, &end, 10);
+    if (end == p) {
+        return false;
+    }
+
+    // Device solve time is informational and may be absent
+    long long us = 0;
+    if (*end == ',') {
+        us = strtoll(end + 1, NULL, 10);
+    }
+
+    *difficulty = (uint32_t)diff;
+    *nonce = (uint32_t)n;
+    *solve_us = us;
+    return true;
+}
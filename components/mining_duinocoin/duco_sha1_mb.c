@@ -0,0 +1,430 @@
+/**
+ * Multi-Buffer SHA-1 Kernel Implementation
+ *
+ * Message words are kept transposed (word-major, lane-minor) so each round
+ * runs the same operation across all lanes back to back. The scalar variant
+ * relies on the compiler to unroll the constant-count lane loops; the SIMD
+ * variants map one lane to one 32-bit vector element.
+ */
+
+#include "duco_sha1_mb.h"
+#include <assert.h>
+#include <string.h>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#define H0 0x67452301u
+#define H1 0xEFCDAB89u
+#define H2 0x98BADCFEu
+#define H3 0x10325476u
+#define H4 0xC3D2E1F0u
+
+#define K0 0x5A827999u
+#define K1 0x6ED9EBA1u
+#define K2 0x8F1BBCDCu
+#define K3 0xCA62C1D6u
+
+#define ROTL(x, n) (((x) << (n)) | ((x) >> (32 - (n))))
+
+#define F_CH(b, c, d)     ((d) ^ ((b) & ((c) ^ (d))))
+#define F_PARITY(b, c, d) ((b) ^ (c) ^ (d))
+#define F_MAJ(b, c, d)    (((b) & (c)) | ((d) & ((b) | (c))))
+
+typedef uint32_t lane_state_t[5][DUCO_SHA1_MB_MAX_LANES];
+typedef uint32_t lane_words_t[16][DUCO_SHA1_MB_MAX_LANES];
+
+static inline uint32_t load_be32(const uint8_t *p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static inline void store_be32(uint8_t *p, uint32_t v)
+{
+    p[0] = v >> 24;
+    p[1] = v >> 16;
+    p[2] = v >> 8;
+    p[3] = v;
+}
+
+static int hex_nibble(char c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+/**
+ * @brief Write a nonce in decimal, return the number of digits
+ */
+static inline unsigned put_decimal(uint8_t *out, uint32_t value)
+{
+    uint8_t tmp[10];
+    unsigned n = 0;
+
+    do {
+        tmp[n++] = '0' + value % 10;
+        value /= 10;
+    } while (value);
+
+    for (unsigned i = 0; i < n; i++) {
+        out[i] = tmp[n - 1 - i];
+    }
+    return n;
+}
+
+/**
+ * @brief Build the message words of every lane, transposed
+ */
+static inline void load_lanes(const duco_sha1_job_t *job, uint32_t nonce_base, unsigned lanes,
+                              lane_words_t w)
+{
+    unsigned fixed = job->fixed_words;
+    unsigned start = fixed * 4;
+
+    for (unsigned i = 0; i < fixed; i++) {
+        for (unsigned l = 0; l < lanes; l++) {
+            w[i][l] = job->words[i];
+        }
+    }
+
+    for (unsigned l = 0; l < lanes; l++) {
+        uint8_t block[64];
+        memcpy(block + start, job->block + start, job->prefix_len - start);
+        unsigned len = job->prefix_len + put_decimal(block + job->prefix_len, nonce_base + l);
+
+        block[len] = 0x80;
+        memset(block + len + 1, 0, 60 - len - 1);
+        store_be32(block + 60, len * 8);
+
+        for (unsigned i = fixed; i < 16; i++) {
+            w[i][l] = load_be32(block + i * 4);
+        }
+    }
+}
+
+// ============================================================================
+// Scalar kernel (ESP32 and fallback)
+// ============================================================================
+
+static inline uint32_t scalar_schedule(lane_words_t w, unsigned t, unsigned l)
+{
+    if (t < 16) {
+        return w[t][l];
+    }
+    uint32_t x = w[(t - 3) & 15][l] ^ w[(t - 8) & 15][l] ^ w[(t - 14) & 15][l] ^ w[t & 15][l];
+    w[t & 15][l] = ROTL(x, 1);
+    return w[t & 15][l];
+}
+
+#define SCALAR_PHASE(t_end, F, K)                                                   \
+    for (; t < (t_end); t++) {                                                      \
+        for (unsigned l = 0; l < lanes; l++) {                                      \
+            uint32_t tmp = ROTL(a[l], 5) + F(b[l], c[l], d[l]) + e[l] + (K) +       \
+                           scalar_schedule(w, t, l);                                \
+            e[l] = d[l];                                                            \
+            d[l] = c[l];                                                            \
+            c[l] = ROTL(b[l], 30);                                                  \
+            b[l] = a[l];                                                            \
+            a[l] = tmp;                                                             \
+        }                                                                           \
+    }
+
+static inline __attribute__((always_inline))
+void sha1_lanes_scalar(const duco_sha1_job_t *job, uint32_t nonce_base, unsigned lanes,
+                       lane_state_t out, unsigned lane_off)
+{
+    lane_words_t w;
+    uint32_t a[DUCO_SHA1_MB_MAX_LANES], b[DUCO_SHA1_MB_MAX_LANES], c[DUCO_SHA1_MB_MAX_LANES];
+    uint32_t d[DUCO_SHA1_MB_MAX_LANES], e[DUCO_SHA1_MB_MAX_LANES];
+
+    load_lanes(job, nonce_base, lanes, w);
+
+    for (unsigned l = 0; l < lanes; l++) {
+        a[l] = job->mid[0];
+        b[l] = job->mid[1];
+        c[l] = job->mid[2];
+        d[l] = job->mid[3];
+        e[l] = job->mid[4];
+    }
+
+    // Rounds below fixed_words were precomputed in duco_sha1_mb_prepare()
+    unsigned t = job->fixed_words;
+    SCALAR_PHASE(20, F_CH, K0)
+    SCALAR_PHASE(40, F_PARITY, K1)
+    SCALAR_PHASE(60, F_MAJ, K2)
+    SCALAR_PHASE(80, F_PARITY, K3)
+
+    for (unsigned l = 0; l < lanes; l++) {
+        out[0][lane_off + l] = H0 + a[l];
+        out[1][lane_off + l] = H1 + b[l];
+        out[2][lane_off + l] = H2 + c[l];
+        out[3][lane_off + l] = H3 + d[l];
+        out[4][lane_off + l] = H4 + e[l];
+    }
+}
+
+// Constant lane counts let the compiler fully unroll the lane loops
+static void sha1_lanes_scalar_2(const duco_sha1_job_t *job, uint32_t base, lane_state_t out)
+{
+    sha1_lanes_scalar(job, base, 2, out, 0);
+}
+
+#if !defined(__SSE2__)
+static void sha1_lanes_scalar_4(const duco_sha1_job_t *job, uint32_t base, lane_state_t out)
+{
+    sha1_lanes_scalar(job, base, 4, out, 0);
+}
+
+static void sha1_lanes_scalar_8(const duco_sha1_job_t *job, uint32_t base, lane_state_t out)
+{
+    sha1_lanes_scalar(job, base, 8, out, 0);
+}
+#endif
+
+// ============================================================================
+// SIMD kernels (host builds)
+// ============================================================================
+
+#if defined(__SSE2__)
+
+#define V4_ROTL(x, n) _mm_or_si128(_mm_slli_epi32((x), (n)), _mm_srli_epi32((x), 32 - (n)))
+#define V4_CH(b, c, d)     _mm_xor_si128((d), _mm_and_si128((b), _mm_xor_si128((c), (d))))
+#define V4_PARITY(b, c, d) _mm_xor_si128(_mm_xor_si128((b), (c)), (d))
+#define V4_MAJ(b, c, d)    _mm_or_si128(_mm_and_si128((b), (c)), _mm_and_si128((d), _mm_or_si128((b), (c))))
+
+#define V4_PHASE(t_end, F, K)                                                       \
+    for (; t < (t_end); t++) {                                                      \
+        __m128i wt;                                                                 \
+        if (t < 16) {                                                               \
+            wt = w[t];                                                              \
+        } else {                                                                    \
+            __m128i x = _mm_xor_si128(_mm_xor_si128(w[(t - 3) & 15], w[(t - 8) & 15]), \
+                                      _mm_xor_si128(w[(t - 14) & 15], w[t & 15]));  \
+            wt = w[t & 15] = V4_ROTL(x, 1);                                         \
+        }                                                                           \
+        __m128i tmp = _mm_add_epi32(_mm_add_epi32(V4_ROTL(a, 5), F(b, c, d)),       \
+                                    _mm_add_epi32(_mm_add_epi32(e, _mm_set1_epi32(K)), wt)); \
+        e = d;                                                                      \
+        d = c;                                                                      \
+        c = V4_ROTL(b, 30);                                                         \
+        b = a;                                                                      \
+        a = tmp;                                                                    \
+    }
+
+static void sha1_lanes_sse2(const duco_sha1_job_t *job, uint32_t nonce_base,
+                            lane_state_t out, unsigned lane_off)
+{
+    lane_words_t words;
+    __m128i w[16];
+
+    load_lanes(job, nonce_base, 4, words);
+    for (unsigned i = 0; i < 16; i++) {
+        w[i] = _mm_loadu_si128((const __m128i *)words[i]);
+    }
+
+    __m128i a = _mm_set1_epi32(job->mid[0]);
+    __m128i b = _mm_set1_epi32(job->mid[1]);
+    __m128i c = _mm_set1_epi32(job->mid[2]);
+    __m128i d = _mm_set1_epi32(job->mid[3]);
+    __m128i e = _mm_set1_epi32(job->mid[4]);
+
+    unsigned t = job->fixed_words;
+    V4_PHASE(20, V4_CH, K0)
+    V4_PHASE(40, V4_PARITY, K1)
+    V4_PHASE(60, V4_MAJ, K2)
+    V4_PHASE(80, V4_PARITY, K3)
+
+    _mm_storeu_si128((__m128i *)&out[0][lane_off], _mm_add_epi32(a, _mm_set1_epi32(H0)));
+    _mm_storeu_si128((__m128i *)&out[1][lane_off], _mm_add_epi32(b, _mm_set1_epi32(H1)));
+    _mm_storeu_si128((__m128i *)&out[2][lane_off], _mm_add_epi32(c, _mm_set1_epi32(H2)));
+    _mm_storeu_si128((__m128i *)&out[3][lane_off], _mm_add_epi32(d, _mm_set1_epi32(H3)));
+    _mm_storeu_si128((__m128i *)&out[4][lane_off], _mm_add_epi32(e, _mm_set1_epi32(H4)));
+}
+
+#endif // __SSE2__
+
+#if defined(__AVX2__)
+
+#define V8_ROTL(x, n) _mm256_or_si256(_mm256_slli_epi32((x), (n)), _mm256_srli_epi32((x), 32 - (n)))
+#define V8_CH(b, c, d)     _mm256_xor_si256((d), _mm256_and_si256((b), _mm256_xor_si256((c), (d))))
+#define V8_PARITY(b, c, d) _mm256_xor_si256(_mm256_xor_si256((b), (c)), (d))
+#define V8_MAJ(b, c, d)    _mm256_or_si256(_mm256_and_si256((b), (c)), \
+                                           _mm256_and_si256((d), _mm256_or_si256((b), (c))))
+
+#define V8_PHASE(t_end, F, K)                                                       \
+    for (; t < (t_end); t++) {                                                      \
+        __m256i wt;                                                                 \
+        if (t < 16) {                                                               \
+            wt = w[t];                                                              \
+        } else {                                                                    \
+            __m256i x = _mm256_xor_si256(_mm256_xor_si256(w[(t - 3) & 15], w[(t - 8) & 15]), \
+                                         _mm256_xor_si256(w[(t - 14) & 15], w[t & 15])); \
+            wt = w[t & 15] = V8_ROTL(x, 1);                                         \
+        }                                                                           \
+        __m256i tmp = _mm256_add_epi32(_mm256_add_epi32(V8_ROTL(a, 5), F(b, c, d)), \
+                                       _mm256_add_epi32(_mm256_add_epi32(e, _mm256_set1_epi32(K)), wt)); \
+        e = d;                                                                      \
+        d = c;                                                                      \
+        c = V8_ROTL(b, 30);                                                         \
+        b = a;                                                                      \
+        a = tmp;                                                                    \
+    }
+
+static void sha1_lanes_avx2(const duco_sha1_job_t *job, uint32_t nonce_base, lane_state_t out)
+{
+    lane_words_t words;
+    __m256i w[16];
+
+    load_lanes(job, nonce_base, 8, words);
+    for (unsigned i = 0; i < 16; i++) {
+        w[i] = _mm256_loadu_si256((const __m256i *)words[i]);
+    }
+
+    __m256i a = _mm256_set1_epi32(job->mid[0]);
+    __m256i b = _mm256_set1_epi32(job->mid[1]);
+    __m256i c = _mm256_set1_epi32(job->mid[2]);
+    __m256i d = _mm256_set1_epi32(job->mid[3]);
+    __m256i e = _mm256_set1_epi32(job->mid[4]);
+
+    unsigned t = job->fixed_words;
+    V8_PHASE(20, V8_CH, K0)
+    V8_PHASE(40, V8_PARITY, K1)
+    V8_PHASE(60, V8_MAJ, K2)
+    V8_PHASE(80, V8_PARITY, K3)
+
+    _mm256_storeu_si256((__m256i *)out[0], _mm256_add_epi32(a, _mm256_set1_epi32(H0)));
+    _mm256_storeu_si256((__m256i *)out[1], _mm256_add_epi32(b, _mm256_set1_epi32(H1)));
+    _mm256_storeu_si256((__m256i *)out[2], _mm256_add_epi32(c, _mm256_set1_epi32(H2)));
+    _mm256_storeu_si256((__m256i *)out[3], _mm256_add_epi32(d, _mm256_set1_epi32(H3)));
+    _mm256_storeu_si256((__m256i *)out[4], _mm256_add_epi32(e, _mm256_set1_epi32(H4)));
+}
+
+#endif // __AVX2__
+
+// ============================================================================
+// Dispatch
+// ============================================================================
+
+/**
+ * @brief Run the best available kernel for the requested lane count
+ *
+ * @return Lanes hashed; 0 if the count is not 2, 4 or 8 (a caller stepping
+ *         its nonce by lanes would otherwise skip or repeat nonces)
+ */
+static unsigned sha1_lanes(const duco_sha1_job_t *job, uint32_t nonce_base, unsigned lanes,
+                           lane_state_t out)
+{
+    switch (lanes) {
+        case 8:
+#if defined(__AVX2__)
+            sha1_lanes_avx2(job, nonce_base, out);
+#elif defined(__SSE2__)
+            sha1_lanes_sse2(job, nonce_base, out, 0);
+            sha1_lanes_sse2(job, nonce_base + 4, out, 4);
+#else
+            sha1_lanes_scalar_8(job, nonce_base, out);
+#endif
+            return 8;
+        case 4:
+#if defined(__SSE2__)
+            sha1_lanes_sse2(job, nonce_base, out, 0);
+#else
+            sha1_lanes_scalar_4(job, nonce_base, out);
+#endif
+            return 4;
+        case 2:
+            sha1_lanes_scalar_2(job, nonce_base, out);
+            return 2;
+        default:
+            assert(!"unsupported SHA-1 lane count");
+            return 0;
+    }
+}
+
+bool duco_sha1_mb_prepare(duco_sha1_job_t *job, const char *prefix, size_t prefix_len,
+                          const char *expected_hex)
+{
+    if (prefix_len > DUCO_SHA1_MB_MAX_PREFIX) {
+        return false;
+    }
+
+    memset(job, 0, sizeof(*job));
+    memcpy(job->block, prefix, prefix_len);
+    job->prefix_len = prefix_len;
+    job->fixed_words = prefix_len / 4;
+
+    for (unsigned i = 0; i < 20; i++) {
+        int hi = hex_nibble(expected_hex[i * 2]);
+        int lo = hi < 0 ? -1 : hex_nibble(expected_hex[i * 2 + 1]);
+        if (lo < 0) {
+            return false;
+        }
+        job->target[i / 4] = (job->target[i / 4] << 8) | (uint32_t)(hi << 4 | lo);
+    }
+
+    for (unsigned i = 0; i < job->fixed_words; i++) {
+        job->words[i] = load_be32(job->block + i * 4);
+    }
+
+    // Rounds that consume only prefix words are the same for every nonce
+    uint32_t a = H0, b = H1, c = H2, d = H3, e = H4;
+    for (unsigned t = 0; t < job->fixed_words; t++) {
+        uint32_t tmp = ROTL(a, 5) + F_CH(b, c, d) + e + K0 + job->words[t];
+        e = d;
+        d = c;
+        c = ROTL(b, 30);
+        b = a;
+        a = tmp;
+    }
+    job->mid[0] = a;
+    job->mid[1] = b;
+    job->mid[2] = c;
+    job->mid[3] = d;
+    job->mid[4] = e;
+
+    return true;
+}
+
+uint32_t duco_sha1_mb_search(const duco_sha1_job_t *job, uint32_t nonce_base, unsigned lanes)
+{
+    lane_state_t out;
+    unsigned done = sha1_lanes(job, nonce_base, lanes, out);
+    uint32_t mask = 0;
+
+    for (unsigned l = 0; l < done; l++) {
+        if (out[0][l] == job->target[0] && out[1][l] == job->target[1] &&
+            out[2][l] == job->target[2] && out[3][l] == job->target[3] &&
+            out[4][l] == job->target[4]) {
+            mask |= 1u << l;
+        }
+    }
+    return mask;
+}
+
+bool duco_sha1_mb_digests(const duco_sha1_job_t *job, uint32_t nonce_base, unsigned lanes,
+                          uint8_t digests[][20])
+{
+    lane_state_t out;
+    unsigned done = sha1_lanes(job, nonce_base, lanes, out);
+
+    for (unsigned l = 0; l < done; l++) {
+        for (unsigned j = 0; j < 5; j++) {
+            store_be32(digests[l] + j * 4, out[j][l]);
+        }
+    }
+    return done == lanes;
+}
+
+const char *duco_sha1_mb_variant(void)
+{
+#if defined(__AVX2__)
+    return "avx2";
+#elif defined(__SSE2__)
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
@@ -0,0 +1,86 @@
+/**
+ * DUCO Share Retry Queue Implementation
+ */
+
+#include "duco_share_queue.h"
+#include <string.h>
+
+void duco_share_queue_init(duco_share_queue_t *q)
+{
+    memset(q, 0, sizeof(*q));
+}
+
+void duco_share_queue_push(duco_share_queue_t *q, const duco_pending_share_t *share)
+{
+    duco_pending_share_t *slot = NULL;
+
+    for (size_t i = 0; i < DUCO_SHARE_QUEUE_LEN; i++) {
+        duco_pending_share_t *e = &q->entries[i];
+        if (!e->used) {
+            slot = e;
+            break;
+        }
+        if (!slot || e->found_us < slot->found_us) {
+            slot = e;
+        }
+    }
+
+    // Full - evict the oldest share
+    if (slot->used) {
+        q->expired++;
+    }
+
+    *slot = *share;
+    slot->used = true;
+    q->queued++;
+}
+
+uint32_t duco_share_queue_expire(duco_share_queue_t *q, const char *current_last_hash,
+                                 int64_t now_us, int64_t max_age_us)
+{
+    uint32_t count = 0;
+
+    for (size_t i = 0; i < DUCO_SHARE_QUEUE_LEN; i++) {
+        duco_pending_share_t *e = &q->entries[i];
+        if (!e->used) {
+            continue;
+        }
+
+        bool stale = (now_us - e->found_us) > max_age_us ||
+                     e->attempts >= DUCO_SHARE_MAX_ATTEMPTS ||
+                     (current_last_hash && strcmp(e->last_hash, current_last_hash) != 0);
+        if (stale) {
+            e->used = false;
+            count++;
+        }
+    }
+
+    q->expired += count;
+    return count;
+}
+
+bool duco_share_queue_take(duco_share_queue_t *q, const char *last_hash,
+                           const char *expected_hash, duco_pending_share_t *out)
+{
+    for (size_t i = 0; i < DUCO_SHARE_QUEUE_LEN; i++) {
+        duco_pending_share_t *e = &q->entries[i];
+        if (e->used && strcmp(e->last_hash, last_hash) == 0 &&
+            strcmp(e->expected_hash, expected_hash) == 0) {
+            *out = *e;
+            e->used = false;
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t duco_share_queue_count(const duco_share_queue_t *q)
+{
+    size_t count = 0;
+    for (size_t i = 0; i < DUCO_SHARE_QUEUE_LEN; i++) {
+        if (q->entries[i].used) {
+            count++;
+        }
+    }
+    return count;
+}
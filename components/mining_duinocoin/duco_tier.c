@@ -0,0 +1,188 @@
+/**
+ * DUCO Difficulty Tier Selection Implementation
+ *
+ * Tiers are ordered from easiest to hardest. Moving up a tier makes each job
+ * take longer, which amortizes the fixed network round trip; moving too far
+ * up makes jobs slow enough to risk timeouts. The server also rejects shares
+ * ("kolka" limits) whose reported hashrate is implausibly high for the tier.
+ *
+ * Whenever a tier proves unusable it becomes the learned floor/ceiling, so
+ * the selector settles instead of oscillating between two tiers.
+ */
+
+#include "duco_tier.h"
+#include <string.h>
+#include <strings.h>
+
+// Approximate server-side hashrate limits per tier
+typedef struct {
+    const char *name;
+    float max_hashrate;     // H/s above which shares risk rejection
+} duco_tier_info_t;
+
+static const duco_tier_info_t tiers[DUCO_TIER_COUNT] = {
+    { "ESP8266", 15000.0f },
+    { "ESP32",   80000.0f },
+    { "LOW",     300000.0f },
+    { "MEDIUM",  1500000.0f },
+    { "NET",     1e12f },
+};
+
+#define DEFAULT_TIER 1              // "ESP32"
+#define EWMA_ALPHA 0.2f
+#define MIN_SAMPLES 5               // Jobs to observe before any decision
+#define MAX_OVERHEAD_PCT 5.0f       // Network share of wall time we accept
+#define MAX_SOLVE_MS 60000.0f       // Slower jobs risk server-side timeouts
+#define MAX_REJECT_PCT 25.0f
+#define TOO_FAST_MARGIN 0.9f        // Move up before reaching the hard limit
+#define REWARD_MARGIN 1.10f         // Neighbour must pay 10% more to switch
+
+static float ewma(float avg, float sample, bool first)
+{
+    return first ? sample : avg + EWMA_ALPHA * (sample - avg);
+}
+
+/**
+ * @brief Switch tier and restart measurement
+ */
+static bool change_tier(duco_tier_selector_t *sel, uint8_t tier, duco_tier_reason_t reason)
+{
+    sel->tier = tier;
+    sel->reason = reason;
+    sel->samples = 0;
+    sel->rejects = 0;
+    return true;
+}
+
+bool duco_tier_init(duco_tier_selector_t *sel, const char *configured)
+{
+    memset(sel, 0, sizeof(*sel));
+    sel->tier = DEFAULT_TIER;
+    sel->floor = 0;
+    sel->ceiling = DUCO_TIER_COUNT - 1;
+    sel->reason = DUCO_TIER_REASON_WARMUP;
+
+    if (!configured || configured[0] == '\0' || strcasecmp(configured, DUCO_TIER_AUTO) == 0) {
+        return true;
+    }
+
+    for (uint8_t i = 0; i < DUCO_TIER_COUNT; i++) {
+        if (strcasecmp(configured, tiers[i].name) == 0) {
+            sel->tier = i;
+            sel->overridden = true;
+            sel->reason = DUCO_TIER_REASON_OVERRIDE;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool duco_tier_record(duco_tier_selector_t *sel, uint32_t solve_us, uint32_t rtt_us,
+                      uint32_t hashes, bool accepted, float reward)
+{
+    bool first = sel->samples == 0;
+    float solve_ms = solve_us / 1000.0f;
+    float rtt_ms = rtt_us / 1000.0f;
+
+    sel->solve_ms = ewma(sel->solve_ms, solve_ms, first);
+    sel->rtt_ms = ewma(sel->rtt_ms, rtt_ms, first);
+    if (solve_ms > 0.0f) {
+        sel->hashrate = ewma(sel->hashrate, hashes / (solve_ms / 1000.0f), first);
+    }
+    // Explicit counts seed these: a genuine zero average must not restart them
+    if (accepted && reward > 0.0f) {
+        sel->reward_per_share = ewma(sel->reward_per_share, reward, sel->reward_samples++ == 0);
+    }
+
+    float wall_sec = (solve_ms + rtt_ms) / 1000.0f;
+    if (wall_sec > 0.0f) {
+        float rate = (accepted ? reward : 0.0f) / wall_sec;
+        float *avg = &sel->reward_rate[sel->tier];
+        *avg = ewma(*avg, rate, sel->rate_samples[sel->tier]++ == 0);
+    }
+
+    sel->samples++;
+    if (!accepted) {
+        sel->rejects++;
+    }
+
+    if (sel->overridden) {
+        return false;
+    }
+
+    if (sel->samples < MIN_SAMPLES) {
+        return false;
+    }
+
+    uint8_t t = sel->tier;
+    bool can_up = t < sel->ceiling;
+    bool can_down = t > sel->floor;
+
+    // Server rejects shares that are implausibly fast for the tier
+    if (sel->hashrate > tiers[t].max_hashrate * TOO_FAST_MARGIN && t + 1 < DUCO_TIER_COUNT) {
+        sel->floor = t + 1;
+        if (sel->ceiling < sel->floor) sel->ceiling = sel->floor;
+        return change_tier(sel, t + 1, DUCO_TIER_REASON_TOO_FAST);
+    }
+
+    if (sel->solve_ms > MAX_SOLVE_MS && can_down) {
+        sel->ceiling = t - 1;
+        return change_tier(sel, t - 1, DUCO_TIER_REASON_TOO_SLOW);
+    }
+
+    float reject_pct = 100.0f * sel->rejects / sel->samples;
+    if (reject_pct > MAX_REJECT_PCT) {
+        if (can_down) {
+            sel->ceiling = t - 1;
+            return change_tier(sel, t - 1, DUCO_TIER_REASON_REJECTS);
+        }
+        if (can_up) {
+            sel->floor = t + 1;
+            return change_tier(sel, t + 1, DUCO_TIER_REASON_REJECTS);
+        }
+    }
+
+    if (duco_tier_overhead_pct(sel) > MAX_OVERHEAD_PCT && can_up) {
+        return change_tier(sel, t + 1, DUCO_TIER_REASON_OVERHEAD);
+    }
+
+    // Among acceptable neighbours, prefer whichever has paid better
+    float here = sel->reward_rate[t];
+    if (can_up && sel->reward_rate[t + 1] > here * REWARD_MARGIN) {
+        return change_tier(sel, t + 1, DUCO_TIER_REASON_REWARD);
+    }
+    if (can_down && sel->reward_rate[t - 1] > here * REWARD_MARGIN &&
+        duco_tier_overhead_pct(sel) < MAX_OVERHEAD_PCT / 2) {
+        return change_tier(sel, t - 1, DUCO_TIER_REASON_REWARD);
+    }
+
+    sel->reason = DUCO_TIER_REASON_HOLD;
+    return false;
+}
+
+const char *duco_tier_name(const duco_tier_selector_t *sel)
+{
+    return tiers[sel->tier].name;
+}
+
+float duco_tier_overhead_pct(const duco_tier_selector_t *sel)
+{
+    float wall = sel->solve_ms + sel->rtt_ms;
+    return wall > 0.0f ? 100.0f * sel->rtt_ms / wall : 0.0f;
+}
+
+const char *duco_tier_reason_str(duco_tier_reason_t reason)
+{
+    switch (reason) {
+        case DUCO_TIER_REASON_WARMUP:   return "warmup";
+        case DUCO_TIER_REASON_HOLD:     return "hold";
+        case DUCO_TIER_REASON_OVERRIDE: return "override";
+        case DUCO_TIER_REASON_OVERHEAD: return "network overhead";
+        case DUCO_TIER_REASON_TOO_FAST: return "too fast";
+        case DUCO_TIER_REASON_TOO_SLOW: return "too slow";
+        case DUCO_TIER_REASON_REJECTS:  return "rejects";
+        case DUCO_TIER_REASON_REWARD:   return "reward";
+        default:                        return "unknown";
+    }
+}
@@ -0,0 +1,285 @@
+/**
+ * DUCO Hashing Worker Implementation
+ */
+
+#include "duco_worker.h"
+#include "duco_sha1_mb.h"
+#include "thermal_governor.h"
+#include "mem_budget.h"
+#include "dlog.h"
+#include "boot_metrics.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_task_wdt.h"
+#include <string.h>
+#include <stdio.h>
+
+static const char *TAG = "DUCO_WORKER";
+
+#define DUCO_WORKER_IDLE_WAIT_MS 100
+#define DUCO_WORKER_STACK_SIZE 4096
+
+/**
+ * @brief Has the job's connection generation ended?
+ */
+static inline bool duco_worker_job_stale(duco_worker_t *w, const duco_job_t *job)
+{
+    return atomic_load_explicit(&w->generation, memory_order_acquire) != job->id.generation;
+}
+
+/**
+ * @brief Feed the task watchdog, if this worker is subscribed
+ */
+static inline void duco_worker_feed_wdt(duco_worker_t *w)
+{
+    if (w->wdt_subscribed) {
+        esp_task_wdt_reset();
+    }
+}
+
+/**
+ * @brief Credit a job's hashes to the worker total
+ *
+ * Single writer, so a relaxed add is enough; it keeps the 64-bit value from
+ * tearing for readers on the other core.
+ */
+static inline void duco_worker_count_hashes(duco_worker_t *w, uint32_t hashes)
+{
+    atomic_fetch_add_explicit(&w->total_hashes, hashes, memory_order_relaxed);
+}
+
+/**
+ * @brief Account for a running job abandoned because its generation ended
+ */
+static esp_err_t duco_worker_preempted(duco_worker_t *w, duco_result_t *result)
+{
+    uint32_t requested = atomic_load_explicit(&w->preempt_request_us, memory_order_relaxed);
+    uint32_t latency_us = (uint32_t)esp_timer_get_time() - requested;
+
+    duco_worker_count_hashes(w, result->hashes);
+    w->preemptions++;
+    w->preempt_last_us = latency_us;
+    if (latency_us > w->preempt_max_us) {
+        w->preempt_max_us = latency_us;
+    }
+    return ESP_ERR_TIMEOUT;
+}
+
+/**
+ * @brief Search a job's nonce range
+ *
+ * @return ESP_OK with result filled, ESP_ERR_INVALID_STATE if stopped,
+ *         ESP_ERR_TIMEOUT if the job went stale
+ */
+static esp_err_t duco_worker_solve(duco_worker_t *w, const duco_job_t *job, duco_result_t *result)
+{
+    memset(result, 0, sizeof(*result));
+    result->job = job->id;
+
+    int64_t start_time = esp_timer_get_time();
+    uint32_t max_nonce = job->nonce_end;
+
+    // Slice length comes from the thermal governor
+    thermal_pacer_t pacer = { .worker_index = w->index };
+    thermal_limits_t limits;
+    thermal_governor_get_limits(&limits);
+    hash_slice_set_target(&w->slice, limits.slice_us);
+    uint32_t batch_left = w->slice.batch;
+    uint32_t batch_hashes = 0;
+    int64_t batch_start = start_time;
+
+    // Mine: find nonce where SHA1(last_hash + nonce) == expected_hash
+    for (uint32_t base = job->nonce_start; base < max_nonce; base += DUCO_SHA1_LANES) {
+        // Hash DUCO_SHA1_LANES consecutive nonces at once
+        uint32_t match = duco_sha1_mb_search(&job->sha1, base, DUCO_SHA1_LANES);
+        batch_hashes += DUCO_SHA1_LANES;
+        result->hashes += DUCO_SHA1_LANES;
+        // Check if any lane matched (lowest nonce wins)
+        uint32_t nonce = base + (match ? __builtin_ctz(match) : 0);
+        if (match && nonce < max_nonce) {
+            int64_t end_time = esp_timer_get_time();
+            hashrate_meter_record(w->meter, 0, batch_hashes,
+                                  (uint32_t)(end_time - batch_start));
+            duco_worker_count_hashes(w, result->hashes);
+            result->found = true;
+            result->nonce = nonce;
+            result->solve_us = end_time - start_time;
+            return ESP_OK;
+        }
+
+        // Slice boundary: the only place the worker responds to anything
+        if (batch_left <= DUCO_SHA1_LANES) {
+            int64_t now = esp_timer_get_time();
+            uint32_t elapsed_us = (uint32_t)(now - batch_start);
+            hashrate_meter_record(w->meter, 0, batch_hashes, elapsed_us);
+            hash_slice_record(&w->slice, batch_hashes, elapsed_us);
+            batch_hashes = 0;
+            duco_worker_feed_wdt(w);
+
+            if (w->stop) {
+                return ESP_ERR_INVALID_STATE;
+            }
+            if (duco_worker_job_stale(w, job)) {
+                return duco_worker_preempted(w, result);
+            }
+
+            // Thermal limits (also yields to other tasks)
+            uint32_t slice_us = thermal_governor_pace(&pacer, elapsed_us);
+
+            // Too hot - hold the job until the governor lets us continue
+            while (slice_us == 0) {
+                if (w->stop) {
+                    return ESP_ERR_INVALID_STATE;
+                }
+                if (duco_worker_job_stale(w, job)) {
+                    return duco_worker_preempted(w, result);
+                }
+                vTaskDelay(pdMS_TO_TICKS(1000));
+                duco_worker_feed_wdt(w);
+                slice_us = thermal_governor_pace(&pacer, 0);
+            }
+            hash_slice_set_target(&w->slice, slice_us);
+            batch_left = w->slice.batch;
+            batch_start = esp_timer_get_time();
+        } else {
+            batch_left -= DUCO_SHA1_LANES;
+        }
+    }
+
+    DLOG_W(TAG, "Worker %u: no nonce within difficulty range", w->index);
+    duco_worker_count_hashes(w, result->hashes);
+    result->solve_us = esp_timer_get_time() - start_time;
+    return ESP_OK;
+}
+
+/**
+ * @brief Worker task - consume jobs, produce results
+ */
+static void duco_worker_task(void *param)
+{
+    duco_worker_t *w = (duco_worker_t *)param;
+    ESP_LOGI(TAG, "Worker %u started", w->index);
+
+    // Only fails if the watchdog is not initialized; then there is nothing to feed
+    w->wdt_subscribed = esp_task_wdt_add(NULL) == ESP_OK;
+
+    while (!w->stop) {
+        duco_job_t job;
+        if (!spsc_ring_pop(&w->jobs, &job)) {
+            // Nothing queued - sleep until the network task notifies us
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(DUCO_WORKER_IDLE_WAIT_MS));
+            duco_worker_feed_wdt(w);
+            continue;
+        }
+
+        // Connection went away while the job sat in the ring
+        if (duco_worker_job_stale(w, &job)) {
+            w->stale_dropped++;
+            continue;
+        }
+
+        boot_metrics_mark(BOOT_STAGE_FIRST_HASH);
+        duco_result_t result;
+        esp_err_t ret = duco_worker_solve(w, &job, &result);
+        if (ret == ESP_ERR_INVALID_STATE) {
+            break;
+        }
+        if (ret == ESP_ERR_TIMEOUT) {
+            w->stale_dropped++;
+            DLOG_D(TAG, "Worker %u dropped stale job", w->index);
+            continue;
+        }
+
+        // The network task drains results every poll; the ring is rarely full
+        while (!w->stop && !spsc_ring_push(&w->results, &result)) {
+            vTaskDelay(1);
+        }
+    }
+
+    if (w->wdt_subscribed) {
+        esp_task_wdt_delete(NULL);
+        w->wdt_subscribed = false;
+    }
+    ESP_LOGI(TAG, "Worker %u stopped", w->index);
+    mem_budget_unregister_task(NULL);
+    w->task = NULL;
+    vTaskDelete(NULL);
+}
+
+void duco_worker_init(duco_worker_t *worker, uint8_t index, hashrate_meter_t *meter)
+{
+    memset(worker, 0, sizeof(*worker));
+    worker->index = index;
+    worker->meter = meter;
+    spsc_ring_init(&worker->jobs, worker->job_slots, sizeof(duco_job_t), DUCO_JOB_RING_SIZE);
+    spsc_ring_init(&worker->results, worker->result_slots, sizeof(duco_result_t), DUCO_RESULT_RING_SIZE);
+    atomic_init(&worker->generation, 0);
+    atomic_init(&worker->preempt_request_us, 0);
+    atomic_init(&worker->total_hashes, 0);
+
+    thermal_limits_t limits;
+    thermal_governor_get_limits(&limits);
+    hash_slice_init(&worker->slice, limits.slice_us);
+}
+
+bool duco_worker_submit(duco_worker_t *worker, const duco_job_t *job)
+{
+    if (!spsc_ring_push(&worker->jobs, job)) {
+        return false;
+    }
+    if (worker->task != NULL) {
+        xTaskNotifyGive(worker->task);
+    }
+    return true;
+}
+
+esp_err_t duco_worker_start(duco_worker_t *worker, BaseType_t core, UBaseType_t priority)
+{
+    char name[16];
+    snprintf(name, sizeof(name), "duco_work%u", worker->index);
+
+    worker->stop = false;
+    BaseType_t ret = xTaskCreatePinnedToCore(
+        duco_worker_task,
+        name,
+        DUCO_WORKER_STACK_SIZE,
+        worker,
+        priority,
+        &worker->task,
+        core
+    );
+
+    if (ret != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create worker task");
+        worker->task = NULL;
+        return ESP_FAIL;
+    }
+    mem_budget_register_task(worker->task, DUCO_WORKER_STACK_SIZE);
+    return ESP_OK;
+}
+
+void duco_worker_stop(duco_worker_t *worker, uint32_t timeout_ms)
+{
+    if (worker->task == NULL) {
+        return;
+    }
+
+    worker->stop = true;
+
+    while (worker->task != NULL && timeout_ms >= 100) {
+        vTaskDelay(pdMS_TO_TICKS(100));
+        timeout_ms -= 100;
+    }
+
+    if (worker->task != NULL) {
+        ESP_LOGW(TAG, "Force deleting worker %u", worker->index);
+        // A deleted task left subscribed would trip the watchdog
+        if (worker->wdt_subscribed) {
+            esp_task_wdt_delete(worker->task);
+            worker->wdt_subscribed = false;
+        }
+        mem_budget_unregister_task(worker->task);
+        vTaskDelete(worker->task);
+        worker->task = NULL;
+    }
+}
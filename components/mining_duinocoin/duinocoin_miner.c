@@ -10,331 +10,1050 @@
  * 6. Send: "nonce,hashrate,miner_name,rig_id"
  * 7. Receive: "GOOD" or "BAD" + share_value
  * 8. Repeat from step 3
+ *
+ * Rigs:
+ * - Each rig is an independent DUCO connection with its own rig_id, job
+ *   stream and hashing worker, so the cores never wait on each other's
+ *   network round trips. Rig 0 hashes on core 1, rig 1 on core 0 below the
+ *   network task's priority.
+ *
+ * Threading:
+ * - One network task (core 0) owns every miner socket in non-blocking mode
+ *   and multiplexes them with select(): connect, job fetch, submission,
+ *   keepalive, timeouts and reconnect are all state transitions there.
+ * - Hashing workers (core 1, see duco_worker.c) only consume jobs and
+ *   produce results, so they never wait on the network. Jobs are parsed and
+ *   prepared here and travel over lock-free SPSC rings.
  */
 
 #include "duinocoin_miner.h"
+#include "duco_worker.h"
 #include "miner_config.h"
+#include "duco_tier.h"
+#include "duco_sha1_mb.h"
+#include "duco_share_queue.h"
+#include "duco_corpus.h"
+#include "stats_journal.h"
+#include "boot_metrics.h"
+#include "hashrate_meter.h"
+#include "mem_budget.h"
+#include "block_pool.h"
+#include "dlog.h"
 #include "esp_log.h"
 #include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "lwip/sockets.h"
 #include "lwip/netdb.h"
+#include "nvs.h"
 #include "mbedtls/sha1.h"
 #include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 static const char *TAG = "DUCO";
 
 // Protocol constants
 #define DUCO_MINER_NAME "ESP32-Miner"
-#define DUCO_DIFFICULTY "ESP32"  // Request ESP32-appropriate difficulty
 #define DUCO_BUFFER_SIZE 256
+#define DUCO_LINE_BUFFERS 4             // Pooled line buffers (receive + nested send)
+#define DUCO_NET_STACK_SIZE 6144
 #define DUCO_CONNECT_TIMEOUT_MS 10000
 #define DUCO_READ_TIMEOUT_MS 30000
+#define DUCO_SHARE_MAX_AGE_MS 120000    // Server job cache outlives this comfortably
+#define DUCO_RETRY_RECONNECT_MS 500     // Reconnect delay while shares are queued
+#define DUCO_BACKOFF_MIN_MS 1000
+#define DUCO_BACKOFF_MAX_MS 30000
+#define DUCO_NET_POLL_MS 10             // select() timeout - bounds result pickup latency
+#define DUCO_LINE_IDLE_MS 50            // Unterminated data this old is a complete message
+#define DUCO_KEEPALIVE_IDLE_S 30
+#define DUCO_KEEPALIVE_INTERVAL_S 10
+#define DUCO_KEEPALIVE_COUNT 3
+#define DUCO_NVS_NAMESPACE "duco"
+#define DUCO_NVS_POOL_HOST "pool_host"
+#define DUCO_NVS_POOL_ADDR "pool_addr"
+
+
+// Connection state machine (driven by the network task only)
+typedef enum {
+    CONN_DISCONNECTED = 0,      // Waiting for the next reconnect attempt
+    CONN_CONNECTING,            // Non-blocking connect in progress
+    CONN_WAIT_VERSION,          // Waiting for the server version banner
+    CONN_WAIT_JOB,              // JOB request sent
+    CONN_HASHING,               // Job handed to the worker
+    CONN_WAIT_RESULT,           // Share submitted, waiting for GOOD/BAD
+} conn_state_t;
+
+typedef struct {
+    uint8_t index;
+    int sock;
+    conn_state_t state;
+    uint32_t generation;        // Bumped on every disconnect; stamps issued jobs
+    int64_t deadline_us;        // Timeout for the current state (0 = none)
+    int64_t next_attempt_us;    // Earliest reconnect time
+    uint32_t backoff_ms;
+    int64_t request_us;         // When the outstanding request was sent
+    int64_t job_rtt_us;         // Round trip of the last job fetch
+    duco_result_t submitted;    // Share awaiting GOOD/BAD
+    bool submitted_recovered;   // Submitted share came from the retry queue
+    uint8_t submitted_attempts; // Submissions of that share so far, this one included
+    duco_share_queue_t shares;  // Found shares awaiting a re-issue of this connection's job
+    duco_tier_selector_t tier;  // Rigs hash at different rates, so each picks its own tier
+    char rx[DUCO_BUFFER_SIZE];
+    size_t rx_len;
+    int64_t rx_last_us;
+    duco_worker_t *worker;
+    hashrate_meter_t *meter;
+
+    // Per-rig identity and stats
+    char rig_id[32];
+    uint32_t accepted;
+    uint32_t rejected;
+    uint32_t reconnects;
+    uint32_t difficulty;
+    float last_rtt_ms;
+    float avg_rtt_ms;
+    uint32_t rtt_hist[DUCO_RTT_BUCKETS];
+    float rtt_sum_ms;
+} duco_conn_t;
 
 // Mining state
 static duco_state_t current_state = DUCO_STATE_IDLE;
-static TaskHandle_t mining_task_handle = NULL;
-static int sock = -1;
-static bool stop_requested = false;
+static TaskHandle_t net_task_handle = NULL;
+static volatile bool stop_requested = false;
+static volatile bool link_up = true;    // Set from the Wi-Fi manager; stays up without one
+static duco_conn_t conns[DUCO_MAX_RIGS];
+static duco_worker_t workers[DUCO_MAX_RIGS];
+static uint8_t rig_count = 1;
 
 // Statistics
 static duco_stats_t stats = {0};
-static uint64_t total_hashes = 0;
 static int64_t mining_start_time = 0;
 
+// Round-trip histogram bucket bounds, ms - DUCO round trips run 50 ms to seconds
+const uint16_t duco_rtt_bounds_ms[DUCO_RTT_BUCKETS - 1] = { 50, 100, 200, 400, 800, 1600, 3200 };
+
+// Windowed hashrate (one meter per rig, aggregated for totals)
+static hashrate_meter_t meters[DUCO_MAX_RIGS];
+static uint8_t meters_initialized = 0;
+
+// Lifetime totals recovered from the stats journal at init
+static stats_totals_t baseline = {0};
+
+// Pool address shared by every rig (network byte order, 0 = resolve first).
+// Persisted so a reboot connects without waiting for DNS.
+static uint32_t pool_addr = 0;
+
+// Line buffers for parsing and sending (kept off the network task stack)
+BLOCK_POOL_STORAGE(line_pool_storage, DUCO_BUFFER_SIZE, DUCO_LINE_BUFFERS);
+static block_pool_t line_pool;
+static bool line_pool_initialized = false;
+
 /**
- * @brief Calculate SHA1 hash
+ * @brief Convert a digest to lowercase hex
  */
-static void sha1_hash(const char *input, char *output_hex)
+static void digest_to_hex(const unsigned char *hash, char *output_hex)
 {
-    unsigned char hash[20];
-    mbedtls_sha1_context ctx;
-
-    mbedtls_sha1_init(&ctx);
-    mbedtls_sha1_starts(&ctx);
-    mbedtls_sha1_update(&ctx, (const unsigned char *)input, strlen(input));
-    mbedtls_sha1_finish(&ctx, hash);
-    mbedtls_sha1_free(&ctx);
-
-    // Convert to hex string
     for (int i = 0; i < 20; i++) {
         sprintf(output_hex + (i * 2), "%02x", hash[i]);
     }
     output_hex[40] = '\0';
 }
 
+esp_err_t duco_miner_self_test(void)
+{
+    static const char *prefix = "d7e2bd1c5bd6e9c0c7c0c6a51e1f2c1dd0b3c7a9";
+    static const uint32_t bases[] = { 0, 6, 96, 996, 99996, 4999992 };
+    static const unsigned lane_counts[] = { 2, 4, 8 };
+
+    char input[64];
+    char expected_hex[41];
+    unsigned char reference[20];
+    uint8_t digests[DUCO_SHA1_MB_MAX_LANES][20];
+    duco_sha1_job_t job;
+
+    for (size_t b = 0; b < sizeof(bases) / sizeof(bases[0]); b++) {
+        for (size_t n = 0; n < sizeof(lane_counts) / sizeof(lane_counts[0]); n++) {
+            unsigned lanes = lane_counts[n];
+            // Target the last lane so a match must come from the right position
+            uint32_t target_nonce = bases[b] + lanes - 1;
+
+            snprintf(input, sizeof(input), "%s%lu", prefix, (unsigned long)target_nonce);
+            mbedtls_sha1((const unsigned char *)input, strlen(input), reference);
+            digest_to_hex(reference, expected_hex);
+
+            if (!duco_sha1_mb_prepare(&job, prefix, strlen(prefix), expected_hex)) {
+                ESP_LOGE(TAG, "Kernel self-test: prepare failed");
+                return ESP_FAIL;
+            }
+
+            if (!duco_sha1_mb_digests(&job, bases[b], lanes, digests)) {
+                ESP_LOGE(TAG, "Kernel self-test: %u lanes unsupported", lanes);
+                return ESP_FAIL;
+            }
+            for (unsigned l = 0; l < lanes; l++) {
+                snprintf(input, sizeof(input), "%s%lu", prefix, (unsigned long)(bases[b] + l));
+                mbedtls_sha1((const unsigned char *)input, strlen(input), reference);
+                if (memcmp(reference, digests[l], 20) != 0) {
+                    ESP_LOGE(TAG, "Kernel self-test: lane %u/%u mismatch at nonce %lu",
+                             l, lanes, (unsigned long)(bases[b] + l));
+                    return ESP_FAIL;
+                }
+            }
+
+            uint32_t mask = duco_sha1_mb_search(&job, bases[b], lanes);
+            if (mask != (1u << (lanes - 1))) {
+                ESP_LOGE(TAG, "Kernel self-test: %u-lane search returned mask 0x%02lx",
+                         lanes, (unsigned long)mask);
+                return ESP_FAIL;
+            }
+        }
+    }
+
+    ESP_LOGI(TAG, "SHA-1 kernel self-test passed (%s, %d lanes)",
+             duco_sha1_mb_variant(), DUCO_SHA1_LANES);
+    return ESP_OK;
+}
+
 /**
- * @brief Connect to Duino-Coin server
+ * @brief Publish the rigs' tier selectors in the aggregate stats
+ *
+ * The tier is shared only while every rig agrees; timings are averaged over
+ * the rigs that have measured any.
  */
-static esp_err_t duco_connect(void)
+static void duco_tier_publish(void)
 {
-    const miner_config_t *config = config_get_current();
-    if (!config) {
-        ESP_LOGE(TAG, "Config not available");
-        return ESP_FAIL;
+    const duco_tier_selector_t *first = &conns[0].tier;
+    bool same = true;
+    float solve_ms = 0.0f, rtt_ms = 0.0f, reward = 0.0f;
+    int timed = 0, rewarded = 0;
+
+    for (int i = 0; i < rig_count; i++) {
+        const duco_tier_selector_t *sel = &conns[i].tier;
+        same &= sel->tier == first->tier;
+        if (sel->solve_ms + sel->rtt_ms > 0.0f) {
+            solve_ms += sel->solve_ms;
+            rtt_ms += sel->rtt_ms;
+            timed++;
+        }
+        if (sel->reward_per_share > 0.0f) {
+            reward += sel->reward_per_share;
+            rewarded++;
+        }
     }
 
-    ESP_LOGI(TAG, "Connecting to %s:%d...", config->duco_server, config->duco_port);
-    current_state = DUCO_STATE_CONNECTING;
+    strncpy(stats.difficulty_tier, same ? duco_tier_name(first) : "MIXED",
+            sizeof(stats.difficulty_tier) - 1);
+    strncpy(stats.tier_reason, same ? duco_tier_reason_str(first->reason) : "per rig",
+            sizeof(stats.tier_reason) - 1);
+    stats.tier_overridden = first->overridden;
+    stats.avg_solve_ms = timed > 0 ? solve_ms / timed : 0.0f;
+    stats.avg_rtt_ms = timed > 0 ? rtt_ms / timed : 0.0f;
+    stats.network_overhead_pct = solve_ms + rtt_ms > 0.0f ? 100.0f * rtt_ms / (solve_ms + rtt_ms) : 0.0f;
+    stats.reward_per_share = rewarded > 0 ? reward / rewarded : 0.0f;
+}
 
-    // Create socket
-    sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
-    if (sock < 0) {
-        ESP_LOGE(TAG, "Failed to create socket: errno %d", errno);
-        current_state = DUCO_STATE_ERROR;
-        return ESP_FAIL;
+/**
+ * @brief Feed job metrics to a rig's tier selector and publish them in stats
+ */
+static void duco_tier_update(duco_conn_t *c, int64_t solve_us, int64_t rtt_us, uint32_t hashes,
+                             bool accepted, float reward)
+{
+    duco_tier_selector_t *sel = &c->tier;
+    const char *previous = duco_tier_name(sel);
+
+    if (duco_tier_record(sel, (uint32_t)solve_us, (uint32_t)rtt_us, hashes, accepted, reward)) {
+        ESP_LOGI(TAG, "[%u] Difficulty tier %s -> %s (%s, solve %.0f ms, rtt %.0f ms, %.0f H/s)",
+                 c->index, previous, duco_tier_name(sel), duco_tier_reason_str(sel->reason),
+                 sel->solve_ms, sel->rtt_ms, sel->hashrate);
+    }
+    duco_tier_publish();
+}
+
+/**
+ * @brief Publish retry queue counters in stats
+ */
+static void duco_share_queue_publish(void)
+{
+    uint32_t pending = 0;
+    uint32_t expired = 0;
+    for (int i = 0; i < rig_count; i++) {
+        pending += duco_share_queue_count(&conns[i].shares);
+        expired += conns[i].shares.expired;
     }
+    stats.shares_pending = pending;
+    stats.shares_expired = expired;
+}
 
-    // Set timeout
-    struct timeval timeout;
-    timeout.tv_sec = DUCO_CONNECT_TIMEOUT_MS / 1000;
-    timeout.tv_usec = (DUCO_CONNECT_TIMEOUT_MS % 1000) * 1000;
-    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+/**
+ * @brief Keep a found share in case the server re-issues its job
+ */
+static void duco_queue_share(duco_conn_t *c, const duco_result_t *result, uint8_t attempts)
+{
+    duco_pending_share_t pending = {
+        .nonce = result->nonce,
+        .hashrate = hashrate_meter_reported(&meters[result->job.conn]),
+        .found_us = esp_timer_get_time(),
+        .attempts = attempts,
+    };
+    strncpy(pending.last_hash, result->job.last_hash, sizeof(pending.last_hash) - 1);
+    strncpy(pending.expected_hash, result->job.expected_hash, sizeof(pending.expected_hash) - 1);
+    duco_share_queue_push(&c->shares, &pending);
+    duco_share_queue_publish();
+    ESP_LOGW(TAG, "[%u] Share queued for retry (%u pending)", c->index,
+             (unsigned)duco_share_queue_count(&c->shares));
+}
 
-    // Resolve hostname
-    struct hostent *host = gethostbyname(config->duco_server);
-    if (host == NULL) {
-        ESP_LOGE(TAG, "DNS lookup failed for %s", config->duco_server);
-        close(sock);
-        sock = -1;
-        current_state = DUCO_STATE_ERROR;
-        return ESP_FAIL;
+/**
+ * @brief Close a connection and schedule the reconnect
+ */
+static void conn_close(duco_conn_t *c, const char *reason)
+{
+    if (c->sock >= 0) {
+        close(c->sock);
+        c->sock = -1;
+        c->reconnects++;
+        ESP_LOGW(TAG, "[%u] Disconnected: %s", c->index, reason);
     }
 
-    // Connect
-    struct sockaddr_in dest_addr;
-    dest_addr.sin_family = AF_INET;
-    dest_addr.sin_port = htons(config->duco_port);
-    dest_addr.sin_addr.s_addr = *(uint32_t *)host->h_addr;
+    // The pool may have moved - look it up again before the next attempt
+    if (c->state == CONN_CONNECTING) {
+        pool_addr = 0;
+    }
 
-    int err = connect(sock, (struct sockaddr *)&dest_addr, sizeof(dest_addr));
-    if (err != 0) {
-        ESP_LOGE(TAG, "Socket connect failed: errno %d", errno);
-        close(sock);
-        sock = -1;
-        current_state = DUCO_STATE_ERROR;
-        return ESP_FAIL;
+    // A share in flight may still be recovered if its job is re-issued;
+    // it keeps its attempt count so DUCO_SHARE_MAX_ATTEMPTS bounds the retries
+    if (c->state == CONN_WAIT_RESULT) {
+        duco_queue_share(c, &c->submitted, c->submitted_attempts);
     }
 
-    ESP_LOGI(TAG, "Connected to Duino-Coin server");
-    current_state = DUCO_STATE_CONNECTED;
+    // Anything the worker still holds for this connection is now stale
+    c->generation++;
+    duco_worker_set_generation(c->worker, c->generation);
+
+    c->state = CONN_DISCONNECTED;
+    c->rx_len = 0;
+    c->deadline_us = 0;
 
-    // Read server version
-    char buffer[DUCO_BUFFER_SIZE];
-    int len = recv(sock, buffer, sizeof(buffer) - 1, 0);
-    if (len > 0) {
-        buffer[len] = '\0';
-        // Remove newline
-        char *newline = strchr(buffer, '\n');
-        if (newline) *newline = '\0';
-        ESP_LOGI(TAG, "Server version: %s", buffer);
+    // Reconnect quickly while a queued share can still be recovered
+    uint32_t delay_ms = c->backoff_ms;
+    if (duco_share_queue_count(&c->shares) > 0) {
+        delay_ms = DUCO_RETRY_RECONNECT_MS;
     }
+    c->next_attempt_us = esp_timer_get_time() + (int64_t)delay_ms * 1000;
+    c->backoff_ms = c->backoff_ms * 2 > DUCO_BACKOFF_MAX_MS ? DUCO_BACKOFF_MAX_MS : c->backoff_ms * 2;
+}
 
-    return ESP_OK;
+/**
+ * @brief Send a complete line or fail
+ */
+static bool conn_send_line(duco_conn_t *c, const char *line)
+{
+    size_t len = strlen(line);
+    int sent = send(c->sock, line, len, 0);
+    return sent == (int)len;
 }
 
 /**
- * @brief Disconnect from server
+ * @brief Load the pool address cached for the configured server name
  */
-static void duco_disconnect(void)
+static uint32_t duco_pool_addr_load(const miner_config_t *config)
 {
-    if (sock >= 0) {
-        close(sock);
-        sock = -1;
-        ESP_LOGI(TAG, "Disconnected from server");
+    nvs_handle_t nvs_handle;
+    if (nvs_open(DUCO_NVS_NAMESPACE, NVS_READONLY, &nvs_handle) != ESP_OK) {
+        return 0;
     }
-    current_state = DUCO_STATE_IDLE;
+
+    char host[sizeof(config->duco_server)];
+    size_t len = sizeof(host);
+    uint32_t addr = 0;
+    if (nvs_get_str(nvs_handle, DUCO_NVS_POOL_HOST, host, &len) != ESP_OK ||
+        strcmp(host, config->duco_server) != 0 ||
+        nvs_get_u32(nvs_handle, DUCO_NVS_POOL_ADDR, &addr) != ESP_OK) {
+        addr = 0;
+    }
+    nvs_close(nvs_handle);
+    return addr;
 }
 
 /**
- * @brief Mine a single job
+ * @brief Persist a freshly resolved pool address (only when it changed)
  */
-static esp_err_t duco_mine_job(void)
+static void duco_pool_addr_save(const miner_config_t *config, uint32_t addr)
+{
+    if (addr == duco_pool_addr_load(config)) {
+        return;
+    }
+
+    nvs_handle_t nvs_handle;
+    if (nvs_open(DUCO_NVS_NAMESPACE, NVS_READWRITE, &nvs_handle) != ESP_OK) {
+        return;
+    }
+    esp_err_t ret = nvs_set_str(nvs_handle, DUCO_NVS_POOL_HOST, config->duco_server);
+    if (ret == ESP_OK) {
+        ret = nvs_set_u32(nvs_handle, DUCO_NVS_POOL_ADDR, addr);
+    }
+    if (ret == ESP_OK) {
+        ret = nvs_commit(nvs_handle);
+    }
+    nvs_close(nvs_handle);
+
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to cache pool address: %s", esp_err_to_name(ret));
+    }
+}
+
+/**
+ * @brief Begin a non-blocking connect to the configured server
+ */
+static void conn_start(duco_conn_t *c)
 {
     const miner_config_t *config = config_get_current();
-    if (!config) return ESP_FAIL;
+    if (!config) {
+        ESP_LOGE(TAG, "Config not available");
+        conn_close(c, "no config");
+        return;
+    }
+
+    ESP_LOGI(TAG, "[%u] Connecting to %s:%d...", c->index, config->duco_server, config->duco_port);
 
-    char buffer[DUCO_BUFFER_SIZE];
-    int len;
+    // Resolve hostname unless already known (blocks this task only)
+    if (pool_addr == 0) {
+        struct hostent *host = gethostbyname(config->duco_server);
+        if (host == NULL) {
+            ESP_LOGE(TAG, "DNS lookup failed for %s", config->duco_server);
+            conn_close(c, "DNS lookup failed");
+            return;
+        }
+        pool_addr = *(uint32_t *)host->h_addr;
+        duco_pool_addr_save(config, pool_addr);
+    }
+    boot_metrics_mark(BOOT_STAGE_DNS);
+
+    c->sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (c->sock < 0) {
+        ESP_LOGE(TAG, "Failed to create socket: errno %d", errno);
+        conn_close(c, "socket failed");
+        return;
+    }
+
+    fcntl(c->sock, F_SETFL, fcntl(c->sock, F_GETFL, 0) | O_NONBLOCK);
+
+    // TCP keepalive detects a dead server while a long job is being hashed
+    int keepalive = 1;
+    int idle = DUCO_KEEPALIVE_IDLE_S;
+    int interval = DUCO_KEEPALIVE_INTERVAL_S;
+    int count = DUCO_KEEPALIVE_COUNT;
+    setsockopt(c->sock, SOL_SOCKET, SO_KEEPALIVE, &keepalive, sizeof(keepalive));
+    setsockopt(c->sock, IPPROTO_TCP, TCP_KEEPIDLE, &idle, sizeof(idle));
+    setsockopt(c->sock, IPPROTO_TCP, TCP_KEEPINTVL, &interval, sizeof(interval));
+    setsockopt(c->sock, IPPROTO_TCP, TCP_KEEPCNT, &count, sizeof(count));
+
+    struct sockaddr_in dest_addr = {0};
+    dest_addr.sin_family = AF_INET;
+    dest_addr.sin_port = htons(config->duco_port);
+    dest_addr.sin_addr.s_addr = pool_addr;
+
+    int err = connect(c->sock, (struct sockaddr *)&dest_addr, sizeof(dest_addr));
+    if (err != 0 && errno != EINPROGRESS) {
+        ESP_LOGE(TAG, "Socket connect failed: errno %d", errno);
+        conn_close(c, "connect failed");
+        return;
+    }
+
+    c->state = CONN_CONNECTING;
+    c->deadline_us = esp_timer_get_time() + (int64_t)DUCO_CONNECT_TIMEOUT_MS * 1000;
+}
+
+/**
+ * @brief Send a JOB request
+ */
+static void conn_request_job(duco_conn_t *c)
+{
+    const miner_config_t *config = config_get_current();
+    if (!config) {
+        conn_close(c, "no config");
+        return;
+    }
 
-    // Request job
+    char *line = block_pool_alloc(&line_pool);
+    if (!line) {
+        conn_close(c, "out of line buffers");
+        return;
+    }
     const char *mining_key = strlen(config->duco_mining_key) > 0 ? config->duco_mining_key : "";
-    snprintf(buffer, sizeof(buffer), "JOB,%s,%s,%s\n",
-             config->duco_username, DUCO_DIFFICULTY, mining_key);
+    snprintf(line, DUCO_BUFFER_SIZE, "JOB,%s,%s,%s\n",
+             config->duco_username, duco_tier_name(&c->tier), mining_key);
 
-    if (send(sock, buffer, strlen(buffer), 0) < 0) {
+    bool sent = conn_send_line(c, line);
+    block_pool_free(&line_pool, line);
+    if (!sent) {
         ESP_LOGE(TAG, "Failed to send job request");
-        return ESP_FAIL;
+        conn_close(c, "send failed");
+        return;
     }
 
-    // Receive job
-    len = recv(sock, buffer, sizeof(buffer) - 1, 0);
-    if (len <= 0) {
-        ESP_LOGE(TAG, "Failed to receive job");
-        return ESP_FAIL;
+    c->state = CONN_WAIT_JOB;
+    c->request_us = esp_timer_get_time();
+    c->deadline_us = c->request_us + (int64_t)DUCO_READ_TIMEOUT_MS * 1000;
+}
+
+/**
+ * @brief Submit a share
+ */
+static void conn_submit(duco_conn_t *c, const duco_result_t *result, float hashrate,
+                        bool recovered, uint8_t attempt)
+{
+    c->submitted = *result;
+    c->submitted_recovered = recovered;
+    c->submitted_attempts = attempt;
+    c->state = CONN_WAIT_RESULT;
+
+    char *line = block_pool_alloc(&line_pool);
+    if (!line) {
+        conn_close(c, "out of line buffers");
+        return;
     }
-    buffer[len] = '\0';
+    snprintf(line, DUCO_BUFFER_SIZE, "%u,%.2f,%s,%s\n",
+             (unsigned)result->nonce, hashrate, DUCO_MINER_NAME, c->rig_id);
+
+    bool sent = conn_send_line(c, line);
+    block_pool_free(&line_pool, line);
+    if (!sent) {
+        ESP_LOGE(TAG, "Failed to send result");
+        conn_close(c, "send failed");
+        return;
+    }
+
+    c->request_us = esp_timer_get_time();
+    c->deadline_us = c->request_us + (int64_t)DUCO_READ_TIMEOUT_MS * 1000;
+}
+
+/**
+ * @brief Handle a job line: resubmit a queued share or hand it to the worker
+ */
+static void conn_on_job(duco_conn_t *c, char *line)
+{
+    c->job_rtt_us = esp_timer_get_time() - c->request_us;
+    boot_metrics_mark(BOOT_STAGE_FIRST_JOB);
 
     // Parse job: "last_hash,expected_hash,difficulty"
-    char *last_hash = strtok(buffer, ",");
+    char *last_hash = strtok(line, ",");
     char *expected_hash = strtok(NULL, ",");
     char *diff_str = strtok(NULL, ",\n");
 
     if (!last_hash || !expected_hash || !diff_str) {
         ESP_LOGE(TAG, "Invalid job format");
-        return ESP_FAIL;
+        conn_close(c, "invalid job");
+        return;
+    }
+
+    duco_job_t job = {
+        .id = {
+            .difficulty = atoi(diff_str),
+            .generation = c->generation,
+            .conn = c->index,
+        },
+    };
+    strncpy(job.id.last_hash, last_hash, sizeof(job.id.last_hash) - 1);
+    strncpy(job.id.expected_hash, expected_hash, sizeof(job.id.expected_hash) - 1);
+    stats.current_difficulty = job.id.difficulty;
+    c->difficulty = job.id.difficulty;
+
+    DLOG_I(TAG, "[%u] Job received - Difficulty: %lu", c->index, (unsigned long)job.id.difficulty);
+    ESP_LOGD(TAG, "Last hash: %.20s...", job.id.last_hash);
+    ESP_LOGD(TAG, "Expected: %.20s...", job.id.expected_hash);
+
+    // The chain has moved on or the share is too old - it can never be accepted
+    uint32_t expired = duco_share_queue_expire(&c->shares, job.id.last_hash,
+                                               esp_timer_get_time(),
+                                               (int64_t)DUCO_SHARE_MAX_AGE_MS * 1000);
+    if (expired > 0) {
+        ESP_LOGW(TAG, "[%u] %lu queued share(s) expired", c->index, (unsigned long)expired);
+    }
+
+    // Already solved this job before losing a connection?
+    duco_pending_share_t pending;
+    if (duco_share_queue_take(&c->shares, job.id.last_hash, job.id.expected_hash, &pending)) {
+        ESP_LOGI(TAG, "Job re-issued - resubmitting queued share (nonce %lu, attempt %u)",
+                 (unsigned long)pending.nonce, pending.attempts + 1);
+        duco_result_t result = {
+            .job = job.id,
+            .found = true,
+            .nonce = pending.nonce,
+        };
+        duco_share_queue_publish();
+        conn_submit(c, &result, pending.hashrate, true, pending.attempts + 1);
+        return;
+    }
+    duco_share_queue_publish();
+
+    // Preparse once here so the worker starts hashing immediately
+    if (!duco_sha1_mb_prepare(&job.sha1, job.id.last_hash, strlen(job.id.last_hash),
+                              job.id.expected_hash)) {
+        ESP_LOGE(TAG, "Invalid job hashes");
+        conn_close(c, "invalid job");
+        return;
+    }
+    job.nonce_start = 0;
+    job.nonce_end = job.id.difficulty * 100 + 1;
+
+    if (!duco_worker_submit(c->worker, &job)) {
+        ESP_LOGE(TAG, "Worker %u busy - dropping job", c->worker->index);
+        conn_close(c, "worker busy");
+        return;
+    }
+
+    c->state = CONN_HASHING;
+    c->deadline_us = 0;
+}
+
+/**
+ * @brief Add one job fetch + submit round trip to the rig's histogram
+ */
+static void conn_record_rtt(duco_conn_t *c, float rtt_ms)
+{
+    int bucket = 0;
+    while (bucket < DUCO_RTT_BUCKETS - 1 && rtt_ms > duco_rtt_bounds_ms[bucket]) {
+        bucket++;
+    }
+    c->rtt_hist[bucket]++;
+    c->rtt_sum_ms += rtt_ms;
+}
+
+/**
+ * @brief Handle a GOOD/BAD response
+ */
+static void conn_on_response(duco_conn_t *c, char *line)
+{
+    int64_t submit_rtt_us = esp_timer_get_time() - c->request_us;
+    bool accepted = false;
+    float share_value = 0.0f;
+
+    // Parse response
+    if (strncmp(line, "GOOD", 4) == 0) {
+        stats.shares_accepted++;
+        c->accepted++;
+        accepted = true;
+        boot_metrics_mark(BOOT_STAGE_FIRST_SHARE);
+
+        // Try to parse share value (DUCO earned)
+        char *comma = strchr(line, ',');
+        if (comma) {
+            share_value = atof(comma + 1);
+            stats.duco_earned_today += share_value;
+            stats.duco_earned_total += share_value;
+
+            // Once per share, so not worth deferring; dlog would narrow the double total to float
+            ESP_LOGI(TAG, "[%u] ✓ GOOD! Earned: %.8f DUCO (Total: %.8f)",
+                     c->index, share_value, stats.duco_earned_total);
+        } else {
+            DLOG_I(TAG, "[%u] ✓ GOOD! Share accepted", c->index);
+        }
+
+        strncpy(stats.last_message, "GOOD - Share accepted", sizeof(stats.last_message) - 1);
+    } else if (strncmp(line, "BAD", 3) == 0) {
+        stats.shares_rejected++;
+        c->rejected++;
+        DLOG_W(TAG, "[%u] ✗ BAD! Share rejected", c->index);
+        strncpy(stats.last_message, "BAD - Share rejected", sizeof(stats.last_message) - 1);
+    } else {
+        ESP_LOGW(TAG, "Unknown response: %s", line);
+    }
+
+    // Recorder mode: accepted shares are known-good replay data
+    if (accepted && duco_corpus_enabled()) {
+        duco_corpus_record(c->submitted.job.last_hash, c->submitted.job.expected_hash,
+                           c->submitted.job.difficulty, c->submitted.nonce,
+                           c->submitted.solve_us);
+    }
+
+    if (c->submitted_recovered) {
+        if (accepted) {
+            stats.shares_recovered++;
+        }
+    } else {
+        int64_t rtt_us = c->job_rtt_us + submit_rtt_us;
+        c->last_rtt_ms = rtt_us / 1000.0f;
+        c->avg_rtt_ms = c->avg_rtt_ms == 0.0f ? c->last_rtt_ms
+                                              : c->avg_rtt_ms * 0.8f + c->last_rtt_ms * 0.2f;
+        conn_record_rtt(c, c->last_rtt_ms);
+        duco_tier_update(c, c->submitted.solve_us, rtt_us, c->submitted.hashes, accepted, share_value);
     }
 
-    uint32_t difficulty = atoi(diff_str);
-    stats.current_difficulty = difficulty;
+    // A full round trip worked - reset reconnect backoff
+    c->backoff_ms = DUCO_BACKOFF_MIN_MS;
+    conn_request_job(c);
+}
+
+/**
+ * @brief Dispatch one complete message according to connection state
+ */
+static void conn_on_line(duco_conn_t *c, char *line)
+{
+    char *newline = strchr(line, '\n');
+    if (newline) *newline = '\0';
+
+    switch (c->state) {
+        case CONN_WAIT_VERSION:
+            ESP_LOGI(TAG, "[%u] Server version: %s", c->index, line);
+            conn_request_job(c);
+            break;
+        case CONN_WAIT_JOB:
+            conn_on_job(c, line);
+            break;
+        case CONN_WAIT_RESULT:
+            conn_on_response(c, line);
+            break;
+        default:
+            ESP_LOGW(TAG, "[%u] Unexpected data: %s", c->index, line);
+            break;
+    }
+}
+
+/**
+ * @brief Take the first len bytes of the receive buffer as one message
+ */
+static void conn_dispatch_rx(duco_conn_t *c, size_t len)
+{
+    char *line = block_pool_alloc(&line_pool);
+    if (!line) {
+        conn_close(c, "out of line buffers");
+        return;
+    }
 
-    ESP_LOGI(TAG, "Job received - Difficulty: %lu", (unsigned long)difficulty);
-    ESP_LOGD(TAG, "Last hash: %.20s...", last_hash);
-    ESP_LOGD(TAG, "Expected: %.20s...", expected_hash);
+    memcpy(line, c->rx, len);
+    line[len] = '\0';
+    memmove(c->rx, c->rx + len, c->rx_len - len + 1);
+    c->rx_len -= len;
 
-    // Mine: find nonce where SHA1(last_hash + nonce) == expected_hash
-    int64_t start_time = esp_timer_get_time();
-    char hash_input[256];
-    char hash_output[41];
-    uint32_t nonce = 0;
+    conn_on_line(c, line);
+    block_pool_free(&line_pool, line);
+}
 
-    for (nonce = 0; nonce < difficulty * 100 + 1; nonce++) {
-        // Check for stop request
-        if (stop_requested) {
-            return ESP_ERR_INVALID_STATE;
+/**
+ * @brief Read whatever is available and process complete lines
+ */
+static void conn_read(duco_conn_t *c)
+{
+    int len = recv(c->sock, c->rx + c->rx_len, sizeof(c->rx) - 1 - c->rx_len, 0);
+    if (len == 0) {
+        conn_close(c, "closed by server");
+        return;
+    }
+    if (len < 0) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            conn_close(c, "recv failed");
         }
+        return;
+    }
 
-        // Create hash input: last_hash + nonce
-        snprintf(hash_input, sizeof(hash_input), "%s%u", last_hash, nonce);
+    c->rx_len += len;
+    c->rx[c->rx_len] = '\0';
+    c->rx_last_us = esp_timer_get_time();
 
-        // Calculate SHA1
-        sha1_hash(hash_input, hash_output);
+    char *newline;
+    while (c->sock >= 0 && (newline = strchr(c->rx, '\n')) != NULL) {
+        conn_dispatch_rx(c, newline - c->rx + 1);
+    }
 
-        // Count hash
-        total_hashes++;
+    // Buffer full without a newline - treat it as one message
+    if (c->sock >= 0 && c->rx_len >= sizeof(c->rx) - 1) {
+        conn_dispatch_rx(c, c->rx_len);
+    }
+}
 
-        // Check if it matches
-        if (strcmp(hash_output, expected_hash) == 0) {
-            // Found it!
-            int64_t end_time = esp_timer_get_time();
-            float duration_sec = (end_time - start_time) / 1000000.0f;
-            float hashrate = nonce / duration_sec;
+/**
+ * @brief Time-driven transitions: reconnects, timeouts, unterminated messages
+ */
+static void conn_service(duco_conn_t *c, int64_t now)
+{
+    if (c->state == CONN_DISCONNECTED) {
+        if (now >= c->next_attempt_us) {
+            conn_start(c);
+        }
+        return;
+    }
 
-            stats.current_hashrate = hashrate;
+    // Some server messages (e.g. the version banner) have no newline
+    if (c->rx_len > 0 && now - c->rx_last_us > (int64_t)DUCO_LINE_IDLE_MS * 1000) {
+        conn_dispatch_rx(c, c->rx_len);
+        return;
+    }
 
-            ESP_LOGI(TAG, "Share found! Nonce: %lu, Hashrate: %.2f H/s",
-                     (unsigned long)nonce, hashrate);
+    if (c->deadline_us != 0 && now > c->deadline_us) {
+        conn_close(c, "timeout");
+    }
+}
 
-            // Submit result
-            snprintf(buffer, sizeof(buffer), "%u,%.2f,%s,%s\n",
-                     nonce, hashrate, DUCO_MINER_NAME, "");
+/**
+ * @brief Handle a worker's result for a connection
+ */
+static void conn_on_result(duco_conn_t *c, const duco_result_t *result)
+{
+    // Connection dropped while the job was being hashed
+    if (result->job.generation != c->generation || c->state != CONN_HASHING) {
+        if (result->found) {
+            duco_queue_share(c, result, 0);
+        }
+        return;
+    }
 
-            if (send(sock, buffer, strlen(buffer), 0) < 0) {
-                ESP_LOGE(TAG, "Failed to send result");
-                return ESP_FAIL;
-            }
+    if (!result->found) {
+        // Server is waiting for an answer we do not have - start over
+        conn_close(c, "nonce not found");
+        return;
+    }
 
-            // Receive response: "GOOD" or "BAD" + optional share value
-            len = recv(sock, buffer, sizeof(buffer) - 1, 0);
-            if (len <= 0) {
-                ESP_LOGE(TAG, "Failed to receive response");
-                return ESP_FAIL;
-            }
-            buffer[len] = '\0';
-
-            // Remove newline
-            char *newline = strchr(buffer, '\n');
-            if (newline) *newline = '\0';
-
-            // Parse response
-            if (strncmp(buffer, "GOOD", 4) == 0) {
-                stats.shares_accepted++;
-
-                // Try to parse share value (DUCO earned)
-                char *comma = strchr(buffer, ',');
-                if (comma) {
-                    float share_value = atof(comma + 1);
-                    stats.duco_earned_today += share_value;
-                    stats.duco_earned_total += share_value;
-
-                    ESP_LOGI(TAG, "✓ GOOD! Earned: %.8f DUCO (Total: %.8f)",
-                             share_value, stats.duco_earned_total);
-                } else {
-                    ESP_LOGI(TAG, "✓ GOOD! Share accepted");
-                }
+    // Report the windowed rate; per-job estimate only until the meter has data
+    float hashrate = hashrate_meter_reported(c->meter);
+    if (hashrate <= 0.0f && result->solve_us > 0) {
+        hashrate = result->hashes / (result->solve_us / 1000000.0f);
+    }
 
-                strncpy(stats.last_message, "GOOD - Share accepted", sizeof(stats.last_message) - 1);
-            } else if (strncmp(buffer, "BAD", 3) == 0) {
-                stats.shares_rejected++;
-                ESP_LOGW(TAG, "✗ BAD! Share rejected");
-                strncpy(stats.last_message, "BAD - Share rejected", sizeof(stats.last_message) - 1);
-            } else {
-                ESP_LOGW(TAG, "Unknown response: %s", buffer);
-            }
+    DLOG_I(TAG, "[%u] Share found! Nonce: %lu, Hashrate: %.2f H/s",
+           c->index, (unsigned long)result->nonce, hashrate);
+    conn_submit(c, result, hashrate, false, 1);
+}
 
-            return ESP_OK;
+/**
+ * @brief Map connection states to the public miner state
+ */
+static duco_state_t conn_public_state(const duco_conn_t *c)
+{
+    switch (c->state) {
+        case CONN_CONNECTING:
+        case CONN_WAIT_VERSION:
+            return DUCO_STATE_CONNECTING;
+        case CONN_WAIT_JOB:
+            return DUCO_STATE_CONNECTED;
+        case CONN_HASHING:
+        case CONN_WAIT_RESULT:
+            return DUCO_STATE_MINING;
+        default:
+            return c->backoff_ms > DUCO_BACKOFF_MIN_MS ? DUCO_STATE_ERROR : DUCO_STATE_IDLE;
+    }
+}
+
+/**
+ * @brief Refresh time-based stats, per rig and in aggregate
+ */
+static void duco_update_stats(int64_t now)
+{
+    stats.uptime_seconds = (now - mining_start_time) / 1000000;
+
+    // Hashrates come from the windowed meters, not per-job estimates
+    hashrate_snapshot_t total = {0};
+    duco_state_t state = DUCO_STATE_IDLE;
+    stats.jobs_stale_dropped = 0;
+    stats.rig_count = rig_count;
+
+    for (int i = 0; i < rig_count; i++) {
+        const duco_conn_t *c = &conns[i];
+        duco_rig_stats_t *rig = &stats.rigs[i];
+        hashrate_snapshot_t snap;
+        hashrate_meter_get(&meters[i], &snap);
+
+        total.wall_10s += snap.wall_10s;
+        total.wall_1m += snap.wall_1m;
+        total.wall_15m += snap.wall_15m;
+        total.hashing_10s += snap.hashing_10s;
+        total.hashing_1m += snap.hashing_1m;
+        total.hashing_15m += snap.hashing_15m;
+        total.duty_pct += snap.duty_pct / rig_count;
+        total.total_hashes += snap.total_hashes;
+
+        strncpy(rig->rig_id, c->rig_id, sizeof(rig->rig_id) - 1);
+        rig->state = conn_public_state(c);
+        rig->hashrate = snap.hashing_10s;
+        rig->wall_hashrate = snap.wall_1m;
+        rig->shares_accepted = c->accepted;
+        rig->shares_rejected = c->rejected;
+        rig->current_difficulty = c->difficulty;
+        strncpy(rig->difficulty_tier, duco_tier_name(&c->tier), sizeof(rig->difficulty_tier) - 1);
+        strncpy(rig->tier_reason, duco_tier_reason_str(c->tier.reason), sizeof(rig->tier_reason) - 1);
+        rig->avg_solve_ms = c->tier.solve_ms;
+        rig->last_rtt_ms = c->last_rtt_ms;
+        rig->avg_rtt_ms = c->avg_rtt_ms;
+        memcpy(rig->rtt_hist, c->rtt_hist, sizeof(rig->rtt_hist));
+        rig->rtt_sum_ms = c->rtt_sum_ms;
+        rig->reconnects = c->reconnects;
+
+        const duco_worker_t *w = &workers[i];
+        rig->slice_avg_us = w->slice.avg_us;
+        rig->slice_max_us = w->slice.max_us;
+        rig->slice_overruns = w->slice.overruns;
+        rig->preemptions = w->preemptions;
+        rig->preempt_last_us = w->preempt_last_us;
+        rig->preempt_max_us = w->preempt_max_us;
+
+        // The board is mining if any rig is; otherwise report the most advanced state
+        if (rig->state == DUCO_STATE_MINING || (state != DUCO_STATE_MINING && rig->state > state)) {
+            state = rig->state;
         }
+        stats.jobs_stale_dropped += workers[i].stale_dropped;
+    }
+
+    stats.hashrate = total;
+    stats.current_hashrate = total.hashing_10s;
+    stats.avg_hashrate = total.wall_15m;
+    stats.boot_to_first_hash_ms = boot_metrics_get(BOOT_STAGE_FIRST_HASH);
+    stats.boot_to_first_share_ms = boot_metrics_get(BOOT_STAGE_FIRST_SHARE);
 
-        // Yield every 1000 hashes to not block other tasks
-        if (nonce % 1000 == 0) {
-            taskYIELD();
+    current_state = state;
+    stats.state = current_state;
+}
+
+/**
+ * @brief React to the network link going down or coming back
+ */
+static void duco_link_changed(bool up, int64_t now)
+{
+    if (!up) {
+        ESP_LOGW(TAG, "Network link down - pausing");
+        for (int i = 0; i < rig_count; i++) {
+            if (conns[i].state != CONN_DISCONNECTED) {
+                conn_close(&conns[i], "link down");
+            }
         }
+        return;
     }
 
-    ESP_LOGW(TAG, "Failed to find nonce within difficulty range");
-    return ESP_FAIL;
+    ESP_LOGI(TAG, "Network link up - reconnecting");
+    for (int i = 0; i < rig_count; i++) {
+        conns[i].backoff_ms = DUCO_BACKOFF_MIN_MS;
+        conns[i].next_attempt_us = now;
+    }
 }
 
 /**
- * @brief Mining task
+ * @brief Network task - owns every socket, never hashes
  */
-static void duco_mining_task(void *param)
+static void duco_net_task(void *param)
 {
-    ESP_LOGI(TAG, "Mining task started");
+    ESP_LOGI(TAG, "Network task started");
     mining_start_time = esp_timer_get_time();
+    int64_t last_stats = 0;
+    bool link_was_up = link_up;
 
     while (!stop_requested) {
-        // Connect if not connected
-        if (sock < 0) {
-            if (duco_connect() != ESP_OK) {
-                ESP_LOGE(TAG, "Connection failed, retrying in 10s...");
-                vTaskDelay(pdMS_TO_TICKS(10000));
-                continue;
-            }
+        int64_t now = esp_timer_get_time();
+
+        bool link = link_up;
+        if (link != link_was_up) {
+            link_was_up = link;
+            duco_link_changed(link, now);
         }
 
-        // Mine a job
-        current_state = DUCO_STATE_MINING;
-        esp_err_t ret = duco_mine_job();
+        // No point burning connect timeouts without a network
+        for (int i = 0; link && i < rig_count; i++) {
+            conn_service(&conns[i], now);
+        }
 
-        if (ret != ESP_OK && ret != ESP_ERR_INVALID_STATE) {
-            ESP_LOGW(TAG, "Mining job failed, reconnecting...");
-            duco_disconnect();
-            vTaskDelay(pdMS_TO_TICKS(5000));
+        fd_set rfds, wfds;
+        FD_ZERO(&rfds);
+        FD_ZERO(&wfds);
+        int maxfd = -1;
+
+        for (int i = 0; i < rig_count; i++) {
+            duco_conn_t *c = &conns[i];
+            if (c->sock < 0) continue;
+            // Always watch for reads so a server close is noticed immediately
+            FD_SET(c->sock, &rfds);
+            if (c->state == CONN_CONNECTING) {
+                FD_SET(c->sock, &wfds);
+            }
+            if (c->sock > maxfd) maxfd = c->sock;
         }
 
-        // Update stats
-        int64_t now = esp_timer_get_time();
-        stats.uptime_seconds = (now - mining_start_time) / 1000000;
+        if (maxfd >= 0) {
+            struct timeval tv = { .tv_sec = 0, .tv_usec = DUCO_NET_POLL_MS * 1000 };
+            int ready = select(maxfd + 1, &rfds, &wfds, NULL, &tv);
+
+            for (int i = 0; ready > 0 && i < rig_count; i++) {
+                duco_conn_t *c = &conns[i];
+                if (c->sock < 0) continue;
+
+                if (c->state == CONN_CONNECTING && FD_ISSET(c->sock, &wfds)) {
+                    int err = 0;
+                    socklen_t err_len = sizeof(err);
+                    getsockopt(c->sock, SOL_SOCKET, SO_ERROR, &err, &err_len);
+                    if (err != 0) {
+                        ESP_LOGE(TAG, "Socket connect failed: errno %d", err);
+                        conn_close(c, "connect failed");
+                        continue;
+                    }
+                    ESP_LOGI(TAG, "[%u] Connected to Duino-Coin server", c->index);
+                    boot_metrics_mark(BOOT_STAGE_POOL_CONNECTED);
+                    c->state = CONN_WAIT_VERSION;
+                    c->deadline_us = esp_timer_get_time() + (int64_t)DUCO_READ_TIMEOUT_MS * 1000;
+                }
 
-        // Calculate average hashrate
-        if (stats.uptime_seconds > 0) {
-            stats.avg_hashrate = (float)total_hashes / (float)stats.uptime_seconds;
+                if (c->sock >= 0 && FD_ISSET(c->sock, &rfds)) {
+                    conn_read(c);
+                }
+            }
+        } else {
+            vTaskDelay(pdMS_TO_TICKS(DUCO_NET_POLL_MS));
         }
 
-        // Small delay between jobs
-        vTaskDelay(pdMS_TO_TICKS(100));
+        // Collect worker results
+        for (int i = 0; i < rig_count; i++) {
+            duco_result_t result;
+            while (duco_worker_poll(&workers[i], &result)) {
+                conn_on_result(&conns[result.job.conn], &result);
+            }
+        }
+
+        now = esp_timer_get_time();
+        if (now - last_stats >= 1000000) {
+            duco_update_stats(now);
+            last_stats = now;
+        }
     }
 
     // Cleanup
-    duco_disconnect();
-    ESP_LOGI(TAG, "Mining task stopped");
-    mining_task_handle = NULL;
+    for (int i = 0; i < rig_count; i++) {
+        conn_close(&conns[i], "stopping");
+    }
+    current_state = DUCO_STATE_IDLE;
+    ESP_LOGI(TAG, "Network task stopped");
+    mem_budget_unregister_task(NULL);
+    net_task_handle = NULL;
     vTaskDelete(NULL);
 }
 
+/**
+ * @brief Rig identifier for a rig index
+ *
+ * A comma-separated list names each rig; a single name is shared, with the
+ * rig number appended when more than one rig is running.
+ */
+static void duco_rig_id(const miner_config_t *config, int index, char *out, size_t out_len)
+{
+    const char *p = config->duco_rig_id;
+    for (int i = 0; i < index && p; i++) {
+        p = strchr(p, ',');
+        if (p) p++;
+    }
+
+    if (p && strchr(config->duco_rig_id, ',')) {
+        size_t len = strcspn(p, ",");
+        if (len >= out_len) len = out_len - 1;
+        memcpy(out, p, len);
+        out[len] = '\0';
+        if (len > 0) return;
+    }
+
+    // Single name (or list too short): base name, numbered in multi-rig mode
+    size_t base_len = strcspn(config->duco_rig_id, ",");
+    if (rig_count > 1) {
+        snprintf(out, out_len, "%.*s-%d", (int)base_len, config->duco_rig_id, index + 1);
+    } else {
+        snprintf(out, out_len, "%.*s", (int)base_len, config->duco_rig_id);
+    }
+}
+
 esp_err_t duco_miner_init(void)
 {
     ESP_LOGI(TAG, "Initializing Duino-Coin miner...");
@@ -351,74 +1070,175 @@ esp_err_t duco_miner_init(void)
         return ESP_FAIL;
     }
 
-    // Initialize stats
+    // Never mine with a kernel that disagrees with mbedtls
+    if (duco_miner_self_test() != ESP_OK) {
+        ESP_LOGE(TAG, "SHA-1 kernel self-test failed");
+        return ESP_FAIL;
+    }
+    boot_metrics_mark(BOOT_STAGE_SELF_TEST);
+
+    // A cached pool address lets the first connect skip DNS
+    pool_addr = duco_pool_addr_load(config);
+
+    // Initialize stats, continuing lifetime counters from the journal
     memset(&stats, 0, sizeof(stats));
     stats.state = DUCO_STATE_IDLE;
-    total_hashes = 0;
+    if (stats_journal_get_totals(&baseline) == ESP_OK) {
+        stats.duco_earned_total = baseline.duco_earned_total;
+        stats.shares_accepted = baseline.shares_accepted;
+        stats.shares_rejected = baseline.shares_rejected;
+        stats.shares_recovered = baseline.shares_recovered;
+    } else {
+        memset(&baseline, 0, sizeof(baseline));
+        ESP_LOGW(TAG, "Stats journal unavailable - counters start from zero");
+    }
+    for (int i = 0; i < DUCO_MAX_RIGS; i++) {
+        atomic_store(&workers[i].total_hashes, 0);
+    }
     stop_requested = false;
 
+    if (!line_pool_initialized) {
+        block_pool_init(&line_pool, "duco_line", line_pool_storage,
+                        DUCO_BUFFER_SIZE, DUCO_LINE_BUFFERS);
+        line_pool_initialized = true;
+    }
+
+    rig_count = config->duco_rig_count;
+    if (rig_count < 1 || rig_count > DUCO_MAX_RIGS) {
+        ESP_LOGW(TAG, "Invalid rig count %u, using 1", config->duco_rig_count);
+        rig_count = 1;
+    }
+
+    if (duco_corpus_init(rig_count) == ESP_OK) {
+        ESP_LOGI(TAG, "Recorder mode: accepted jobs are appended to the replay corpus");
+    }
+
+    while (meters_initialized < rig_count) {
+        char name[16];
+        snprintf(name, sizeof(name), "duco_rate%u", meters_initialized);
+        esp_err_t ret = hashrate_meter_init(&meters[meters_initialized], name, 1);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to start hashrate meter: %s", esp_err_to_name(ret));
+            return ret;
+        }
+        meters_initialized++;
+    }
+
+    // Difficulty tier (fixed by config, or adaptive); each rig starts its own selector here
+    duco_tier_selector_t initial;
+    if (!duco_tier_init(&initial, config->duco_difficulty)) {
+        ESP_LOGW(TAG, "Unknown difficulty tier '%s', using adaptive selection",
+                 config->duco_difficulty);
+    }
+    strncpy(stats.difficulty_tier, duco_tier_name(&initial), sizeof(stats.difficulty_tier) - 1);
+    strncpy(stats.tier_reason, duco_tier_reason_str(initial.reason), sizeof(stats.tier_reason) - 1);
+    stats.tier_overridden = initial.overridden;
+
     ESP_LOGI(TAG, "Duino-Coin miner initialized");
     ESP_LOGI(TAG, "Username: %s", config->duco_username);
     ESP_LOGI(TAG, "Server: %s:%d", config->duco_server, config->duco_port);
     ESP_LOGI(TAG, "Mining key: %s", strlen(config->duco_mining_key) > 0 ? "Set" : "Not set");
+    ESP_LOGI(TAG, "Difficulty tier: %s%s", stats.difficulty_tier,
+             initial.overridden ? " (fixed)" : " (adaptive)");
+    ESP_LOGI(TAG, "Rigs: %u", rig_count);
 
     return ESP_OK;
 }
 
 esp_err_t duco_miner_start(void)
 {
-    if (mining_task_handle != NULL) {
+    if (net_task_handle != NULL) {
         ESP_LOGW(TAG, "Miner already running");
         return ESP_OK;
     }
 
+    const miner_config_t *config = config_get_current();
+    if (!config) {
+        ESP_LOGE(TAG, "Config not available");
+        return ESP_FAIL;
+    }
+
     ESP_LOGI(TAG, "Starting Duino-Coin mining...");
     stop_requested = false;
 
-    // Create mining task
+    for (int i = 0; i < rig_count; i++) {
+        duco_worker_t *w = &workers[i];
+        uint64_t worker_hashes = atomic_load(&w->total_hashes);
+        duco_worker_init(w, i, &meters[i]);
+        atomic_store(&w->total_hashes, worker_hashes);
+
+        memset(&conns[i], 0, sizeof(conns[i]));
+        conns[i].index = i;
+        conns[i].sock = -1;
+        conns[i].backoff_ms = DUCO_BACKOFF_MIN_MS;
+        conns[i].worker = w;
+        conns[i].meter = &meters[i];
+        duco_share_queue_init(&conns[i].shares);
+        duco_tier_init(&conns[i].tier, config->duco_difficulty);
+        duco_rig_id(config, i, conns[i].rig_id, sizeof(conns[i].rig_id));
+        ESP_LOGI(TAG, "Rig %d: %s", i, conns[i].rig_id);
+
+        // Rig 0 owns core 1; rig 1 shares core 0 below the network task
+        BaseType_t core = i == 0 ? 1 : 0;
+        UBaseType_t priority = i == 0 ? 5 : 3;
+        if (duco_worker_start(w, core, priority) != ESP_OK) {
+            duco_miner_stop();
+            return ESP_FAIL;
+        }
+    }
+
+    // Network task on core 0, away from the hashing core
     BaseType_t ret = xTaskCreatePinnedToCore(
-        duco_mining_task,
-        "duco_miner",
-        8192,  // Stack size
+        duco_net_task,
+        "duco_net",
+        DUCO_NET_STACK_SIZE,
         NULL,
         5,     // Priority
-        &mining_task_handle,
-        1      // Core 1
+        &net_task_handle,
+        0      // Core 0
     );
 
     if (ret != pdPASS) {
-        ESP_LOGE(TAG, "Failed to create mining task");
+        ESP_LOGE(TAG, "Failed to create network task");
+        duco_miner_stop();
         return ESP_FAIL;
     }
+    mem_budget_register_task(net_task_handle, DUCO_NET_STACK_SIZE);
 
     ESP_LOGI(TAG, "Duino-Coin mining started");
+    boot_metrics_mark(BOOT_STAGE_MINER_STARTED);
     return ESP_OK;
 }
 
 esp_err_t duco_miner_stop(void)
 {
-    if (mining_task_handle == NULL) {
-        ESP_LOGW(TAG, "Miner not running");
-        return ESP_OK;
-    }
-
     ESP_LOGI(TAG, "Stopping Duino-Coin mining...");
     stop_requested = true;
 
-    // Wait for task to stop (max 5 seconds)
+    // Wait for network task to stop (max 5 seconds)
     int timeout = 50;
-    while (mining_task_handle != NULL && timeout > 0) {
+    while (net_task_handle != NULL && timeout > 0) {
         vTaskDelay(pdMS_TO_TICKS(100));
         timeout--;
     }
 
-    if (mining_task_handle != NULL) {
-        ESP_LOGW(TAG, "Force deleting mining task");
-        vTaskDelete(mining_task_handle);
-        mining_task_handle = NULL;
+    if (net_task_handle != NULL) {
+        ESP_LOGW(TAG, "Force deleting network task");
+        mem_budget_unregister_task(net_task_handle);
+        vTaskDelete(net_task_handle);
+        net_task_handle = NULL;
+        for (int i = 0; i < rig_count; i++) {
+            if (conns[i].sock >= 0) {
+                close(conns[i].sock);
+                conns[i].sock = -1;
+            }
+        }
+    }
+
+    for (int i = 0; i < rig_count; i++) {
+        duco_worker_stop(&workers[i], 5000);
     }
 
-    duco_disconnect();
     current_state = DUCO_STATE_IDLE;
 
     ESP_LOGI(TAG, "Duino-Coin mining stopped");
@@ -440,7 +1260,31 @@ esp_err_t duco_miner_get_stats(duco_stats_t *out_stats)
     return ESP_OK;
 }
 
+esp_err_t duco_miner_get_totals(stats_totals_t *totals)
+{
+    if (!totals) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    *totals = baseline;
+    totals->duco_earned_total = stats.duco_earned_total;
+    totals->shares_accepted = stats.shares_accepted;
+    totals->shares_rejected = stats.shares_rejected;
+    totals->shares_recovered = stats.shares_recovered;
+    totals->total_hashes = baseline.total_hashes;
+    for (int i = 0; i < DUCO_MAX_RIGS; i++) {
+        totals->total_hashes += atomic_load_explicit(&workers[i].total_hashes, memory_order_relaxed);
+    }
+    totals->mining_seconds = baseline.mining_seconds + stats.uptime_seconds;
+    return ESP_OK;
+}
+
 bool duco_miner_is_running(void)
 {
-    return mining_task_handle != NULL;
+    return net_task_handle != NULL;
+}
+
+void duco_miner_set_link(bool up)
+{
+    link_up = up;
 }
@@ -0,0 +1,92 @@
+/**
+ * DUCO-S1 Replay Corpus Recorder
+ *
+ * In recorder mode (DUCO_CORPUS_RECORD in config.h) every share the server
+ * accepted is appended to a flash region as a corpus record, giving a fixed
+ * set of real jobs with known-good nonces for tools/duco_replay.
+ *
+ * Corpus format (plain text, one record per line, shared with host tools):
+ *
+ *   # duco-corpus v1
+ *   # session boot=<n> rigs=<n> kernel=<variant> lanes=<n>
+ *   J,<last_hash>,<expected_hash>,<difficulty>,<nonce>,<device_solve_us>
+ *
+ * '#' lines are comments; a new session header starts every boot. The flash
+ * region is the corpus text followed by erased (0xFF) bytes, so a raw dump
+ * read with esptool is a valid corpus file once the padding is stripped.
+ *
+ * Formatting and parsing have no ESP-IDF dependencies (duco_corpus_format.c)
+ * so host tools share them; the recorder itself is device-only.
+ */
+
+#ifndef DUCO_CORPUS_H
+#define DUCO_CORPUS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#ifdef ESP_PLATFORM
+#include "esp_err.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DUCO_CORPUS_VERSION 1
+#define DUCO_CORPUS_MAX_LINE 128
+
+#ifdef ESP_PLATFORM
+/**
+ * @brief Open the corpus region and start a session
+ *
+ * Does nothing (returns ESP_ERR_NOT_SUPPORTED) unless recorder mode is on.
+ *
+ * @param rigs Number of rigs mining this session
+ * @return ESP_OK if recording, error code otherwise
+ */
+esp_err_t duco_corpus_init(uint8_t rigs);
+
+/**
+ * @brief Is the recorder active?
+ */
+bool duco_corpus_enabled(void);
+
+/**
+ * @brief Append one accepted job
+ *
+ * @param last_hash Job prefix (40 hex chars)
+ * @param expected_hash Job target (40 hex chars)
+ * @param difficulty Job difficulty
+ * @param nonce Accepted nonce
+ * @param solve_us Time the device needed to find it
+ * @return ESP_OK, or ESP_ERR_NO_MEM once the region is full
+ */
+esp_err_t duco_corpus_record(const char *last_hash, const char *expected_hash,
+                             uint32_t difficulty, uint32_t nonce, int64_t solve_us);
+#endif // ESP_PLATFORM
+
+/**
+ * @brief Format a corpus job record (no newline)
+ *
+ * @return Characters written, or -1 if buf is too small
+ */
+int duco_corpus_format(char *buf, size_t len, const char *last_hash, const char *expected_hash,
+                       uint32_t difficulty, uint32_t nonce, int64_t solve_us);
+
+/**
+ * @brief Parse a corpus job record
+ *
+ * @param line Record line (trailing newline allowed)
+ * @param last_hash Output, 41 bytes
+ * @param expected_hash Output, 41 bytes
+ * @return true if line is a valid job record, false for comments and garbage
+ */
+bool duco_corpus_parse(const char *line, char *last_hash, char *expected_hash,
+                       uint32_t *difficulty, uint32_t *nonce, int64_t *solve_us);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DUCO_CORPUS_H
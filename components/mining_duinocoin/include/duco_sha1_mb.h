@@ -0,0 +1,97 @@
+/**
+ * Multi-Buffer SHA-1 Kernel for DUCO-S1
+ *
+ * Hashes several consecutive nonces at once with their SHA-1 rounds
+ * interleaved, so the long dependency chain of one compression function no
+ * longer leaves execution units idle. DUCO-S1 input (40-char last_hash plus
+ * decimal nonce) always fits a single SHA-1 block; the rounds that only touch
+ * the constant prefix are precomputed once per job.
+ *
+ * Portable scalar code is used on the ESP32. Host builds use SSE2 (4 lanes)
+ * or AVX2 (8 lanes) when the compiler targets them. No ESP-IDF dependencies.
+ */
+
+#ifndef DUCO_SHA1_MB_H
+#define DUCO_SHA1_MB_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DUCO_SHA1_MB_MAX_LANES 8
+#define DUCO_SHA1_MB_MAX_PREFIX 45      // Prefix + 10 digits + padding must fit one block
+
+// Default lane count for the nonce search
+#ifndef DUCO_SHA1_LANES
+#if defined(__AVX2__)
+#define DUCO_SHA1_LANES 8
+#elif defined(__SSE2__)
+#define DUCO_SHA1_LANES 4
+#else
+#define DUCO_SHA1_LANES 2
+#endif
+#endif
+
+#if DUCO_SHA1_LANES != 2 && DUCO_SHA1_LANES != 4 && DUCO_SHA1_LANES != 8
+#error "DUCO_SHA1_LANES must be 2, 4 or 8"
+#endif
+
+// Per-job precomputed state
+typedef struct {
+    uint8_t block[64];          // Prefix bytes of the message block
+    uint8_t prefix_len;         // Length of last_hash
+    uint8_t fixed_words;        // Leading block words that never change
+    uint32_t words[16];         // Big-endian words of the prefix
+    uint32_t mid[5];            // State after the fixed_words rounds
+    uint32_t target[5];         // Expected digest
+} duco_sha1_job_t;
+
+/**
+ * @brief Precompute per-job state
+ *
+ * @param job Job state to fill
+ * @param prefix last_hash from the job line
+ * @param prefix_len Length of prefix (at most DUCO_SHA1_MB_MAX_PREFIX)
+ * @param expected_hex Expected digest as 40 hex characters
+ * @return true on success, false if the prefix is too long or the hex invalid
+ */
+bool duco_sha1_mb_prepare(duco_sha1_job_t *job, const char *prefix, size_t prefix_len,
+                          const char *expected_hex);
+
+/**
+ * @brief Hash nonces nonce_base .. nonce_base + lanes - 1
+ *
+ * @param job Prepared job
+ * @param nonce_base First nonce
+ * @param lanes Number of nonces (2, 4 or 8; anything else asserts)
+ * @return Bitmask of lanes whose digest equals the target (bit i = nonce_base + i),
+ *         0 for an unsupported lane count
+ */
+uint32_t duco_sha1_mb_search(const duco_sha1_job_t *job, uint32_t nonce_base, unsigned lanes);
+
+/**
+ * @brief Compute the digests of several lanes (for validation)
+ *
+ * @param job Prepared job
+ * @param nonce_base First nonce
+ * @param lanes Number of nonces (2, 4 or 8; anything else asserts)
+ * @param digests Output digests, one per lane
+ * @return false (nothing written) for an unsupported lane count
+ */
+bool duco_sha1_mb_digests(const duco_sha1_job_t *job, uint32_t nonce_base, unsigned lanes,
+                          uint8_t digests[][20]);
+
+/**
+ * @brief Name of the compiled kernel variant ("scalar", "sse2" or "avx2")
+ */
+const char *duco_sha1_mb_variant(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DUCO_SHA1_MB_H
@@ -0,0 +1,95 @@
+/**
+ * DUCO Share Retry Queue
+ *
+ * Bounded queue of found-but-unacknowledged shares. DUCO results can only be
+ * submitted against the job the server issued on the same connection, but
+ * the server serves jobs from a short-lived cache, so after a reconnect the
+ * same job is often issued again. Queued shares are resubmitted instantly
+ * when that happens, and expired once the job can no longer come back.
+ */
+
+#ifndef DUCO_SHARE_QUEUE_H
+#define DUCO_SHARE_QUEUE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DUCO_SHARE_QUEUE_LEN 8
+#define DUCO_SHARE_MAX_ATTEMPTS 3
+
+// A found share waiting for acknowledgement
+typedef struct {
+    char last_hash[41];
+    char expected_hash[41];
+    uint32_t nonce;
+    float hashrate;             // Hashrate reported with the original submission
+    int64_t found_us;           // When the nonce was found
+    uint8_t attempts;           // Submissions tried so far
+    bool used;
+} duco_pending_share_t;
+
+// Queue and its counters
+typedef struct {
+    duco_pending_share_t entries[DUCO_SHARE_QUEUE_LEN];
+    uint32_t queued;            // Shares ever queued
+    uint32_t expired;           // Shares dropped as stale or after too many attempts
+} duco_share_queue_t;
+
+/**
+ * @brief Initialize an empty queue
+ */
+void duco_share_queue_init(duco_share_queue_t *q);
+
+/**
+ * @brief Queue a share whose submission failed
+ *
+ * If the queue is full the oldest entry is expired to make room.
+ *
+ * @param q Queue
+ * @param share Share to queue (attempts should already count the failed try)
+ */
+void duco_share_queue_push(duco_share_queue_t *q, const duco_pending_share_t *share);
+
+/**
+ * @brief Drop shares that can no longer be accepted
+ *
+ * A share is stale once the chain has moved on (a job with a different
+ * last_hash was issued), it is older than max_age_us, or it has used up its
+ * submission attempts.
+ *
+ * @param q Queue
+ * @param current_last_hash last_hash of the job just received (NULL to skip that rule)
+ * @param now_us Current time
+ * @param max_age_us Maximum share age
+ * @return Number of shares expired
+ */
+uint32_t duco_share_queue_expire(duco_share_queue_t *q, const char *current_last_hash,
+                                 int64_t now_us, int64_t max_age_us);
+
+/**
+ * @brief Remove and return the share solving a job, if queued
+ *
+ * @param q Queue
+ * @param last_hash Job last_hash
+ * @param expected_hash Job expected_hash
+ * @param out Share removed from the queue
+ * @return true if a share for this job was queued
+ */
+bool duco_share_queue_take(duco_share_queue_t *q, const char *last_hash,
+                           const char *expected_hash, duco_pending_share_t *out);
+
+/**
+ * @brief Number of shares waiting
+ */
+size_t duco_share_queue_count(const duco_share_queue_t *q);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DUCO_SHARE_QUEUE_H
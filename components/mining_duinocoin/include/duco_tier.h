@@ -0,0 +1,98 @@
+/**
+ * DUCO Difficulty Tier Selection
+ *
+ * Chooses the difficulty tier sent in the JOB request from measured solve
+ * time, network round-trip time, hashrate and reward per share. Keeps network
+ * overhead a small fraction of wall time without straying outside the
+ * hashrate band the server accepts for a tier.
+ */
+
+#ifndef DUCO_TIER_H
+#define DUCO_TIER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Special tier name meaning "choose automatically"
+#define DUCO_TIER_AUTO "AUTO"
+
+// Number of tiers in the selection table
+#define DUCO_TIER_COUNT 5
+
+// Reason for the most recent tier decision
+typedef enum {
+    DUCO_TIER_REASON_WARMUP = 0,    // Not enough samples yet
+    DUCO_TIER_REASON_HOLD,          // Current tier is fine
+    DUCO_TIER_REASON_OVERRIDE,      // Fixed by configuration
+    DUCO_TIER_REASON_OVERHEAD,      // Network overhead too high, moved up
+    DUCO_TIER_REASON_TOO_FAST,      // Above the tier's hashrate limit, moved up
+    DUCO_TIER_REASON_TOO_SLOW,      // Jobs take too long, moved down
+    DUCO_TIER_REASON_REJECTS,       // Too many rejected shares
+    DUCO_TIER_REASON_REWARD         // Neighbouring tier pays better
+} duco_tier_reason_t;
+
+// Selector state and metrics
+typedef struct {
+    uint8_t tier;                   // Current index into the tier table
+    uint8_t floor;                  // Lowest tier known to be usable
+    uint8_t ceiling;                // Highest tier known to be usable
+    bool overridden;                // Tier fixed by configuration
+    duco_tier_reason_t reason;      // Why the current tier was chosen
+    float solve_ms;                 // EWMA hashing time per job
+    float rtt_ms;                   // EWMA network round trip per job
+    float hashrate;                 // EWMA hashrate while solving
+    float reward_per_share;         // EWMA DUCO per accepted share
+    float reward_rate[DUCO_TIER_COUNT]; // EWMA DUCO per second of wall time, per tier
+    uint32_t samples;               // Jobs recorded since the last change
+    uint32_t rejects;               // Rejected shares since the last change
+    uint32_t reward_samples;        // Rewards folded into reward_per_share
+    uint32_t rate_samples[DUCO_TIER_COUNT]; // Jobs folded into reward_rate, per tier
+} duco_tier_selector_t;
+
+/**
+ * @brief Initialize the selector
+ *
+ * @param sel Selector state
+ * @param configured Tier name from configuration, or "AUTO"/"" for adaptive
+ * @return false if the configured name is not a known tier (adaptive is used)
+ */
+bool duco_tier_init(duco_tier_selector_t *sel, const char *configured);
+
+/**
+ * @brief Record the outcome of one job and re-evaluate the tier
+ *
+ * @param sel Selector state
+ * @param solve_us Time spent hashing
+ * @param rtt_us Time spent waiting on the network (job fetch + submit)
+ * @param hashes Hashes computed for the job
+ * @param accepted True if the share was accepted
+ * @param reward DUCO earned for the share (0 if unknown or rejected)
+ * @return true if the tier changed
+ */
+bool duco_tier_record(duco_tier_selector_t *sel, uint32_t solve_us, uint32_t rtt_us,
+                      uint32_t hashes, bool accepted, float reward);
+
+/**
+ * @brief Get the tier name to send in the next JOB request
+ */
+const char *duco_tier_name(const duco_tier_selector_t *sel);
+
+/**
+ * @brief Network overhead as a percentage of wall time per job
+ */
+float duco_tier_overhead_pct(const duco_tier_selector_t *sel);
+
+/**
+ * @brief Human-readable name for a decision reason
+ */
+const char *duco_tier_reason_str(duco_tier_reason_t reason);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DUCO_TIER_H
@@ -0,0 +1,149 @@
+/**
+ * DUCO Hashing Worker
+ *
+ * A worker task only consumes jobs and produces results - it never touches
+ * a socket. The network task hands it preparsed job descriptors over a
+ * lock-free SPSC ring and collects outcomes over a second one, so network
+ * stalls can never block the hashing core and the hot path takes no locks.
+ *
+ * Every job carries the generation of the connection it was issued on. The
+ * network task publishes the live generation per worker; a worker drops a
+ * job as soon as the two differ, without any round trip.
+ *
+ * Hashing runs in time-budgeted slices (see hash_slice.h). Between slices
+ * the worker checks for stop requests and stale jobs, feeds the task
+ * watchdog and applies thermal pacing, so its response time is bounded by
+ * the slice length rather than by hash speed.
+ */
+
+#ifndef DUCO_WORKER_H
+#define DUCO_WORKER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "hashrate_meter.h"
+#include "duco_sha1_mb.h"
+#include "spsc_ring.h"
+#include "hash_slice.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DUCO_JOB_RING_SIZE 2        // Slots per worker job ring (power of two)
+#define DUCO_RESULT_RING_SIZE 4     // Slots per worker result ring (power of two)
+
+// Job identity as issued by the server
+typedef struct {
+    char last_hash[41];
+    char expected_hash[41];
+    uint32_t difficulty;
+    uint32_t generation;        // Connection generation the job was issued on
+    uint8_t conn;               // Connection index
+} duco_job_id_t;
+
+// Preparsed job descriptor, network task -> worker
+typedef struct {
+    duco_job_id_t id;
+    duco_sha1_job_t sha1;       // Binary target and precomputed prefix state
+    uint32_t nonce_start;       // First nonce to try
+    uint32_t nonce_end;         // One past the last nonce to try
+} duco_job_t;
+
+// Outcome of a job, worker -> network task
+typedef struct {
+    duco_job_id_t job;
+    bool found;
+    uint32_t nonce;
+    uint32_t hashes;            // Hashes computed for this job
+    int64_t solve_us;           // Wall time from job start to result
+} duco_result_t;
+
+// Worker context
+typedef struct {
+    uint8_t index;              // Worker number (thermal pacing)
+    spsc_ring_t jobs;           // duco_job_t, network -> worker
+    spsc_ring_t results;        // duco_result_t, worker -> network
+    duco_job_t job_slots[DUCO_JOB_RING_SIZE];
+    duco_result_t result_slots[DUCO_RESULT_RING_SIZE];
+    atomic_uint_fast32_t generation;    // Live connection generation
+    hashrate_meter_t *meter;    // This worker's own meter (slot 0)
+    volatile bool stop;         // Set to ask the worker to exit
+    TaskHandle_t task;          // NULL once the worker has exited
+    _Atomic uint64_t total_hashes;  // Written by the worker, read cross-core
+    uint32_t stale_dropped;     // Jobs abandoned because their generation ended
+
+    // Responsiveness metrics, written by the worker only
+    hash_slice_t slice;         // Batch sizing and achieved slice lengths
+    atomic_uint_fast32_t preempt_request_us;    // When the generation last changed (low 32 bits)
+    uint32_t preemptions;       // Running jobs abandoned for a new generation
+    uint32_t preempt_last_us;   // Generation change to the worker dropping the job
+    uint32_t preempt_max_us;
+    bool wdt_subscribed;        // Worker feeds the task watchdog
+} duco_worker_t;
+
+/**
+ * @brief Initialize a worker context and its rings
+ *
+ * @param worker Worker context
+ * @param index Worker number (thermal pacing)
+ * @param meter Single-slot hashrate meter owned by this worker
+ */
+void duco_worker_init(duco_worker_t *worker, uint8_t index, hashrate_meter_t *meter);
+
+/**
+ * @brief Hand a job to a worker (network task only)
+ *
+ * @return false if the worker's job ring is full
+ */
+bool duco_worker_submit(duco_worker_t *worker, const duco_job_t *job);
+
+/**
+ * @brief Publish the live generation; older queued or running jobs are dropped
+ */
+static inline void duco_worker_set_generation(duco_worker_t *worker, uint32_t generation)
+{
+    atomic_store_explicit(&worker->preempt_request_us, (uint32_t)esp_timer_get_time(),
+                          memory_order_relaxed);
+    atomic_store_explicit(&worker->generation, generation, memory_order_release);
+}
+
+/**
+ * @brief Start a hashing worker task
+ *
+ * The worker must have been initialized with duco_worker_init().
+ *
+ * @param worker Worker context (must outlive the task)
+ * @param core Core to pin the worker to
+ * @param priority Task priority
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t duco_worker_start(duco_worker_t *worker, BaseType_t core, UBaseType_t priority);
+
+/**
+ * @brief Ask a worker to stop and wait for it to exit
+ *
+ * @param worker Worker context
+ * @param timeout_ms Maximum time to wait before force-deleting the task
+ */
+void duco_worker_stop(duco_worker_t *worker, uint32_t timeout_ms);
+
+/**
+ * @brief Fetch one result (network task only)
+ *
+ * @return false if none is pending
+ */
+static inline bool duco_worker_poll(duco_worker_t *worker, duco_result_t *result)
+{
+    return spsc_ring_pop(&worker->results, result);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DUCO_WORKER_H
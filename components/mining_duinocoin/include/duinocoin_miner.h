@@ -11,6 +11,8 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "esp_err.h"
+#include "stats_journal.h"
+#include "hashrate_meter.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -25,18 +27,66 @@ typedef enum {
     DUCO_STATE_ERROR
 } duco_state_t;
 
-// Mining statistics
+#define DUCO_MAX_RIGS 2             // One rig per core
+#define DUCO_RTT_BUCKETS 8          // Round-trip histogram buckets (last one unbounded)
+
+// Upper bounds of the round-trip histogram buckets, milliseconds
+extern const uint16_t duco_rtt_bounds_ms[DUCO_RTT_BUCKETS - 1];
+
+// Per-rig statistics (this boot)
+typedef struct {
+    char rig_id[32];
+    duco_state_t state;
+    float hashrate;                 // While hashing, 10 s average
+    float wall_hashrate;            // Wall clock, 1 min average
+    uint32_t shares_accepted;
+    uint32_t shares_rejected;
+    uint32_t current_difficulty;
+    char difficulty_tier[12];       // This rig's tier in JOB lines
+    char tier_reason[20];           // Why the rig's tier was chosen
+    float avg_solve_ms;             // EWMA hashing time per job
+    float last_rtt_ms;              // Job fetch + submit round trip of the last share
+    float avg_rtt_ms;               // EWMA of the above
+    uint32_t rtt_hist[DUCO_RTT_BUCKETS];    // Round trips per bucket (not cumulative)
+    float rtt_sum_ms;               // Sum of all round trips in the histogram
+    uint32_t reconnects;
+    float slice_avg_us;             // Hashing slice between checks, EWMA
+    uint32_t slice_max_us;          // Longest slice this boot
+    uint32_t slice_overruns;        // Slices over twice their target
+    uint32_t preemptions;           // Running jobs dropped for a new connection generation
+    uint32_t preempt_last_us;       // Generation change to the worker dropping the job
+    uint32_t preempt_max_us;
+} duco_rig_stats_t;
+
+// Mining statistics (share counts and earned total are lifetime values;
+// hashrates and counters below are the aggregate of all rigs)
 typedef struct {
     uint32_t shares_accepted;
     uint32_t shares_rejected;
+    uint32_t shares_recovered;      // Queued shares accepted after a reconnect
+    uint32_t shares_expired;        // Queued shares dropped as stale
+    uint32_t shares_pending;        // Shares currently queued for retry
+    uint32_t jobs_stale_dropped;    // Jobs abandoned by workers after a disconnect
     float duco_earned_today;
-    float duco_earned_total;
-    float current_hashrate;
-    float avg_hashrate;
+    double duco_earned_total;       // Lifetime; a float would drop small shares once it grows
+    float current_hashrate;         // While hashing, 10 s average
+    float avg_hashrate;             // Wall clock, 15 min average
+    hashrate_snapshot_t hashrate;   // All windows, wall clock and while hashing
     uint32_t current_difficulty;
+    char difficulty_tier[12];       // Tier all rigs request, or "MIXED" (see rigs[])
+    char tier_reason[20];           // Why the tier was chosen
+    bool tier_overridden;           // Tier fixed by configuration
+    float avg_solve_ms;             // EWMA hashing time per job
+    float avg_rtt_ms;               // EWMA network round trip per job
+    float network_overhead_pct;     // Round trip as % of wall time per job
+    float reward_per_share;         // EWMA DUCO per accepted share
     uint32_t uptime_seconds;
+    uint32_t boot_to_first_hash_ms;     // 0 until reached
+    uint32_t boot_to_first_share_ms;    // First accepted share, 0 until reached
     duco_state_t state;
     char last_message[128];
+    uint8_t rig_count;
+    duco_rig_stats_t rigs[DUCO_MAX_RIGS];
 } duco_stats_t;
 
 /**
@@ -81,6 +131,26 @@ duco_state_t duco_miner_get_state(void);
  */
 esp_err_t duco_miner_get_stats(duco_stats_t *stats);
 
+/**
+ * @brief Get lifetime totals for the stats journal
+ *
+ * Combines the totals recovered at init with this session's progress.
+ *
+ * @param totals Pointer to totals structure to populate
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t duco_miner_get_totals(stats_totals_t *totals);
+
+/**
+ * @brief Cross-validate the multi-buffer SHA-1 kernel against mbedtls
+ *
+ * Checks every lane of the 2/4/8-lane kernels, across nonce digit-count
+ * boundaries, and that the search mask flags exactly the matching lane.
+ *
+ * @return ESP_OK if the kernel matches mbedtls, ESP_FAIL otherwise
+ */
+esp_err_t duco_miner_self_test(void);
+
 /**
  * @brief Check if miner is running
  *
@@ -88,6 +158,17 @@ esp_err_t duco_miner_get_stats(duco_stats_t *stats);
  */
 bool duco_miner_is_running(void);
 
+/**
+ * @brief Report network link state
+ *
+ * While the link is down the miner closes its connections and makes no
+ * reconnect attempts; when it comes back every rig reconnects at once.
+ * Assumed up until first called.
+ *
+ * @param up True when the network is usable
+ */
+void duco_miner_set_link(bool up);
+
 #ifdef __cplusplus
 }
 #endif
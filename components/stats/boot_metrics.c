@@ -0,0 +1,71 @@
+/**
+ * Boot Metrics Implementation
+ */
+
+#include "boot_metrics.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include <stdatomic.h>
+
+static const char *TAG = "BOOT";
+
+// Milliseconds since boot, 0 = not reached (32 bits keep marking lock-free)
+static atomic_uint_fast32_t stamps[BOOT_STAGE_COUNT];
+
+static const char *stage_names[BOOT_STAGE_COUNT] = {
+    [BOOT_STAGE_NVS] = "nvs",
+    [BOOT_STAGE_CONFIG] = "config",
+    [BOOT_STAGE_WIFI_STARTED] = "wifi_started",
+    [BOOT_STAGE_SELF_TEST] = "self_test",
+    [BOOT_STAGE_MINER_STARTED] = "miner_started",
+    [BOOT_STAGE_LINK_UP] = "link_up",
+    [BOOT_STAGE_DNS] = "dns",
+    [BOOT_STAGE_POOL_CONNECTED] = "pool_connected",
+    [BOOT_STAGE_FIRST_JOB] = "first_job",
+    [BOOT_STAGE_FIRST_HASH] = "first_hash",
+    [BOOT_STAGE_FIRST_SHARE] = "first_share",
+};
+
+void boot_metrics_mark(boot_stage_t stage)
+{
+    if (stage >= BOOT_STAGE_COUNT ||
+        atomic_load_explicit(&stamps[stage], memory_order_relaxed) != 0) {
+        return;
+    }
+
+    uint_fast32_t ms = (uint_fast32_t)(esp_timer_get_time() / 1000);
+    if (ms == 0) {
+        ms = 1;
+    }
+    uint_fast32_t unset = 0;
+    if (atomic_compare_exchange_strong_explicit(&stamps[stage], &unset, ms,
+                                                memory_order_relaxed, memory_order_relaxed)) {
+        ESP_LOGI(TAG, "%s at %lu ms", stage_names[stage], (unsigned long)ms);
+    }
+}
+
+uint32_t boot_metrics_get(boot_stage_t stage)
+{
+    if (stage >= BOOT_STAGE_COUNT) {
+        return 0;
+    }
+    return (uint32_t)atomic_load_explicit(&stamps[stage], memory_order_relaxed);
+}
+
+const char *boot_metrics_stage_name(boot_stage_t stage)
+{
+    return stage < BOOT_STAGE_COUNT ? stage_names[stage] : "unknown";
+}
+
+void boot_metrics_log(void)
+{
+    ESP_LOGI(TAG, "Boot timeline (ms since boot):");
+    for (int i = 0; i < BOOT_STAGE_COUNT; i++) {
+        uint32_t ms = boot_metrics_get(i);
+        if (ms != 0) {
+            ESP_LOGI(TAG, "  %-15s %6lu", stage_names[i], (unsigned long)ms);
+        } else {
+            ESP_LOGI(TAG, "  %-15s      -", stage_names[i]);
+        }
+    }
+}
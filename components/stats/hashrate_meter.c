@@ -0,0 +1,155 @@
+/**
+ * Hashrate Meter Implementation
+ *
+ * Averages use the same exponential decay as load averages: each 1 s sample
+ * moves the average by 1 - e^(-dt/tau), so late or missed ticks are
+ * weighted correctly. The first sample seeds the average directly instead of
+ * ramping up from zero.
+ */
+
+#include "hashrate_meter.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include <math.h>
+#include <string.h>
+
+static const char *TAG = "HASHRATE";
+
+#define TICK_PERIOD_US 1000000
+
+static void ewma_update(float *avg, float sample, float dt_sec, float tau_sec, bool primed)
+{
+    if (!primed) {
+        *avg = sample;
+        return;
+    }
+    *avg += (1.0f - expf(-dt_sec / tau_sec)) * (sample - *avg);
+}
+
+static void meter_timer_cb(void *arg)
+{
+    hashrate_meter_tick((hashrate_meter_t *)arg, esp_timer_get_time());
+}
+
+esp_err_t hashrate_meter_init(hashrate_meter_t *meter, const char *name, uint8_t worker_count)
+{
+    if (!meter || worker_count == 0 || worker_count > HASHRATE_METER_MAX_WORKERS) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(meter, 0, sizeof(*meter));
+    meter->worker_count = worker_count;
+    meter->last_tick_us = esp_timer_get_time();
+    portMUX_INITIALIZE(&meter->lock);
+
+    esp_timer_create_args_t timer_args = {
+        .callback = meter_timer_cb,
+        .arg = meter,
+        .name = name,
+    };
+    esp_timer_handle_t timer;
+    esp_err_t ret = esp_timer_create(&timer_args, &timer);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create timer: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    ret = esp_timer_start_periodic(timer, TICK_PERIOD_US);
+    if (ret != ESP_OK) {
+        esp_timer_delete(timer);
+        return ret;
+    }
+
+    meter->timer = timer;
+    return ESP_OK;
+}
+
+void hashrate_meter_deinit(hashrate_meter_t *meter)
+{
+    if (meter && meter->timer) {
+        esp_timer_stop((esp_timer_handle_t)meter->timer);
+        esp_timer_delete((esp_timer_handle_t)meter->timer);
+        meter->timer = NULL;
+    }
+}
+
+void hashrate_meter_tick(hashrate_meter_t *meter, int64_t now_us)
+{
+    float dt_sec = (now_us - meter->last_tick_us) / 1000000.0f;
+    if (dt_sec <= 0.0f) {
+        return;
+    }
+    meter->last_tick_us = now_us;
+
+    uint32_t total = 0;
+    uint32_t busy_us = 0;
+    float hashing_rate = 0.0f;
+
+    for (uint8_t i = 0; i < meter->worker_count; i++) {
+        uint32_t h = atomic_load_explicit(&meter->workers[i].hashes, memory_order_relaxed);
+        uint32_t b = atomic_load_explicit(&meter->workers[i].busy_us, memory_order_relaxed);
+
+        // Unsigned subtraction handles counter wrap
+        uint32_t dh = h - meter->last_hashes[i];
+        uint32_t db = b - meter->last_busy_us[i];
+        meter->last_hashes[i] = h;
+        meter->last_busy_us[i] = b;
+
+        total += dh;
+        busy_us += db;
+        // Each active worker contributes its own rate; parked workers add nothing
+        if (db > 0) {
+            hashing_rate += dh / (db / 1000000.0f);
+        }
+    }
+
+    meter->bucket_hashes[meter->bucket_pos] = total;
+    meter->bucket_busy_ms[meter->bucket_pos] = busy_us / 1000;
+    meter->bucket_pos = (meter->bucket_pos + 1) % HASHRATE_METER_BUCKETS;
+    if (meter->bucket_fill < HASHRATE_METER_BUCKETS) {
+        meter->bucket_fill++;
+    }
+
+    uint64_t busy_ms_window = 0;
+    for (uint16_t i = 0; i < meter->bucket_fill; i++) {
+        busy_ms_window += meter->bucket_busy_ms[i];
+    }
+    float duty = 100.0f * busy_ms_window /
+                 ((float)meter->bucket_fill * 1000.0f * meter->worker_count);
+
+    float wall_rate = total / dt_sec;
+
+    portENTER_CRITICAL(&meter->lock);
+    hashrate_snapshot_t *s = &meter->snapshot;
+
+    ewma_update(&s->wall_10s, wall_rate, dt_sec, 10.0f, meter->wall_primed);
+    ewma_update(&s->wall_1m, wall_rate, dt_sec, 60.0f, meter->wall_primed);
+    ewma_update(&s->wall_15m, wall_rate, dt_sec, 900.0f, meter->wall_primed);
+    meter->wall_primed = true;
+
+    // Hold while-hashing rates through idle periods rather than decaying them
+    if (busy_us > 0) {
+        ewma_update(&s->hashing_10s, hashing_rate, dt_sec, 10.0f, meter->hashing_primed);
+        ewma_update(&s->hashing_1m, hashing_rate, dt_sec, 60.0f, meter->hashing_primed);
+        ewma_update(&s->hashing_15m, hashing_rate, dt_sec, 900.0f, meter->hashing_primed);
+        meter->hashing_primed = true;
+    }
+
+    s->duty_pct = duty > 100.0f ? 100.0f : duty;
+    s->total_hashes += total;
+    portEXIT_CRITICAL(&meter->lock);
+}
+
+void hashrate_meter_get(hashrate_meter_t *meter, hashrate_snapshot_t *snapshot)
+{
+    portENTER_CRITICAL(&meter->lock);
+    *snapshot = meter->snapshot;
+    portEXIT_CRITICAL(&meter->lock);
+}
+
+float hashrate_meter_reported(hashrate_meter_t *meter)
+{
+    hashrate_snapshot_t s;
+    hashrate_meter_get(meter, &s);
+    return s.hashing_1m > 0.0f ? s.hashing_1m : s.hashing_10s;
+}
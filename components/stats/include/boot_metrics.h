@@ -0,0 +1,64 @@
+/**
+ * Boot Metrics
+ *
+ * Records when each startup stage first completed, as milliseconds since
+ * boot. A stage is only marked once per boot, so marking is safe from any
+ * task (including the hashing workers, once per job) and cheap after the
+ * first time. The two headline numbers are boot-to-first-hash and
+ * boot-to-first-accepted-share: after a power cut, that whole time is spent
+ * without earning.
+ */
+
+#ifndef BOOT_METRICS_H
+#define BOOT_METRICS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Startup stages, roughly in the order they complete
+typedef enum {
+    BOOT_STAGE_NVS = 0,             // NVS ready
+    BOOT_STAGE_CONFIG,              // Configuration loaded
+    BOOT_STAGE_WIFI_STARTED,        // Station started, association under way
+    BOOT_STAGE_SELF_TEST,           // Hashing kernel verified
+    BOOT_STAGE_MINER_STARTED,       // Network task and workers running
+    BOOT_STAGE_LINK_UP,             // Station has an address
+    BOOT_STAGE_DNS,                 // Pool address known (cached or resolved)
+    BOOT_STAGE_POOL_CONNECTED,      // TCP connection to the pool established
+    BOOT_STAGE_FIRST_JOB,           // First job received
+    BOOT_STAGE_FIRST_HASH,          // A worker started hashing
+    BOOT_STAGE_FIRST_SHARE,         // First share accepted
+    BOOT_STAGE_COUNT
+} boot_stage_t;
+
+/**
+ * @brief Mark a stage as complete now (first call per stage wins)
+ */
+void boot_metrics_mark(boot_stage_t stage);
+
+/**
+ * @brief Milliseconds from boot to a stage
+ *
+ * @return Time in ms, or 0 if the stage has not completed yet
+ */
+uint32_t boot_metrics_get(boot_stage_t stage);
+
+/**
+ * @brief Short stage name
+ */
+const char *boot_metrics_stage_name(boot_stage_t stage);
+
+/**
+ * @brief Log the timeline of completed stages
+ */
+void boot_metrics_log(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BOOT_METRICS_H
@@ -0,0 +1,129 @@
+/**
+ * Hashrate Meter
+ *
+ * Hashing workers record hash counts and time spent hashing; a 1 Hz sampler
+ * folds them into per-second buckets and 10 s / 1 min / 15 min exponentially
+ * weighted moving averages. Two families of rates are kept:
+ *   - wall clock: hashes per second of real time, including pauses for
+ *     network I/O, reconnects and thermal throttling
+ *   - while hashing: hashes per second of time workers actually spent hashing
+ */
+
+#ifndef HASHRATE_METER_H
+#define HASHRATE_METER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define HASHRATE_METER_MAX_WORKERS 4
+#define HASHRATE_METER_BUCKETS 60           // One minute of per-second history
+
+// Rates published once per second
+typedef struct {
+    float wall_10s;
+    float wall_1m;
+    float wall_15m;
+    float hashing_10s;
+    float hashing_1m;
+    float hashing_15m;
+    float duty_pct;                         // Worker time spent hashing over the last minute
+    uint64_t total_hashes;
+} hashrate_snapshot_t;
+
+// Counters written by exactly one worker (padded to avoid false sharing)
+typedef struct {
+    _Atomic uint32_t hashes;                // Wrapping counter
+    _Atomic uint32_t busy_us;               // Wrapping counter
+} __attribute__((aligned(32))) hashrate_worker_counter_t;
+
+typedef struct {
+    hashrate_worker_counter_t workers[HASHRATE_METER_MAX_WORKERS];
+    uint8_t worker_count;
+
+    // Sampler state - touched only by the 1 Hz tick
+    uint32_t last_hashes[HASHRATE_METER_MAX_WORKERS];
+    uint32_t last_busy_us[HASHRATE_METER_MAX_WORKERS];
+    int64_t last_tick_us;
+    uint32_t bucket_hashes[HASHRATE_METER_BUCKETS];
+    uint32_t bucket_busy_ms[HASHRATE_METER_BUCKETS];
+    uint16_t bucket_pos;
+    uint16_t bucket_fill;
+    bool wall_primed;
+    bool hashing_primed;
+    void *timer;                            // esp_timer_handle_t
+
+    portMUX_TYPE lock;                      // Guards snapshot
+    hashrate_snapshot_t snapshot;
+} hashrate_meter_t;
+
+/**
+ * @brief Initialize a meter and start its 1 Hz sampler
+ *
+ * @param meter Meter to initialize
+ * @param name Timer name (for debugging)
+ * @param worker_count Number of hashing workers that will record into it
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t hashrate_meter_init(hashrate_meter_t *meter, const char *name, uint8_t worker_count);
+
+/**
+ * @brief Stop the sampler and release its timer
+ */
+void hashrate_meter_deinit(hashrate_meter_t *meter);
+
+/**
+ * @brief Record hashes computed by a worker
+ *
+ * Lock-free; call at batch boundaries from the owning worker only.
+ *
+ * @param meter Meter
+ * @param worker Worker index (< worker_count)
+ * @param hashes Hashes computed since the previous call
+ * @param busy_us Time spent hashing them (excluding sleeps and I/O)
+ */
+static inline void hashrate_meter_record(hashrate_meter_t *meter, uint8_t worker,
+                                         uint32_t hashes, uint32_t busy_us)
+{
+    hashrate_worker_counter_t *w = &meter->workers[worker];
+    atomic_fetch_add_explicit(&w->hashes, hashes, memory_order_relaxed);
+    atomic_fetch_add_explicit(&w->busy_us, busy_us, memory_order_relaxed);
+}
+
+/**
+ * @brief Fold recorded counts into buckets and averages
+ *
+ * Called by the meter's own timer once per second.
+ *
+ * @param meter Meter
+ * @param now_us Current time in microseconds
+ */
+void hashrate_meter_tick(hashrate_meter_t *meter, int64_t now_us);
+
+/**
+ * @brief Get the latest published rates
+ *
+ * @param meter Meter
+ * @param snapshot Pointer to snapshot to populate
+ */
+void hashrate_meter_get(hashrate_meter_t *meter, hashrate_snapshot_t *snapshot);
+
+/**
+ * @brief Rate to report to a pool
+ *
+ * The 1 min while-hashing average: steady enough that server-side stats do
+ * not oscillate, and independent of network stalls the pool already sees.
+ */
+float hashrate_meter_reported(hashrate_meter_t *meter);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HASHRATE_METER_H
@@ -0,0 +1,89 @@
+/**
+ * Stats Journal Component
+ *
+ * Append-only binary journal in the storage partition that keeps cumulative
+ * mining counters and hourly history rollups across reboots and brownouts.
+ * Checkpoints are batched to limit flash wear, and boot-time recovery reads
+ * a bounded amount of flash no matter how old the journal is.
+ */
+
+#ifndef STATS_JOURNAL_H
+#define STATS_JOURNAL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Cumulative counters carried across reboots
+typedef struct {
+    double duco_earned_total;
+    uint64_t total_hashes;
+    uint64_t mining_seconds;
+    uint32_t shares_accepted;
+    uint32_t shares_rejected;
+    uint32_t shares_recovered;
+    uint32_t boot_count;
+} stats_totals_t;
+
+// One hour of mining history
+typedef struct {
+    uint32_t hour;              // Hours of cumulative mining time at the start
+    uint32_t duration_sec;      // Mining seconds covered (<= 3600)
+    uint64_t hashes;
+    uint32_t shares_accepted;
+    uint32_t shares_rejected;
+    float duco_earned;
+} stats_rollup_t;
+
+/**
+ * @brief Initialize the journal and recover the latest consistent state
+ *
+ * Locates the newest journal sector from per-sector headers and replays only
+ * that sector, so boot time is bounded. Torn or partially written records
+ * are detected by CRC and ignored. Increments the boot counter.
+ *
+ * @return ESP_OK on success, ESP_ERR_NOT_FOUND if the storage partition is missing
+ */
+esp_err_t stats_journal_init(void);
+
+/**
+ * @brief Get the totals recovered at boot
+ *
+ * @param totals Pointer to totals structure to populate
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE if not initialized
+ */
+esp_err_t stats_journal_get_totals(stats_totals_t *totals);
+
+/**
+ * @brief Record current cumulative totals
+ *
+ * Cheap to call often - a checkpoint is only written once
+ * STATS_JOURNAL_INTERVAL_SEC has passed and something changed, unless
+ * forced. Hourly rollups are appended automatically as mining time crosses
+ * each hour.
+ *
+ * @param totals Current cumulative totals
+ * @param force Write immediately (e.g. before a planned restart)
+ * @return ESP_OK on success (including when the write was deferred)
+ */
+esp_err_t stats_journal_checkpoint(const stats_totals_t *totals, bool force);
+
+/**
+ * @brief Read the most recent hourly rollups, newest first
+ *
+ * @param rollups Output array
+ * @param max Capacity of the output array
+ * @return Number of rollups returned
+ */
+size_t stats_journal_read_history(stats_rollup_t *rollups, size_t max);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // STATS_JOURNAL_H
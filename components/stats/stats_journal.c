@@ -0,0 +1,370 @@
+/**
+ * Stats Journal Implementation
+ *
+ * Layout: the first JOURNAL_SECTORS sectors of the storage partition form a
+ * ring. Each sector holds fixed-size records; the first record of every
+ * sector is always a full checkpoint, so the newest consistent state is
+ * found by reading one record per sector and then replaying only the newest
+ * sector. Every record carries a CRC, so a write torn by power loss is
+ * simply skipped and the next write starts a fresh sector.
+ */
+
+#include "stats_journal.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_partition.h"
+#include "esp_rom_crc.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include <string.h>
+#include <stdlib.h>
+
+// Include user configuration
+#include "config.h"
+
+static const char *TAG = "JOURNAL";
+
+#ifndef STATS_JOURNAL_INTERVAL_SEC
+#define STATS_JOURNAL_INTERVAL_SEC 300
+#endif
+
+#define JOURNAL_PARTITION "storage"
+#define JOURNAL_SECTORS 32                  // 128 KB at the start of the partition
+#define JOURNAL_SECTOR_SIZE 4096
+#define JOURNAL_RECORD_SIZE 128
+#define RECORDS_PER_SECTOR (JOURNAL_SECTOR_SIZE / JOURNAL_RECORD_SIZE)
+#define RECORD_MAGIC 0x4A53                 // "SJ"
+#define FORMAT_VERSION 1
+
+enum {
+    RECORD_CHECKPOINT = 1,
+    RECORD_ROLLUP = 2,
+};
+
+typedef struct __attribute__((packed)) {
+    uint16_t magic;
+    uint8_t type;
+    uint8_t version;
+    uint32_t seq;                           // Global record sequence number
+    uint8_t payload[JOURNAL_RECORD_SIZE - 12];
+    uint32_t crc;                           // CRC32 of everything above
+} journal_record_t;
+
+_Static_assert(sizeof(journal_record_t) == JOURNAL_RECORD_SIZE, "record size");
+
+typedef struct {
+    stats_totals_t totals;
+    stats_totals_t hour_base;               // Totals at the start of the current hour
+} checkpoint_payload_t;
+
+_Static_assert(sizeof(checkpoint_payload_t) <= sizeof(((journal_record_t *)0)->payload),
+               "checkpoint payload too large");
+
+static const esp_partition_t *partition = NULL;
+static SemaphoreHandle_t journal_mutex = NULL;
+static bool journal_ready = false;
+
+static uint32_t next_seq = 1;
+static uint32_t write_sector = JOURNAL_SECTORS - 1;
+static uint32_t write_slot = RECORDS_PER_SECTOR;   // Full - first write rotates
+static stats_totals_t totals = {0};
+static stats_totals_t hour_base = {0};
+static int64_t last_checkpoint_us = 0;
+
+static uint32_t record_crc(const journal_record_t *rec)
+{
+    return esp_rom_crc32_le(0, (const uint8_t *)rec, offsetof(journal_record_t, crc));
+}
+
+static bool record_valid(const journal_record_t *rec)
+{
+    return rec->magic == RECORD_MAGIC && rec->version == FORMAT_VERSION &&
+           rec->crc == record_crc(rec);
+}
+
+static bool record_erased(const journal_record_t *rec)
+{
+    const uint8_t *p = (const uint8_t *)rec;
+    for (size_t i = 0; i < sizeof(*rec); i++) {
+        if (p[i] != 0xFF) return false;
+    }
+    return true;
+}
+
+static esp_err_t read_record(uint32_t sector, uint32_t slot, journal_record_t *rec)
+{
+    size_t offset = sector * JOURNAL_SECTOR_SIZE + slot * JOURNAL_RECORD_SIZE;
+    return esp_partition_read(partition, offset, rec, sizeof(*rec));
+}
+
+/**
+ * @brief Append one record, rotating to the next sector when full
+ */
+static esp_err_t append_record(uint8_t type, const void *payload, size_t len);
+
+/**
+ * @brief Write the current checkpoint record
+ */
+static esp_err_t write_checkpoint(void)
+{
+    checkpoint_payload_t cp = {
+        .totals = totals,
+        .hour_base = hour_base,
+    };
+    return append_record(RECORD_CHECKPOINT, &cp, sizeof(cp));
+}
+
+static esp_err_t append_record(uint8_t type, const void *payload, size_t len)
+{
+    esp_err_t ret;
+
+    if (write_slot >= RECORDS_PER_SECTOR) {
+        write_sector = (write_sector + 1) % JOURNAL_SECTORS;
+        write_slot = 0;
+
+        ret = esp_partition_erase_range(partition, write_sector * JOURNAL_SECTOR_SIZE,
+                                        JOURNAL_SECTOR_SIZE);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to erase sector %lu: %s",
+                     (unsigned long)write_sector, esp_err_to_name(ret));
+            write_slot = RECORDS_PER_SECTOR;
+            return ret;
+        }
+
+        // Every sector starts with a full checkpoint so recovery needs only one sector
+        if (type != RECORD_CHECKPOINT) {
+            ret = write_checkpoint();
+            if (ret != ESP_OK) {
+                return ret;
+            }
+        }
+    }
+
+    journal_record_t rec;
+    memset(&rec, 0, sizeof(rec));
+    rec.magic = RECORD_MAGIC;
+    rec.type = type;
+    rec.version = FORMAT_VERSION;
+    rec.seq = next_seq;
+    memcpy(rec.payload, payload, len);
+    rec.crc = record_crc(&rec);
+
+    size_t offset = write_sector * JOURNAL_SECTOR_SIZE + write_slot * JOURNAL_RECORD_SIZE;
+    ret = esp_partition_write(partition, offset, &rec, sizeof(rec));
+
+    // Never rewrite a slot - a failed write may have flipped bits
+    write_slot++;
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to write record: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    next_seq++;
+    return ESP_OK;
+}
+
+/**
+ * @brief Find the newest sector and replay it
+ */
+static void journal_recover(void)
+{
+    journal_record_t rec;
+    int newest = -1;
+    uint32_t newest_seq = 0;
+
+    // One read per sector: the leading checkpoint carries the sector's age
+    for (uint32_t s = 0; s < JOURNAL_SECTORS; s++) {
+        if (read_record(s, 0, &rec) != ESP_OK) continue;
+        if (record_valid(&rec) && rec.type == RECORD_CHECKPOINT &&
+            (newest < 0 || rec.seq > newest_seq)) {
+            newest = s;
+            newest_seq = rec.seq;
+        }
+    }
+
+    if (newest < 0) {
+        ESP_LOGI(TAG, "No journal found - starting fresh");
+        return;
+    }
+
+    write_sector = newest;
+    write_slot = RECORDS_PER_SECTOR;
+
+    uint32_t replayed = 0;
+    for (uint32_t slot = 0; slot < RECORDS_PER_SECTOR; slot++) {
+        if (read_record(newest, slot, &rec) != ESP_OK) break;
+
+        if (record_erased(&rec)) {
+            write_slot = slot;
+            break;
+        }
+
+        if (!record_valid(&rec)) {
+            // Torn write - keep what we have and continue in a fresh sector
+            ESP_LOGW(TAG, "Torn record at sector %d slot %lu ignored", newest, (unsigned long)slot);
+            break;
+        }
+
+        if (rec.type == RECORD_CHECKPOINT) {
+            checkpoint_payload_t cp;
+            memcpy(&cp, rec.payload, sizeof(cp));
+            totals = cp.totals;
+            hour_base = cp.hour_base;
+        }
+        next_seq = rec.seq + 1;
+        replayed++;
+    }
+
+    ESP_LOGI(TAG, "Recovered journal: sector %d, %lu records replayed", newest,
+             (unsigned long)replayed);
+}
+
+esp_err_t stats_journal_init(void)
+{
+    if (journal_ready) {
+        return ESP_OK;
+    }
+
+    ESP_LOGI(TAG, "Initializing stats journal...");
+
+    partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY,
+                                         JOURNAL_PARTITION);
+    if (partition == NULL) {
+        ESP_LOGE(TAG, "Partition '%s' not found", JOURNAL_PARTITION);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    if (partition->size < JOURNAL_SECTORS * JOURNAL_SECTOR_SIZE) {
+        ESP_LOGE(TAG, "Partition '%s' too small for journal", JOURNAL_PARTITION);
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    if (journal_mutex == NULL) {
+        journal_mutex = xSemaphoreCreateMutex();
+        if (journal_mutex == NULL) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    int64_t start = esp_timer_get_time();
+    journal_recover();
+
+    totals.boot_count++;
+    esp_err_t ret = write_checkpoint();
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    last_checkpoint_us = esp_timer_get_time();
+    journal_ready = true;
+
+    ESP_LOGI(TAG, "Journal ready in %lld us - boot #%lu, %.8f DUCO, %lu shares accepted",
+             (long long)(last_checkpoint_us - start), (unsigned long)totals.boot_count,
+             totals.duco_earned_total, (unsigned long)totals.shares_accepted);
+    return ESP_OK;
+}
+
+esp_err_t stats_journal_get_totals(stats_totals_t *out_totals)
+{
+    if (!out_totals) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!journal_ready) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    xSemaphoreTake(journal_mutex, portMAX_DELAY);
+    *out_totals = totals;
+    xSemaphoreGive(journal_mutex);
+    return ESP_OK;
+}
+
+esp_err_t stats_journal_checkpoint(const stats_totals_t *current, bool force)
+{
+    if (!current) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!journal_ready) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    esp_err_t ret = ESP_OK;
+    int64_t now = esp_timer_get_time();
+
+    xSemaphoreTake(journal_mutex, portMAX_DELAY);
+
+    stats_totals_t next = *current;
+    next.boot_count = totals.boot_count;    // Owned by the journal
+
+    // Close out the hour once cumulative mining time crosses it
+    if (next.mining_seconds / 3600 > hour_base.mining_seconds / 3600) {
+        stats_rollup_t rollup = {
+            .hour = hour_base.mining_seconds / 3600,
+            .duration_sec = next.mining_seconds - hour_base.mining_seconds,
+            .hashes = next.total_hashes - hour_base.total_hashes,
+            .shares_accepted = next.shares_accepted - hour_base.shares_accepted,
+            .shares_rejected = next.shares_rejected - hour_base.shares_rejected,
+            .duco_earned = (float)(next.duco_earned_total - hour_base.duco_earned_total),
+        };
+        ret = append_record(RECORD_ROLLUP, &rollup, sizeof(rollup));
+        hour_base = next;
+        force = true;   // Persist the new hour base with the rollup
+    }
+
+    bool changed = memcmp(&next, &totals, sizeof(next)) != 0;
+    bool due = (now - last_checkpoint_us) >= (int64_t)STATS_JOURNAL_INTERVAL_SEC * 1000000;
+
+    if (force || (changed && due)) {
+        totals = next;
+        ret = write_checkpoint();
+        last_checkpoint_us = now;
+    }
+
+    xSemaphoreGive(journal_mutex);
+    return ret;
+}
+
+size_t stats_journal_read_history(stats_rollup_t *rollups, size_t max)
+{
+    if (!journal_ready || !rollups || max == 0) {
+        return 0;
+    }
+
+    stats_rollup_t *sector_rollups = malloc(RECORDS_PER_SECTOR * sizeof(stats_rollup_t));
+    if (!sector_rollups) {
+        return 0;
+    }
+
+    size_t count = 0;
+    journal_record_t rec;
+
+    xSemaphoreTake(journal_mutex, portMAX_DELAY);
+
+    uint32_t newer_seq = next_seq;
+    for (uint32_t k = 0; k < JOURNAL_SECTORS && count < max; k++) {
+        uint32_t sector = (write_sector + JOURNAL_SECTORS - k) % JOURNAL_SECTORS;
+
+        // Stop at erased sectors or where the ring wraps back to newer data
+        if (read_record(sector, 0, &rec) != ESP_OK || !record_valid(&rec) ||
+            rec.seq >= newer_seq) {
+            break;
+        }
+        newer_seq = rec.seq;
+
+        size_t n = 0;
+        for (uint32_t slot = 0; slot < RECORDS_PER_SECTOR; slot++) {
+            if (read_record(sector, slot, &rec) != ESP_OK || !record_valid(&rec)) break;
+            if (rec.type == RECORD_ROLLUP) {
+                memcpy(&sector_rollups[n++], rec.payload, sizeof(stats_rollup_t));
+            }
+        }
+
+        // Records within a sector are oldest first
+        while (n > 0 && count < max) {
+            rollups[count++] = sector_rollups[--n];
+        }
+    }
+
+    xSemaphoreGive(journal_mutex);
+    free(sector_rollups);
+    return count;
+}
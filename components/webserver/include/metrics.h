@@ -0,0 +1,79 @@
+/**
+ * Prometheus Metrics
+ *
+ * Renders miner, thermal, memory, Wi-Fi and logging stats in the Prometheus
+ * text exposition format (version 0.0.4). Collection copies each subsystem's
+ * existing snapshot; rendering is plain integer formatting into a caller
+ * buffer with no heap allocation and no printf, so a scrape costs well under
+ * a millisecond and never touches the hashing workers.
+ *
+ * All metric names start with "miner_".
+ */
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "duinocoin_miner.h"
+#include "thermal_governor.h"
+#include "mem_budget.h"
+#include "block_pool.h"
+#include "wifi_manager.h"
+#include "dlog.h"
+#include "fleet.h"
+#include "touch_input.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define METRICS_BUFFER_SIZE 18432       // Worst case (2 rigs, all tasks and pools, full fleet) is ~17 KB
+
+// Everything one scrape exports, copied from the subsystems
+typedef struct {
+    uint32_t uptime_s;
+    bool duco_running;
+    duco_stats_t duco;
+    bool thermal_ok;                    // Governor running with a working sensor
+    thermal_status_t thermal;
+    bool mem_ok;
+    mem_budget_snapshot_t mem;
+    uint8_t pool_count;
+    block_pool_stats_t pools[BLOCK_POOL_MAX_POOLS];
+    bool wifi_ok;
+    wifi_status_t wifi;
+    dlog_stats_t dlog;
+    bool fleet_ok;                      // This board aggregates the fleet
+    fleet_summary_t fleet;
+    uint8_t fleet_count;
+    fleet_device_t fleet_devices[FLEET_MAX_DEVICES];
+    bool touch_ok;                      // Touch controller found
+    touch_stats_t touch;
+    uint32_t scrapes;                   // Scrapes served before this one
+    uint32_t last_render_us;            // Collect + render time of the previous scrape
+} metrics_snapshot_t;
+
+/**
+ * @brief Copy current stats from every subsystem
+ *
+ * @param snap Snapshot to fill (scrapes and last_render_us are left alone)
+ */
+void metrics_collect(metrics_snapshot_t *snap);
+
+/**
+ * @brief Render a snapshot in Prometheus text format
+ *
+ * @param snap Snapshot from metrics_collect()
+ * @param buf Output buffer
+ * @param size Capacity of buf
+ * @return Bytes written (not NUL-terminated), or 0 if buf is too small
+ */
+size_t metrics_render(const metrics_snapshot_t *snap, char *buf, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // METRICS_H
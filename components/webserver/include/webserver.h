@@ -0,0 +1,39 @@
+/**
+ * Web Server
+ *
+ * HTTP server on WEB_SERVER_PORT, running on core 0 next to the network
+ * stack. Endpoints:
+ *   GET /metrics - Prometheus text format (see metrics.h)
+ */
+
+#ifndef WEBSERVER_H
+#define WEBSERVER_H
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Start the HTTP server
+ *
+ * Safe to call before the network is up; the server listens on every
+ * interface as they come and go.
+ *
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t webserver_start(void);
+
+/**
+ * @brief Stop the HTTP server
+ *
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t webserver_stop(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // WEBSERVER_H
@@ -0,0 +1,524 @@
+/**
+ * Prometheus Metrics Implementation
+ */
+
+#include "metrics.h"
+#include <string.h>
+#include <math.h>
+#include "esp_timer.h"
+
+// Output cursor; once full, further writes are dropped and overflow is set
+typedef struct {
+    char *buf;
+    size_t len;
+    size_t size;
+    bool overflow;
+} mbuf_t;
+
+static void put(mbuf_t *b, const char *s, size_t n)
+{
+    if (b->overflow || b->size - b->len < n) {
+        b->overflow = true;
+        return;
+    }
+    memcpy(b->buf + b->len, s, n);
+    b->len += n;
+}
+
+static void put_str(mbuf_t *b, const char *s)
+{
+    put(b, s, strlen(s));
+}
+
+static void put_u64(mbuf_t *b, uint64_t v)
+{
+    char tmp[20];
+    int n = 0;
+    do {
+        tmp[sizeof(tmp) - 1 - n++] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v != 0);
+    put(b, tmp + sizeof(tmp) - n, n);
+}
+
+/**
+ * @brief Fixed-point float with trailing zeros trimmed
+ */
+static void put_float(mbuf_t *b, double v, int decimals)
+{
+    if (isnan(v)) {
+        put_str(b, "NaN");
+        return;
+    }
+    if (v < 0.0) {
+        put_str(b, "-");
+        v = -v;
+    }
+    if (v >= 1.8e19) {
+        // Past uint64_t (and of no practical use here)
+        put_str(b, "+Inf");
+        return;
+    }
+
+    uint64_t scale = 1;
+    for (int i = 0; i < decimals; i++) {
+        scale *= 10;
+    }
+    uint64_t whole = (uint64_t)v;
+    uint64_t frac = (uint64_t)((v - (double)whole) * (double)scale + 0.5);
+    if (frac >= scale) {
+        whole++;
+        frac -= scale;
+    }
+    put_u64(b, whole);
+    if (frac == 0) {
+        return;
+    }
+
+    char tmp[20];
+    int n = decimals;
+    for (int i = n - 1; i >= 0; i--) {
+        tmp[i] = (char)('0' + frac % 10);
+        frac /= 10;
+    }
+    while (n > 0 && tmp[n - 1] == '0') {
+        n--;
+    }
+    put_str(b, ".");
+    put(b, tmp, n);
+}
+
+/**
+ * @brief Label value with backslash, quote and newline escaped
+ */
+static void put_label_value(mbuf_t *b, const char *s)
+{
+    for (; *s; s++) {
+        switch (*s) {
+            case '\\': put_str(b, "\\\\"); break;
+            case '"':  put_str(b, "\\\""); break;
+            case '\n': put_str(b, "\\n"); break;
+            default:   put(b, s, 1); break;
+        }
+    }
+}
+
+static void family(mbuf_t *b, const char *name, const char *type, const char *help)
+{
+    put_str(b, "# HELP ");
+    put_str(b, name);
+    put_str(b, " ");
+    put_str(b, help);
+    put_str(b, "\n# TYPE ");
+    put_str(b, name);
+    put_str(b, " ");
+    put_str(b, type);
+    put_str(b, "\n");
+}
+
+/**
+ * @brief Sample name with at most one label, up to the value
+ */
+static void sample(mbuf_t *b, const char *name, const char *key, const char *value)
+{
+    put_str(b, name);
+    if (key) {
+        put_str(b, "{");
+        put_str(b, key);
+        put_str(b, "=\"");
+        put_label_value(b, value);
+        put_str(b, "\"}");
+    }
+    put_str(b, " ");
+}
+
+static void sample_u(mbuf_t *b, const char *name, const char *key, const char *value, uint64_t v)
+{
+    sample(b, name, key, value);
+    put_u64(b, v);
+    put_str(b, "\n");
+}
+
+static void sample_fd(mbuf_t *b, const char *name, const char *key, const char *value,
+                      float v, int decimals)
+{
+    sample(b, name, key, value);
+    put_float(b, v, decimals);
+    put_str(b, "\n");
+}
+
+static void sample_f(mbuf_t *b, const char *name, const char *key, const char *value, float v)
+{
+    sample_fd(b, name, key, value, v, 3);
+}
+
+static void metric_u(mbuf_t *b, const char *name, const char *type, const char *help, uint64_t v)
+{
+    family(b, name, type, help);
+    sample_u(b, name, NULL, NULL, v);
+}
+
+static void metric_fd(mbuf_t *b, const char *name, const char *type, const char *help,
+                      double v, int decimals)
+{
+    family(b, name, type, help);
+    sample(b, name, NULL, NULL);
+    put_float(b, v, decimals);
+    put_str(b, "\n");
+}
+
+static void metric_f(mbuf_t *b, const char *name, const char *type, const char *help, float v)
+{
+    metric_fd(b, name, type, help, v, 3);
+}
+
+static void render_hashrate(mbuf_t *b, const hashrate_snapshot_t *h)
+{
+    static const char *name = "miner_hashrate_hps";
+    const struct {
+        const char *labels;
+        float value;
+    } rates[] = {
+        { "{window=\"10s\",basis=\"wall\"} ",    h->wall_10s },
+        { "{window=\"1m\",basis=\"wall\"} ",     h->wall_1m },
+        { "{window=\"15m\",basis=\"wall\"} ",    h->wall_15m },
+        { "{window=\"10s\",basis=\"hashing\"} ", h->hashing_10s },
+        { "{window=\"1m\",basis=\"hashing\"} ",  h->hashing_1m },
+        { "{window=\"15m\",basis=\"hashing\"} ", h->hashing_15m },
+    };
+
+    family(b, name, "gauge",
+           "Hashes per second averaged over a window, per second of wall time or of time spent hashing");
+    for (size_t i = 0; i < sizeof(rates) / sizeof(rates[0]); i++) {
+        put_str(b, name);
+        put_str(b, rates[i].labels);
+        put_float(b, rates[i].value, 3);
+        put_str(b, "\n");
+    }
+
+    metric_f(b, "miner_hashing_duty_ratio", "gauge",
+             "Fraction of worker time spent hashing over the last minute", h->duty_pct / 100.0f);
+    metric_u(b, "miner_hashes_total", "counter", "Hashes computed since boot", h->total_hashes);
+}
+
+static void render_duco(mbuf_t *b, const duco_stats_t *s)
+{
+    render_hashrate(b, &s->hashrate);
+
+    static const char *shares = "miner_shares_total";
+    family(b, shares, "counter", "Shares by outcome (accepted/rejected are lifetime totals)");
+    sample_u(b, shares, "result", "accepted", s->shares_accepted);
+    sample_u(b, shares, "result", "rejected", s->shares_rejected);
+    sample_u(b, shares, "result", "recovered", s->shares_recovered);
+    sample_u(b, shares, "result", "expired", s->shares_expired);
+
+    metric_u(b, "miner_shares_pending", "gauge", "Shares queued for retry", s->shares_pending);
+    metric_u(b, "miner_jobs_stale_dropped_total", "counter",
+             "Jobs abandoned by workers after a disconnect", s->jobs_stale_dropped);
+    metric_u(b, "miner_state", "gauge",
+             "Miner state (0 idle, 1 connecting, 2 connected, 3 mining, 4 error)", s->state);
+    metric_u(b, "miner_difficulty", "gauge", "Current share difficulty", s->current_difficulty);
+
+    metric_fd(b, "miner_duco_earned_total", "counter", "DUCO earned, lifetime",
+              s->duco_earned_total, 8);
+    metric_fd(b, "miner_duco_earned_today", "gauge", "DUCO earned today",
+              s->duco_earned_today, 8);
+
+    metric_f(b, "miner_solve_seconds", "gauge", "Average hashing time per job",
+             s->avg_solve_ms / 1000.0f);
+    metric_f(b, "miner_network_overhead_ratio", "gauge",
+             "Network round trip as a fraction of wall time per job", s->network_overhead_pct / 100.0f);
+    if (s->boot_to_first_hash_ms != 0) {
+        metric_f(b, "miner_boot_to_first_hash_seconds", "gauge", "Time from boot to the first hash",
+                 s->boot_to_first_hash_ms / 1000.0f);
+    }
+    if (s->boot_to_first_share_ms != 0) {
+        metric_f(b, "miner_boot_to_first_share_seconds", "gauge",
+                 "Time from boot to the first accepted share", s->boot_to_first_share_ms / 1000.0f);
+    }
+
+    // Per rig
+    family(b, "miner_rig_hashrate_hps", "gauge", "Rig hashrate while hashing, 10 s average");
+    for (int i = 0; i < s->rig_count; i++) {
+        sample_f(b, "miner_rig_hashrate_hps", "rig", s->rigs[i].rig_id, s->rigs[i].hashrate);
+    }
+    family(b, "miner_rig_shares_total", "counter", "Rig shares this boot by outcome");
+    for (int i = 0; i < s->rig_count; i++) {
+        const duco_rig_stats_t *r = &s->rigs[i];
+        static const char *results[] = { "accepted", "rejected" };
+        uint32_t counts[] = { r->shares_accepted, r->shares_rejected };
+        for (int k = 0; k < 2; k++) {
+            put_str(b, "miner_rig_shares_total{rig=\"");
+            put_label_value(b, r->rig_id);
+            put_str(b, "\",result=\"");
+            put_str(b, results[k]);
+            put_str(b, "\"} ");
+            put_u64(b, counts[k]);
+            put_str(b, "\n");
+        }
+    }
+    family(b, "miner_rig_reconnects_total", "counter", "Rig pool reconnects this boot");
+    for (int i = 0; i < s->rig_count; i++) {
+        sample_u(b, "miner_rig_reconnects_total", "rig", s->rigs[i].rig_id, s->rigs[i].reconnects);
+    }
+
+    family(b, "miner_rig_rtt_seconds", "histogram", "Job fetch plus share submit round trip");
+    for (int i = 0; i < s->rig_count; i++) {
+        const duco_rig_stats_t *r = &s->rigs[i];
+        uint64_t cumulative = 0;
+        for (int k = 0; k < DUCO_RTT_BUCKETS; k++) {
+            cumulative += r->rtt_hist[k];
+            put_str(b, "miner_rig_rtt_seconds_bucket{rig=\"");
+            put_label_value(b, r->rig_id);
+            put_str(b, "\",le=\"");
+            if (k < DUCO_RTT_BUCKETS - 1) {
+                put_float(b, duco_rtt_bounds_ms[k] / 1000.0f, 3);
+            } else {
+                put_str(b, "+Inf");
+            }
+            put_str(b, "\"} ");
+            put_u64(b, cumulative);
+            put_str(b, "\n");
+        }
+        sample_f(b, "miner_rig_rtt_seconds_sum", "rig", r->rig_id, r->rtt_sum_ms / 1000.0f);
+        sample_u(b, "miner_rig_rtt_seconds_count", "rig", r->rig_id, cumulative);
+    }
+
+    // Worker responsiveness
+    family(b, "miner_rig_slice_seconds", "gauge", "Hashing slice between worker checks, average");
+    for (int i = 0; i < s->rig_count; i++) {
+        sample_fd(b, "miner_rig_slice_seconds", "rig", s->rigs[i].rig_id,
+                  s->rigs[i].slice_avg_us / 1e6f, 6);
+    }
+    family(b, "miner_rig_slice_max_seconds", "gauge", "Longest hashing slice this boot");
+    for (int i = 0; i < s->rig_count; i++) {
+        sample_fd(b, "miner_rig_slice_max_seconds", "rig", s->rigs[i].rig_id,
+                  s->rigs[i].slice_max_us / 1e6f, 6);
+    }
+    family(b, "miner_rig_slice_overruns_total", "counter", "Slices over twice their target");
+    for (int i = 0; i < s->rig_count; i++) {
+        sample_u(b, "miner_rig_slice_overruns_total", "rig", s->rigs[i].rig_id,
+                 s->rigs[i].slice_overruns);
+    }
+    family(b, "miner_rig_preemptions_total", "counter", "Running jobs dropped for a new connection");
+    for (int i = 0; i < s->rig_count; i++) {
+        sample_u(b, "miner_rig_preemptions_total", "rig", s->rigs[i].rig_id, s->rigs[i].preemptions);
+    }
+    family(b, "miner_rig_preempt_max_seconds", "gauge",
+           "Longest delay from a new connection to the worker dropping its job");
+    for (int i = 0; i < s->rig_count; i++) {
+        sample_fd(b, "miner_rig_preempt_max_seconds", "rig", s->rigs[i].rig_id,
+                  s->rigs[i].preempt_max_us / 1e6f, 6);
+    }
+}
+
+static void render_thermal(mbuf_t *b, const thermal_status_t *t)
+{
+    metric_f(b, "miner_temperature_celsius", "gauge", "Chip temperature, filtered",
+             t->filtered_c);
+    metric_f(b, "miner_thermal_effort_ratio", "gauge",
+             "Throughput allowed by the thermal governor (1 = unthrottled)", t->effort);
+    metric_u(b, "miner_thermal_workers", "gauge", "Hashing workers allowed to run",
+             t->limits.workers);
+    metric_u(b, "miner_thermal_throttled_seconds_total", "counter",
+             "Time spent below full effort", t->throttled_seconds);
+    metric_u(b, "miner_thermal_shutdowns_total", "counter", "Hard temperature limit trips",
+             t->shutdown_count);
+}
+
+static void render_memory(mbuf_t *b, const mem_budget_snapshot_t *m)
+{
+    bool psram = m->psram_total != 0;
+
+    family(b, "miner_heap_size_bytes", "gauge", "Heap size");
+    sample_u(b, "miner_heap_size_bytes", "heap", "internal", m->internal_total);
+    if (psram) {
+        sample_u(b, "miner_heap_size_bytes", "heap", "psram", m->psram_total);
+    }
+    family(b, "miner_heap_free_bytes", "gauge", "Free heap at the last sample");
+    sample_u(b, "miner_heap_free_bytes", "heap", "internal", m->heap.internal_free);
+    if (psram) {
+        sample_u(b, "miner_heap_free_bytes", "heap", "psram", m->heap.psram_free);
+    }
+    family(b, "miner_heap_min_free_bytes", "gauge", "Lowest free heap since boot");
+    sample_u(b, "miner_heap_min_free_bytes", "heap", "internal", m->internal_min_free);
+    if (psram) {
+        sample_u(b, "miner_heap_min_free_bytes", "heap", "psram", m->psram_min_free);
+    }
+    family(b, "miner_heap_largest_free_block_bytes", "gauge",
+           "Largest free block at the last sample");
+    sample_u(b, "miner_heap_largest_free_block_bytes", "heap", "internal",
+             m->heap.internal_largest);
+    if (psram) {
+        sample_u(b, "miner_heap_largest_free_block_bytes", "heap", "psram", m->heap.psram_largest);
+    }
+
+    family(b, "miner_task_stack_size_bytes", "gauge", "Stack each task was created with");
+    for (int i = 0; i < m->task_count; i++) {
+        sample_u(b, "miner_task_stack_size_bytes", "task", m->tasks[i].name, m->tasks[i].stack_size);
+    }
+    family(b, "miner_task_stack_free_min_bytes", "gauge", "Least free stack ever seen");
+    for (int i = 0; i < m->task_count; i++) {
+        sample_u(b, "miner_task_stack_free_min_bytes", "task", m->tasks[i].name,
+                 m->tasks[i].stack_free_min);
+    }
+    family(b, "miner_task_running", "gauge", "1 while the task exists");
+    for (int i = 0; i < m->task_count; i++) {
+        sample_u(b, "miner_task_running", "task", m->tasks[i].name, m->tasks[i].running);
+    }
+}
+
+static void render_pools(mbuf_t *b, const block_pool_stats_t *pools, int count)
+{
+    if (count == 0) {
+        return;
+    }
+    family(b, "miner_pool_blocks", "gauge", "Blocks in each fixed-block pool");
+    for (int i = 0; i < count; i++) {
+        sample_u(b, "miner_pool_blocks", "pool", pools[i].name, pools[i].block_count);
+    }
+    family(b, "miner_pool_blocks_in_use", "gauge", "Blocks currently taken");
+    for (int i = 0; i < count; i++) {
+        sample_u(b, "miner_pool_blocks_in_use", "pool", pools[i].name, pools[i].in_use);
+    }
+    family(b, "miner_pool_alloc_failures_total", "counter", "Requests refused because the pool was empty");
+    for (int i = 0; i < count; i++) {
+        sample_u(b, "miner_pool_alloc_failures_total", "pool", pools[i].name, pools[i].fail_count);
+    }
+}
+
+static void render_wifi(mbuf_t *b, const wifi_status_t *w)
+{
+    metric_u(b, "miner_wifi_connected", "gauge", "1 while the station has an address", w->link_up);
+    if (w->link_up) {
+        family(b, "miner_wifi_rssi_dbm", "gauge", "Signal strength of the current AP");
+        sample(b, "miner_wifi_rssi_dbm", NULL, NULL);
+        if (w->rssi < 0) {
+            put_str(b, "-");
+        }
+        put_u64(b, w->rssi < 0 ? -w->rssi : w->rssi);
+        put_str(b, "\n");
+    }
+    metric_u(b, "miner_wifi_link_losses_total", "counter", "Connections lost since boot",
+             w->link_losses);
+    metric_f(b, "miner_wifi_last_join_seconds", "gauge", "Outage start to address, last rejoin",
+             w->last_join_ms / 1000.0f);
+}
+
+static void render_fleet(mbuf_t *b, const fleet_summary_t *f,
+                         const fleet_device_t *devices, int count)
+{
+    metric_u(b, "miner_fleet_hashrate_hps", "gauge", "Sum of online fleet device hashrates",
+             f->hashrate);
+    family(b, "miner_fleet_devices", "gauge", "Fleet devices by health");
+    sample_u(b, "miner_fleet_devices", "health", "ok", f->online - f->stragglers - f->hot);
+    sample_u(b, "miner_fleet_devices", "health", "straggler", f->stragglers);
+    sample_u(b, "miner_fleet_devices", "health", "hot", f->hot);
+    sample_u(b, "miner_fleet_devices", "health", "offline", f->devices - f->online);
+
+    family(b, "miner_fleet_device_hashrate_hps", "gauge",
+           "Last reported wall clock hashrate per device (health label: ok, straggler, hot, offline)");
+    for (int i = 0; i < count; i++) {
+        static const char hex[] = "0123456789abcdef";
+        const fleet_device_t *dev = &devices[i];
+        char id[13];
+        for (int k = 0; k < 6; k++) {
+            id[k * 2] = hex[dev->report.device_id[k] >> 4];
+            id[k * 2 + 1] = hex[dev->report.device_id[k] & 0xF];
+        }
+        id[12] = '\0';
+
+        put_str(b, "miner_fleet_device_hashrate_hps{id=\"");
+        put_str(b, id);
+        put_str(b, "\",name=\"");
+        put_label_value(b, dev->report.name);
+        put_str(b, "\",health=\"");
+        put_str(b, fleet_health_name(dev->health));
+        put_str(b, "\"} ");
+        put_u64(b, dev->report.hashrate);
+        put_str(b, "\n");
+    }
+}
+
+static void render_touch(mbuf_t *b, const touch_stats_t *t)
+{
+    static const char *types[] = { "press", "move", "release" };
+    family(b, "miner_touch_events_total", "counter", "Touch events queued for the UI by type");
+    for (int i = 0; i < 3; i++) {
+        sample_u(b, "miner_touch_events_total", "type", types[i], t->events[i]);
+    }
+    metric_u(b, "miner_touch_coalesced_total", "counter",
+             "Touch moves superseded before the UI read them", t->coalesced);
+    metric_u(b, "miner_touch_dropped_total", "counter",
+             "Touch presses and releases lost to a full queue", t->dropped);
+    metric_u(b, "miner_touch_i2c_errors_total", "counter", "Failed touch controller reads",
+             t->i2c_errors);
+    // No samples yet would read as zero latency
+    if (t->feedback_count == 0) {
+        return;
+    }
+    metric_fd(b, "miner_touch_feedback_seconds", "gauge",
+              "Touch report to visual feedback, average", t->feedback_avg_us / 1e6f, 6);
+    metric_fd(b, "miner_touch_feedback_max_seconds", "gauge",
+              "Touch report to visual feedback, worst", t->feedback_max_us / 1e6f, 6);
+}
+
+void metrics_collect(metrics_snapshot_t *snap)
+{
+    snap->uptime_s = (uint32_t)(esp_timer_get_time() / 1000000);
+
+    snap->duco_running = duco_miner_is_running();
+    if (snap->duco_running) {
+        duco_miner_get_stats(&snap->duco);
+    }
+
+    snap->thermal_ok = thermal_governor_get_status(&snap->thermal) == ESP_OK &&
+                       snap->thermal.sensor_ok;
+    snap->mem_ok = mem_budget_get(&snap->mem) == ESP_OK;
+    snap->pool_count = (uint8_t)block_pool_get_all_stats(snap->pools, BLOCK_POOL_MAX_POOLS);
+    snap->wifi_ok = wifi_manager_get_status(&snap->wifi) == ESP_OK;
+    dlog_get_stats(&snap->dlog);
+
+    snap->fleet_ok = fleet_is_aggregator();
+    if (snap->fleet_ok) {
+        snap->fleet_count = (uint8_t)fleet_get_devices(snap->fleet_devices, FLEET_MAX_DEVICES,
+                                                       &snap->fleet);
+    }
+    snap->touch_ok = touch_input_get_stats(&snap->touch) == ESP_OK;
+}
+
+size_t metrics_render(const metrics_snapshot_t *snap, char *buf, size_t size)
+{
+    mbuf_t b = { .buf = buf, .len = 0, .size = size, .overflow = false };
+
+    metric_u(&b, "miner_uptime_seconds", "gauge", "Time since boot", snap->uptime_s);
+
+    if (snap->duco_running) {
+        render_duco(&b, &snap->duco);
+    }
+    if (snap->thermal_ok) {
+        render_thermal(&b, &snap->thermal);
+    }
+    if (snap->mem_ok) {
+        render_memory(&b, &snap->mem);
+    }
+    render_pools(&b, snap->pools, snap->pool_count);
+    if (snap->wifi_ok) {
+        render_wifi(&b, &snap->wifi);
+    }
+    if (snap->fleet_ok) {
+        render_fleet(&b, &snap->fleet, snap->fleet_devices, snap->fleet_count);
+    }
+    if (snap->touch_ok) {
+        render_touch(&b, &snap->touch);
+    }
+
+    metric_u(&b, "miner_log_events_dropped_total", "counter",
+             "Deferred log events lost to a full ring", snap->dlog.dropped);
+    metric_u(&b, "miner_metrics_scrapes_total", "counter", "Metrics scrapes served",
+             snap->scrapes);
+    metric_fd(&b, "miner_metrics_render_seconds", "gauge",
+              "Collect and render time of the previous scrape", snap->last_render_us / 1e6f, 6);
+
+    return b.overflow ? 0 : b.len;
+}
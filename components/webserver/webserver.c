@@ -0,0 +1,91 @@
+/**
+ * Web Server Implementation
+ */
+
+#include "webserver.h"
+#include "metrics.h"
+#include "esp_http_server.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "config.h"
+
+static const char *TAG = "WEB";
+
+#ifndef WEB_SERVER_PORT
+#define WEB_SERVER_PORT 80
+#endif
+
+#define WEB_TASK_STACK_SIZE 4096
+#define WEB_TASK_PRIORITY 4     // Above the core 0 worker, below the miner network task
+
+static httpd_handle_t server = NULL;
+
+// The server runs handlers one at a time on its own task, so one snapshot
+// and one output buffer serve every scrape
+static metrics_snapshot_t metrics_snap;
+static char metrics_buf[METRICS_BUFFER_SIZE];
+
+/**
+ * @brief GET /metrics
+ */
+static esp_err_t metrics_handler(httpd_req_t *req)
+{
+    int64_t start = esp_timer_get_time();
+
+    metrics_collect(&metrics_snap);
+    size_t len = metrics_render(&metrics_snap, metrics_buf, sizeof(metrics_buf));
+
+    metrics_snap.last_render_us = (uint32_t)(esp_timer_get_time() - start);
+    metrics_snap.scrapes++;
+
+    if (len == 0) {
+        ESP_LOGE(TAG, "Metrics exceed %d-byte buffer", METRICS_BUFFER_SIZE);
+        return httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Metrics buffer too small");
+    }
+
+    httpd_resp_set_type(req, "text/plain; version=0.0.4; charset=utf-8");
+    return httpd_resp_send(req, metrics_buf, len);
+}
+
+esp_err_t webserver_start(void)
+{
+    if (server != NULL) {
+        return ESP_OK;
+    }
+
+    httpd_config_t config = HTTPD_DEFAULT_CONFIG();
+    config.server_port = WEB_SERVER_PORT;
+    config.core_id = 0;
+    config.task_priority = WEB_TASK_PRIORITY;
+    config.stack_size = WEB_TASK_STACK_SIZE;
+    config.lru_purge_enable = true;
+
+    esp_err_t ret = httpd_start(&server, &config);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to start server: %s", esp_err_to_name(ret));
+        server = NULL;
+        return ret;
+    }
+
+    const httpd_uri_t metrics_uri = {
+        .uri = "/metrics",
+        .method = HTTP_GET,
+        .handler = metrics_handler,
+        .user_ctx = NULL,
+    };
+    httpd_register_uri_handler(server, &metrics_uri);
+
+    ESP_LOGI(TAG, "Listening on port %d (/metrics)", WEB_SERVER_PORT);
+    return ESP_OK;
+}
+
+esp_err_t webserver_stop(void)
+{
+    if (server == NULL) {
+        return ESP_OK;
+    }
+
+    esp_err_t ret = httpd_stop(server);
+    server = NULL;
+    return ret;
+}
@@ -0,0 +1,106 @@
+/**
+ * Wi-Fi Manager
+ *
+ * Event-driven station management: the manager reacts to driver events
+ * instead of polling. Connection policy lives in wifi_sm.c, which covers the
+ * fast rejoin from the cached BSSID/channel/lease in NVS, backoff reconnect
+ * and the setup AP fallback. Subsystems that need the network register a
+ * link callback and pause while the link is down.
+ */
+
+#ifndef WIFI_MANAGER_H
+#define WIFI_MANAGER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "wifi_sm.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define WIFI_MANAGER_MAX_LINK_CBS 4
+
+/**
+ * @brief Link state callback
+ *
+ * Runs on the Wi-Fi manager task; keep it short and non-blocking.
+ *
+ * @param up True when the station has an address
+ * @param arg User argument from registration
+ */
+typedef void (*wifi_link_cb_t)(bool up, void *arg);
+
+// Status snapshot
+typedef struct {
+    wifi_sm_state_t state;
+    bool link_up;
+    bool ap_active;                 // Setup AP running
+    uint32_t ip;                    // Network byte order, 0 when down
+    uint8_t channel;
+    int8_t rssi;
+    uint32_t link_losses;
+    uint32_t fast_joins;            // Joins from the cached BSSID/channel
+    uint32_t last_reason;           // Reason code of the last disconnect
+    uint32_t last_join_ms;          // Outage start to address
+    uint32_t link_uptime_s;
+} wifi_status_t;
+
+/**
+ * @brief Bring up netif, the event loop and the Wi-Fi driver
+ *
+ * Loads the cached association from NVS (NVS must be initialized).
+ *
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t wifi_manager_init(void);
+
+/**
+ * @brief Start the station and the manager task
+ *
+ * Returns immediately; use wifi_manager_wait_connected() or a link
+ * callback to learn when the network is usable.
+ *
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t wifi_manager_start(void);
+
+/**
+ * @brief Block until the station has an address
+ *
+ * @param timeout_ms Maximum wait
+ * @return ESP_OK once connected, ESP_ERR_TIMEOUT otherwise
+ */
+esp_err_t wifi_manager_wait_connected(uint32_t timeout_ms);
+
+/**
+ * @brief Check if the station has an address
+ */
+bool wifi_manager_is_connected(void);
+
+/**
+ * @brief Register a link state callback
+ *
+ * The callback is invoked once right away with the current state, then on
+ * every transition.
+ *
+ * @param cb Callback
+ * @param arg User argument
+ * @return ESP_OK, or ESP_ERR_NO_MEM if all slots are taken
+ */
+esp_err_t wifi_manager_register_link_cb(wifi_link_cb_t cb, void *arg);
+
+/**
+ * @brief Get a status snapshot
+ *
+ * @param status Output
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE before init
+ */
+esp_err_t wifi_manager_get_status(wifi_status_t *status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // WIFI_MANAGER_H
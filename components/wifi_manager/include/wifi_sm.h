@@ -0,0 +1,166 @@
+/**
+ * Wi-Fi Station State Machine
+ *
+ * Connection policy for the station interface, kept free of ESP-IDF calls so
+ * it can be driven on the host against a mocked driver. The Wi-Fi manager
+ * feeds it driver events and a periodic tick; it answers through the driver
+ * callbacks.
+ *
+ * Policy:
+ * - Join with the cached BSSID/channel first (skips the full scan) and,
+ *   when enabled, the cached IP lease (skips DHCP). If a hinted join fails,
+ *   retry at once with a full scan and DHCP.
+ * - Each attempt has a time budget covering association and IP.
+ * - After a failed attempt, wait with exponential backoff. After a drop,
+ *   retry immediately.
+ * - Offline longer than the fallback time: start the setup AP and keep
+ *   retrying the station alongside it. The AP stops once the station is up.
+ * - Report link up/down exactly once per transition.
+ */
+
+#ifndef WIFI_SM_H
+#define WIFI_SM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Station state
+typedef enum {
+    WIFI_SM_IDLE = 0,           // Not started
+    WIFI_SM_CONNECTING,         // Association in progress
+    WIFI_SM_WAIT_IP,            // Associated, waiting for an address
+    WIFI_SM_CONNECTED,          // Got an address - link up
+    WIFI_SM_BACKOFF             // Waiting before the next attempt
+} wifi_sm_state_t;
+
+// IPv4 settings (network byte order, as esp_ip4_addr_t)
+typedef struct {
+    uint32_t ip;
+    uint32_t netmask;
+    uint32_t gw;
+    uint32_t dns;
+} wifi_sm_ip_t;
+
+// Last good association, persisted by the driver for fast rejoin
+typedef struct {
+    uint8_t bssid[6];
+    uint8_t channel;            // 0 = cache empty
+    bool ip_valid;
+    wifi_sm_ip_t ip;
+} wifi_sm_cache_t;
+
+// Driver callbacks - all are required
+typedef struct {
+    /**
+     * @brief Start an association attempt
+     *
+     * @param hint Cached BSSID/channel to join directly, NULL for a full scan
+     * @param static_ip Apply hint->ip instead of running DHCP
+     */
+    void (*connect)(void *ctx, const wifi_sm_cache_t *hint, bool static_ip);
+    void (*disconnect)(void *ctx);
+    void (*start_ap)(void *ctx);
+    void (*stop_ap)(void *ctx);
+    /** @brief Persist the cache (called only when it changed) */
+    void (*save_cache)(void *ctx, const wifi_sm_cache_t *cache);
+    void (*link_changed)(void *ctx, bool up);
+} wifi_sm_driver_t;
+
+// Tunables
+typedef struct {
+    uint32_t attempt_timeout_ms;    // Association + address, per attempt
+    uint32_t backoff_min_ms;
+    uint32_t backoff_max_ms;
+    uint32_t ap_fallback_ms;        // Offline this long before the AP starts
+    bool static_ip;                 // Reuse the cached lease on hinted joins
+} wifi_sm_params_t;
+
+// State machine instance
+typedef struct {
+    wifi_sm_params_t params;
+    const wifi_sm_driver_t *driver;
+    void *ctx;
+
+    wifi_sm_state_t state;
+    wifi_sm_cache_t cache;
+    bool hint_failed;               // Cached BSSID did not work this outage
+    bool attempt_hinted;
+    bool attempt_static;
+    bool disconnect_pending;        // Our own disconnect; swallow its event
+    bool link_up;
+    bool ap_active;
+    uint8_t joined_bssid[6];
+    uint8_t joined_channel;
+
+    int64_t deadline_ms;            // End of attempt budget or backoff
+    int64_t attempt_start_ms;
+    int64_t offline_since_ms;
+    int64_t link_up_ms;
+    uint32_t backoff_ms;
+
+    // Metrics
+    uint32_t attempts;              // Attempts in the current outage
+    uint32_t link_losses;
+    uint32_t fast_joins;            // Hinted joins that succeeded
+    uint32_t last_reason;           // Driver reason code of the last disconnect
+    uint32_t last_join_ms;          // Outage start (or boot) to address
+} wifi_sm_t;
+
+/**
+ * @brief Initialize the state machine
+ *
+ * @param sm Instance
+ * @param params Tunables (copied)
+ * @param driver Driver callbacks (must outlive the instance)
+ * @param ctx Passed to every callback
+ * @param cache Persisted cache, or NULL if none
+ */
+void wifi_sm_init(wifi_sm_t *sm, const wifi_sm_params_t *params,
+                  const wifi_sm_driver_t *driver, void *ctx, const wifi_sm_cache_t *cache);
+
+/**
+ * @brief Start the first attempt
+ */
+void wifi_sm_start(wifi_sm_t *sm, int64_t now_ms);
+
+/**
+ * @brief Driver event: associated with an AP
+ */
+void wifi_sm_on_connected(wifi_sm_t *sm, int64_t now_ms, const uint8_t bssid[6], uint8_t channel);
+
+/**
+ * @brief Driver event: association failed or was lost
+ *
+ * @param reason Driver reason code (kept for status only)
+ */
+void wifi_sm_on_disconnected(wifi_sm_t *sm, int64_t now_ms, uint32_t reason);
+
+/**
+ * @brief Driver event: address acquired
+ */
+void wifi_sm_on_got_ip(wifi_sm_t *sm, int64_t now_ms, const wifi_sm_ip_t *ip);
+
+/**
+ * @brief Driver event: address lost while associated
+ */
+void wifi_sm_on_lost_ip(wifi_sm_t *sm, int64_t now_ms);
+
+/**
+ * @brief Advance timeouts; call periodically
+ */
+void wifi_sm_tick(wifi_sm_t *sm, int64_t now_ms);
+
+/**
+ * @brief Human-readable state name
+ */
+const char *wifi_sm_state_name(wifi_sm_state_t state);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // WIFI_SM_H
@@ -0,0 +1,561 @@
+/**
+ * Wi-Fi Manager Implementation
+ *
+ * Driver events are posted from the default event loop into a queue; one
+ * manager task feeds them to the state machine together with a periodic
+ * tick, so the state machine never needs a lock. The state machine talks
+ * back through the driver callbacks below.
+ */
+
+#include "wifi_manager.h"
+#include "miner_config.h"
+#include "mem_budget.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_wifi.h"
+#include "esp_netif.h"
+#include "esp_event.h"
+#include "nvs.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/event_groups.h"
+#include <string.h>
+
+// Include user configuration
+#include "config.h"
+
+#ifndef WIFI_CONNECT_TIMEOUT_SEC
+#define WIFI_CONNECT_TIMEOUT_SEC 30
+#endif
+
+#ifndef WIFI_ATTEMPT_TIMEOUT_MS
+#define WIFI_ATTEMPT_TIMEOUT_MS 10000
+#endif
+
+#ifndef WIFI_CACHE_STATIC_IP
+#define WIFI_CACHE_STATIC_IP 0
+#endif
+
+#ifndef AP_SSID
+#define AP_SSID "ESP32-Miner-Setup"
+#endif
+
+#ifndef AP_PASSWORD
+#define AP_PASSWORD "duino123"
+#endif
+
+#ifndef AP_MAX_CONNECTIONS
+#define AP_MAX_CONNECTIONS 4
+#endif
+
+static const char *TAG = "WIFI";
+
+#define WIFI_TASK_STACK_SIZE 3072
+#define WIFI_TASK_PRIORITY 4
+#define WIFI_TICK_MS 100
+#define WIFI_EVENT_QUEUE_LEN 8
+#define WIFI_BACKOFF_MIN_MS 1000
+#define WIFI_BACKOFF_MAX_MS 30000
+#define WIFI_CONNECTED_BIT BIT0
+
+#define NVS_NAMESPACE "wifi_mgr"
+#define NVS_KEY_CACHE "cache"
+#define CACHE_VERSION 1
+
+// Events forwarded from the default event loop
+typedef enum {
+    WIFI_MGR_EV_STA_START = 0,
+    WIFI_MGR_EV_CONNECTED,
+    WIFI_MGR_EV_DISCONNECTED,
+    WIFI_MGR_EV_GOT_IP,
+    WIFI_MGR_EV_LOST_IP
+} wifi_mgr_event_type_t;
+
+typedef struct {
+    wifi_mgr_event_type_t type;
+    union {
+        struct {
+            uint8_t bssid[6];
+            uint8_t channel;
+        } connected;
+        uint32_t reason;
+        wifi_sm_ip_t ip;
+    };
+} wifi_mgr_event_t;
+
+// Cache as stored in NVS - bound to the SSID it was learned on
+typedef struct {
+    uint32_t version;
+    char ssid[32];
+    wifi_sm_cache_t cache;
+} wifi_cache_record_t;
+
+typedef struct {
+    wifi_link_cb_t cb;
+    void *arg;
+} link_cb_slot_t;
+
+static bool initialized = false;
+static esp_netif_t *sta_netif = NULL;
+static TaskHandle_t manager_task = NULL;
+static QueueHandle_t event_queue = NULL;
+static EventGroupHandle_t link_bits = NULL;
+static wifi_sm_t sm;                            // Manager task only
+
+// Shared with other tasks
+static portMUX_TYPE status_lock = portMUX_INITIALIZER_UNLOCKED;
+static wifi_status_t status;
+static int64_t status_link_up_ms;
+static link_cb_slot_t link_cbs[WIFI_MANAGER_MAX_LINK_CBS];
+
+static int64_t now_ms(void)
+{
+    return esp_timer_get_time() / 1000;
+}
+
+// ---------------------------------------------------------------------------
+// Driver callbacks for the state machine
+// ---------------------------------------------------------------------------
+
+static void drv_connect(void *ctx, const wifi_sm_cache_t *hint, bool static_ip)
+{
+    const miner_config_t *config = config_get_current();
+    if (config == NULL) {
+        return;
+    }
+
+    wifi_config_t wifi_config = {0};
+    strncpy((char *)wifi_config.sta.ssid, config->wifi_ssid, sizeof(wifi_config.sta.ssid));
+    wifi_config.sta.ssid[sizeof(wifi_config.sta.ssid) - 1] = '\0';
+    strncpy((char *)wifi_config.sta.password, config->wifi_password, sizeof(wifi_config.sta.password));
+    wifi_config.sta.password[sizeof(wifi_config.sta.password) - 1] = '\0';
+
+    if (hint != NULL) {
+        // Join the last AP directly instead of scanning every channel
+        wifi_config.sta.bssid_set = true;
+        memcpy(wifi_config.sta.bssid, hint->bssid, sizeof(wifi_config.sta.bssid));
+        wifi_config.sta.channel = hint->channel;
+    }
+
+    if (static_ip) {
+        esp_netif_dhcpc_stop(sta_netif);
+        esp_netif_ip_info_t info = {
+            .ip.addr = hint->ip.ip,
+            .netmask.addr = hint->ip.netmask,
+            .gw.addr = hint->ip.gw,
+        };
+        esp_netif_set_ip_info(sta_netif, &info);
+        if (hint->ip.dns != 0) {
+            esp_netif_dns_info_t dns = { .ip.u_addr.ip4.addr = hint->ip.dns };
+            esp_netif_set_dns_info(sta_netif, ESP_NETIF_DNS_MAIN, &dns);
+        }
+    } else {
+        // Already running is fine
+        esp_netif_dhcpc_start(sta_netif);
+    }
+
+    esp_err_t ret = esp_wifi_set_config(WIFI_IF_STA, &wifi_config);
+    if (ret == ESP_OK) {
+        ret = esp_wifi_connect();
+    }
+    if (ret != ESP_OK) {
+        // The attempt budget expires and the state machine moves on
+        ESP_LOGW(TAG, "Connect request failed: %s", esp_err_to_name(ret));
+        return;
+    }
+
+    ESP_LOGI(TAG, "Connecting to %s%s%s...", config->wifi_ssid,
+             hint != NULL ? " (cached AP)" : "", static_ip ? " with cached lease" : "");
+}
+
+static void drv_disconnect(void *ctx)
+{
+    esp_wifi_disconnect();
+}
+
+static void drv_start_ap(void *ctx)
+{
+    wifi_config_t ap_config = {
+        .ap = {
+            .ssid_len = strlen(AP_SSID),
+            .max_connection = AP_MAX_CONNECTIONS,
+            .authmode = strlen(AP_PASSWORD) > 0 ? WIFI_AUTH_WPA2_PSK : WIFI_AUTH_OPEN,
+        },
+    };
+    strncpy((char *)ap_config.ap.ssid, AP_SSID, sizeof(ap_config.ap.ssid));
+    strncpy((char *)ap_config.ap.password, AP_PASSWORD, sizeof(ap_config.ap.password) - 1);
+
+    // AP+STA keeps the station retrying while the AP is up
+    esp_err_t ret = esp_wifi_set_mode(WIFI_MODE_APSTA);
+    if (ret == ESP_OK) {
+        ret = esp_wifi_set_config(WIFI_IF_AP, &ap_config);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to start setup AP: %s", esp_err_to_name(ret));
+        return;
+    }
+    // No provisioning page is served yet - credentials still come from config.h
+    ESP_LOGW(TAG, "No network for %d s - fallback AP \"%s\" started; check WIFI_SSID/WIFI_PASSWORD in config.h",
+             WIFI_CONNECT_TIMEOUT_SEC, AP_SSID);
+}
+
+static void drv_stop_ap(void *ctx)
+{
+    if (esp_wifi_set_mode(WIFI_MODE_STA) == ESP_OK) {
+        ESP_LOGI(TAG, "Station connected - setup AP stopped");
+    }
+}
+
+static void drv_save_cache(void *ctx, const wifi_sm_cache_t *cache)
+{
+    nvs_handle_t nvs_handle;
+    esp_err_t ret = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &nvs_handle);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to open NVS: %s", esp_err_to_name(ret));
+        return;
+    }
+
+    const miner_config_t *config = config_get_current();
+    wifi_cache_record_t record = {
+        .version = CACHE_VERSION,
+        .cache = *cache,
+    };
+    if (config != NULL) {
+        strncpy(record.ssid, config->wifi_ssid, sizeof(record.ssid) - 1);
+    }
+
+    ret = nvs_set_blob(nvs_handle, NVS_KEY_CACHE, &record, sizeof(record));
+    if (ret == ESP_OK) {
+        ret = nvs_commit(nvs_handle);
+    }
+    nvs_close(nvs_handle);
+
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to save AP cache: %s", esp_err_to_name(ret));
+    } else {
+        ESP_LOGI(TAG, "Cached AP %02x:%02x:%02x:%02x:%02x:%02x on channel %u",
+                 cache->bssid[0], cache->bssid[1], cache->bssid[2],
+                 cache->bssid[3], cache->bssid[4], cache->bssid[5], cache->channel);
+    }
+}
+
+static void drv_link_changed(void *ctx, bool up)
+{
+    link_cb_slot_t cbs[WIFI_MANAGER_MAX_LINK_CBS];
+
+    if (up) {
+        xEventGroupSetBits(link_bits, WIFI_CONNECTED_BIT);
+        ESP_LOGI(TAG, "Link up after %lu ms", (unsigned long)sm.last_join_ms);
+    } else {
+        xEventGroupClearBits(link_bits, WIFI_CONNECTED_BIT);
+        ESP_LOGW(TAG, "Link down (reason %lu)", (unsigned long)sm.last_reason);
+    }
+
+    portENTER_CRITICAL(&status_lock);
+    status.link_up = up;
+    memcpy(cbs, link_cbs, sizeof(cbs));
+    portEXIT_CRITICAL(&status_lock);
+
+    for (int i = 0; i < WIFI_MANAGER_MAX_LINK_CBS; i++) {
+        if (cbs[i].cb != NULL) {
+            cbs[i].cb(up, cbs[i].arg);
+        }
+    }
+}
+
+static const wifi_sm_driver_t driver = {
+    .connect = drv_connect,
+    .disconnect = drv_disconnect,
+    .start_ap = drv_start_ap,
+    .stop_ap = drv_stop_ap,
+    .save_cache = drv_save_cache,
+    .link_changed = drv_link_changed,
+};
+
+// ---------------------------------------------------------------------------
+// Event plumbing
+// ---------------------------------------------------------------------------
+
+/**
+ * @brief Default event loop handler - forward to the manager task
+ */
+static void wifi_event_handler(void *arg, esp_event_base_t base, int32_t id, void *data)
+{
+    wifi_mgr_event_t ev;
+
+    if (base == WIFI_EVENT && id == WIFI_EVENT_STA_START) {
+        ev.type = WIFI_MGR_EV_STA_START;
+    } else if (base == WIFI_EVENT && id == WIFI_EVENT_STA_CONNECTED) {
+        const wifi_event_sta_connected_t *info = data;
+        ev.type = WIFI_MGR_EV_CONNECTED;
+        memcpy(ev.connected.bssid, info->bssid, sizeof(ev.connected.bssid));
+        ev.connected.channel = info->channel;
+    } else if (base == WIFI_EVENT && id == WIFI_EVENT_STA_DISCONNECTED) {
+        const wifi_event_sta_disconnected_t *info = data;
+        ev.type = WIFI_MGR_EV_DISCONNECTED;
+        ev.reason = info->reason;
+    } else if (base == IP_EVENT && id == IP_EVENT_STA_GOT_IP) {
+        const ip_event_got_ip_t *info = data;
+        esp_netif_dns_info_t dns = {0};
+        esp_netif_get_dns_info(sta_netif, ESP_NETIF_DNS_MAIN, &dns);
+        ev.type = WIFI_MGR_EV_GOT_IP;
+        ev.ip.ip = info->ip_info.ip.addr;
+        ev.ip.netmask = info->ip_info.netmask.addr;
+        ev.ip.gw = info->ip_info.gw.addr;
+        ev.ip.dns = dns.ip.u_addr.ip4.addr;
+    } else if (base == IP_EVENT && id == IP_EVENT_STA_LOST_IP) {
+        ev.type = WIFI_MGR_EV_LOST_IP;
+    } else {
+        return;
+    }
+
+    if (xQueueSend(event_queue, &ev, 0) != pdTRUE) {
+        // Attempt timeouts recover from a lost event
+        ESP_LOGW(TAG, "Event queue full - event %d dropped", ev.type);
+    }
+}
+
+/**
+ * @brief Copy state machine fields other tasks may read
+ */
+static void wifi_publish_status(void)
+{
+    portENTER_CRITICAL(&status_lock);
+    status.state = sm.state;
+    status.ap_active = sm.ap_active;
+    status.ip = sm.link_up ? sm.cache.ip.ip : 0;
+    status.channel = sm.link_up ? sm.joined_channel : 0;
+    status.link_losses = sm.link_losses;
+    status.fast_joins = sm.fast_joins;
+    status.last_reason = sm.last_reason;
+    status.last_join_ms = sm.last_join_ms;
+    status_link_up_ms = sm.link_up_ms;
+    portEXIT_CRITICAL(&status_lock);
+}
+
+/**
+ * @brief Manager task - the only caller of the state machine
+ */
+static void wifi_manager_task(void *param)
+{
+    wifi_sm_state_t last_state = sm.state;
+
+    while (1) {
+        wifi_mgr_event_t ev;
+        if (xQueueReceive(event_queue, &ev, pdMS_TO_TICKS(WIFI_TICK_MS)) == pdTRUE) {
+            int64_t now = now_ms();
+            switch (ev.type) {
+                case WIFI_MGR_EV_STA_START:
+                    wifi_sm_start(&sm, now);
+                    break;
+                case WIFI_MGR_EV_CONNECTED:
+                    wifi_sm_on_connected(&sm, now, ev.connected.bssid, ev.connected.channel);
+                    break;
+                case WIFI_MGR_EV_DISCONNECTED:
+                    wifi_sm_on_disconnected(&sm, now, ev.reason);
+                    break;
+                case WIFI_MGR_EV_GOT_IP:
+                    wifi_sm_on_got_ip(&sm, now, &ev.ip);
+                    break;
+                case WIFI_MGR_EV_LOST_IP:
+                    wifi_sm_on_lost_ip(&sm, now);
+                    break;
+            }
+        }
+        wifi_sm_tick(&sm, now_ms());
+
+        if (sm.state != last_state) {
+            ESP_LOGD(TAG, "State: %s -> %s", wifi_sm_state_name(last_state),
+                     wifi_sm_state_name(sm.state));
+            last_state = sm.state;
+        }
+        wifi_publish_status();
+    }
+}
+
+/**
+ * @brief Load the cached association for the configured SSID
+ */
+static bool wifi_load_cache(const miner_config_t *config, wifi_sm_cache_t *cache)
+{
+    nvs_handle_t nvs_handle;
+    if (nvs_open(NVS_NAMESPACE, NVS_READONLY, &nvs_handle) != ESP_OK) {
+        return false;
+    }
+
+    wifi_cache_record_t record;
+    size_t size = sizeof(record);
+    esp_err_t ret = nvs_get_blob(nvs_handle, NVS_KEY_CACHE, &record, &size);
+    nvs_close(nvs_handle);
+
+    if (ret != ESP_OK || size != sizeof(record) || record.version != CACHE_VERSION) {
+        return false;
+    }
+    record.ssid[sizeof(record.ssid) - 1] = '\0';
+    if (config == NULL || strncmp(record.ssid, config->wifi_ssid, sizeof(record.ssid) - 1) != 0) {
+        ESP_LOGI(TAG, "SSID changed - ignoring cached AP");
+        return false;
+    }
+
+    *cache = record.cache;
+    return true;
+}
+
+esp_err_t wifi_manager_init(void)
+{
+    if (initialized) {
+        return ESP_OK;
+    }
+
+    esp_err_t ret = esp_netif_init();
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to initialize netif: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    ret = esp_event_loop_create_default();
+    if (ret != ESP_OK && ret != ESP_ERR_INVALID_STATE) {
+        ESP_LOGE(TAG, "Failed to create event loop: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    sta_netif = esp_netif_create_default_wifi_sta();
+    esp_netif_create_default_wifi_ap();
+
+    wifi_init_config_t cfg = WIFI_INIT_CONFIG_DEFAULT();
+    ret = esp_wifi_init(&cfg);
+    if (ret == ESP_OK) {
+        ret = esp_wifi_set_mode(WIFI_MODE_STA);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to initialize WiFi driver: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    event_queue = xQueueCreate(WIFI_EVENT_QUEUE_LEN, sizeof(wifi_mgr_event_t));
+    link_bits = xEventGroupCreate();
+    if (event_queue == NULL || link_bits == NULL) {
+        ESP_LOGE(TAG, "Failed to allocate event queue");
+        return ESP_ERR_NO_MEM;
+    }
+
+    esp_event_handler_register(WIFI_EVENT, ESP_EVENT_ANY_ID, wifi_event_handler, NULL);
+    esp_event_handler_register(IP_EVENT, IP_EVENT_STA_GOT_IP, wifi_event_handler, NULL);
+    esp_event_handler_register(IP_EVENT, IP_EVENT_STA_LOST_IP, wifi_event_handler, NULL);
+
+    const wifi_sm_params_t params = {
+        .attempt_timeout_ms = WIFI_ATTEMPT_TIMEOUT_MS,
+        .backoff_min_ms = WIFI_BACKOFF_MIN_MS,
+        .backoff_max_ms = WIFI_BACKOFF_MAX_MS,
+        .ap_fallback_ms = WIFI_CONNECT_TIMEOUT_SEC * 1000,
+        .static_ip = WIFI_CACHE_STATIC_IP,
+    };
+    wifi_sm_cache_t cache;
+    bool cached = wifi_load_cache(config_get_current(), &cache);
+    wifi_sm_init(&sm, &params, &driver, NULL, cached ? &cache : NULL);
+    if (cached) {
+        ESP_LOGI(TAG, "Cached AP on channel %u - trying fast rejoin first", cache.channel);
+    }
+
+    initialized = true;
+    wifi_publish_status();
+    return ESP_OK;
+}
+
+esp_err_t wifi_manager_start(void)
+{
+    if (!initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (manager_task != NULL) {
+        return ESP_OK;
+    }
+
+    BaseType_t created = xTaskCreatePinnedToCore(
+        wifi_manager_task,
+        "wifi_mgr",
+        WIFI_TASK_STACK_SIZE,
+        NULL,
+        WIFI_TASK_PRIORITY,
+        &manager_task,
+        0      // Core 0 with the rest of the network stack
+    );
+    if (created != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create manager task");
+        manager_task = NULL;
+        return ESP_FAIL;
+    }
+    mem_budget_register_task(manager_task, WIFI_TASK_STACK_SIZE);
+
+    // STA_START kicks off the first attempt on the manager task
+    esp_err_t ret = esp_wifi_start();
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to start WiFi: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    return ESP_OK;
+}
+
+esp_err_t wifi_manager_wait_connected(uint32_t timeout_ms)
+{
+    if (!initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    EventBits_t bits = xEventGroupWaitBits(link_bits, WIFI_CONNECTED_BIT, pdFALSE, pdTRUE,
+                                           pdMS_TO_TICKS(timeout_ms));
+    return (bits & WIFI_CONNECTED_BIT) ? ESP_OK : ESP_ERR_TIMEOUT;
+}
+
+bool wifi_manager_is_connected(void)
+{
+    return initialized && (xEventGroupGetBits(link_bits) & WIFI_CONNECTED_BIT) != 0;
+}
+
+esp_err_t wifi_manager_register_link_cb(wifi_link_cb_t cb, void *arg)
+{
+    int slot = -1;
+    bool up;
+
+    portENTER_CRITICAL(&status_lock);
+    for (int i = 0; i < WIFI_MANAGER_MAX_LINK_CBS; i++) {
+        if (link_cbs[i].cb == NULL) {
+            link_cbs[i].cb = cb;
+            link_cbs[i].arg = arg;
+            slot = i;
+            break;
+        }
+    }
+    up = status.link_up;
+    portEXIT_CRITICAL(&status_lock);
+
+    if (slot < 0) {
+        return ESP_ERR_NO_MEM;
+    }
+    cb(up, arg);
+    return ESP_OK;
+}
+
+esp_err_t wifi_manager_get_status(wifi_status_t *out)
+{
+    if (!initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    int64_t link_up_ms;
+    portENTER_CRITICAL(&status_lock);
+    *out = status;
+    link_up_ms = status_link_up_ms;
+    portEXIT_CRITICAL(&status_lock);
+
+    out->rssi = 0;
+    out->link_uptime_s = 0;
+    if (out->link_up) {
+        wifi_ap_record_t ap_info;
+        if (esp_wifi_sta_get_ap_info(&ap_info) == ESP_OK) {
+            out->rssi = ap_info.rssi;
+        }
+        out->link_uptime_s = (uint32_t)((now_ms() - link_up_ms) / 1000);
+    }
+    return ESP_OK;
+}
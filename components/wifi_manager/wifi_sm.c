@@ -0,0 +1,234 @@
+/**
+ * Wi-Fi Station State Machine Implementation
+ */
+
+#include "wifi_sm.h"
+#include <string.h>
+
+/**
+ * @brief Begin an association attempt, hinted while the cache is trusted
+ */
+static void sm_begin_attempt(wifi_sm_t *sm, int64_t now_ms)
+{
+    sm->attempt_hinted = sm->cache.channel != 0 && !sm->hint_failed;
+    sm->attempt_static = sm->attempt_hinted && sm->params.static_ip && sm->cache.ip_valid;
+    sm->attempts++;
+    sm->attempt_start_ms = now_ms;
+    sm->deadline_ms = now_ms + sm->params.attempt_timeout_ms;
+    sm->state = WIFI_SM_CONNECTING;
+
+    sm->driver->connect(sm->ctx, sm->attempt_hinted ? &sm->cache : NULL, sm->attempt_static);
+}
+
+/**
+ * @brief Start the setup AP once the outage has lasted long enough
+ */
+static void sm_check_fallback(wifi_sm_t *sm, int64_t now_ms)
+{
+    if (!sm->link_up && !sm->ap_active &&
+        now_ms - sm->offline_since_ms >= (int64_t)sm->params.ap_fallback_ms) {
+        sm->ap_active = true;
+        sm->driver->start_ap(sm->ctx);
+    }
+}
+
+/**
+ * @brief The current attempt failed - retry unhinted at once, or back off
+ */
+static void sm_attempt_failed(wifi_sm_t *sm, int64_t now_ms)
+{
+    sm_check_fallback(sm, now_ms);
+
+    if (sm->attempt_hinted) {
+        // The AP may have moved channel or been replaced; scan instead
+        sm->hint_failed = true;
+        sm_begin_attempt(sm, now_ms);
+        return;
+    }
+
+    sm->state = WIFI_SM_BACKOFF;
+    sm->deadline_ms = now_ms + sm->backoff_ms;
+    sm->backoff_ms = sm->backoff_ms * 2 > sm->params.backoff_max_ms ?
+                     sm->params.backoff_max_ms : sm->backoff_ms * 2;
+}
+
+/**
+ * @brief Compare caches field by field (the struct has padding)
+ */
+static bool sm_cache_equal(const wifi_sm_cache_t *a, const wifi_sm_cache_t *b)
+{
+    return memcmp(a->bssid, b->bssid, sizeof(a->bssid)) == 0 &&
+           a->channel == b->channel &&
+           a->ip_valid == b->ip_valid &&
+           a->ip.ip == b->ip.ip && a->ip.netmask == b->ip.netmask &&
+           a->ip.gw == b->ip.gw && a->ip.dns == b->ip.dns;
+}
+
+/**
+ * @brief Report link down and open a new outage
+ */
+static void sm_link_lost(wifi_sm_t *sm, int64_t now_ms)
+{
+    sm->link_up = false;
+    sm->link_losses++;
+    sm->offline_since_ms = now_ms;
+    sm->attempts = 0;
+    sm->backoff_ms = sm->params.backoff_min_ms;
+    sm->hint_failed = false;
+    sm->driver->link_changed(sm->ctx, false);
+}
+
+void wifi_sm_init(wifi_sm_t *sm, const wifi_sm_params_t *params,
+                  const wifi_sm_driver_t *driver, void *ctx, const wifi_sm_cache_t *cache)
+{
+    memset(sm, 0, sizeof(*sm));
+    sm->params = *params;
+    sm->driver = driver;
+    sm->ctx = ctx;
+    sm->state = WIFI_SM_IDLE;
+    sm->backoff_ms = params->backoff_min_ms;
+    if (cache != NULL) {
+        sm->cache = *cache;
+    }
+}
+
+void wifi_sm_start(wifi_sm_t *sm, int64_t now_ms)
+{
+    if (sm->state != WIFI_SM_IDLE) {
+        return;
+    }
+    sm->offline_since_ms = now_ms;
+    sm_begin_attempt(sm, now_ms);
+}
+
+void wifi_sm_on_connected(wifi_sm_t *sm, int64_t now_ms, const uint8_t bssid[6], uint8_t channel)
+{
+    if (sm->state != WIFI_SM_CONNECTING) {
+        return;
+    }
+    memcpy(sm->joined_bssid, bssid, sizeof(sm->joined_bssid));
+    sm->joined_channel = channel;
+    sm->state = WIFI_SM_WAIT_IP;
+}
+
+void wifi_sm_on_disconnected(wifi_sm_t *sm, int64_t now_ms, uint32_t reason)
+{
+    if (sm->disconnect_pending) {
+        // Result of our own timeout disconnect - already handled
+        sm->disconnect_pending = false;
+        return;
+    }
+    sm->last_reason = reason;
+
+    switch (sm->state) {
+        case WIFI_SM_CONNECTED:
+            // Dropped after working - rejoin straight away with the hint
+            sm_link_lost(sm, now_ms);
+            sm_begin_attempt(sm, now_ms);
+            break;
+
+        case WIFI_SM_CONNECTING:
+        case WIFI_SM_WAIT_IP:
+            sm_attempt_failed(sm, now_ms);
+            break;
+
+        default:
+            break;
+    }
+}
+
+void wifi_sm_on_got_ip(wifi_sm_t *sm, int64_t now_ms, const wifi_sm_ip_t *ip)
+{
+    // Some drivers report the address before the association event
+    if (sm->state != WIFI_SM_WAIT_IP && sm->state != WIFI_SM_CONNECTING) {
+        return;
+    }
+
+    if (sm->attempt_hinted) {
+        sm->fast_joins++;
+        if (sm->state == WIFI_SM_CONNECTING) {
+            memcpy(sm->joined_bssid, sm->cache.bssid, sizeof(sm->joined_bssid));
+            sm->joined_channel = sm->cache.channel;
+        }
+    }
+
+    sm->state = WIFI_SM_CONNECTED;
+    sm->deadline_ms = 0;
+    sm->link_up = true;
+    sm->link_up_ms = now_ms;
+    sm->last_join_ms = (uint32_t)(now_ms - sm->offline_since_ms);
+    sm->attempts = 0;
+    sm->backoff_ms = sm->params.backoff_min_ms;
+    sm->hint_failed = false;
+
+    // Persist only when something changed - NVS writes wear flash
+    wifi_sm_cache_t fresh = {
+        .channel = sm->joined_channel,
+        .ip_valid = true,
+        .ip = *ip,
+    };
+    memcpy(fresh.bssid, sm->joined_bssid, sizeof(fresh.bssid));
+    if (fresh.channel != 0 && !sm_cache_equal(&fresh, &sm->cache)) {
+        sm->cache = fresh;
+        sm->driver->save_cache(sm->ctx, &sm->cache);
+    }
+
+    if (sm->ap_active) {
+        sm->ap_active = false;
+        sm->driver->stop_ap(sm->ctx);
+    }
+    sm->driver->link_changed(sm->ctx, true);
+}
+
+void wifi_sm_on_lost_ip(wifi_sm_t *sm, int64_t now_ms)
+{
+    if (sm->state != WIFI_SM_CONNECTED) {
+        return;
+    }
+
+    // Still associated; give DHCP one attempt budget to recover the lease
+    sm_link_lost(sm, now_ms);
+    sm->attempt_hinted = false;
+    sm->attempt_static = false;
+    sm->attempt_start_ms = now_ms;
+    sm->deadline_ms = now_ms + sm->params.attempt_timeout_ms;
+    sm->state = WIFI_SM_WAIT_IP;
+}
+
+void wifi_sm_tick(wifi_sm_t *sm, int64_t now_ms)
+{
+    switch (sm->state) {
+        case WIFI_SM_CONNECTING:
+        case WIFI_SM_WAIT_IP:
+            if (now_ms >= sm->deadline_ms) {
+                sm->disconnect_pending = true;
+                sm->driver->disconnect(sm->ctx);
+                sm_attempt_failed(sm, now_ms);
+            } else {
+                sm_check_fallback(sm, now_ms);
+            }
+            break;
+
+        case WIFI_SM_BACKOFF:
+            sm_check_fallback(sm, now_ms);
+            if (now_ms >= sm->deadline_ms) {
+                sm_begin_attempt(sm, now_ms);
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+const char *wifi_sm_state_name(wifi_sm_state_t state)
+{
+    switch (state) {
+        case WIFI_SM_IDLE: return "idle";
+        case WIFI_SM_CONNECTING: return "connecting";
+        case WIFI_SM_WAIT_IP: return "waiting for IP";
+        case WIFI_SM_CONNECTED: return "connected";
+        case WIFI_SM_BACKOFF: return "backoff";
+        default: return "unknown";
+    }
+}
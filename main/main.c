@@ -13,14 +13,35 @@
 #include "freertos/task.h"
 #include "esp_log.h"
 #include "esp_system.h"
-#include "esp_wifi.h"
-#include "esp_event.h"
 #include "nvs_flash.h"
+#include "wifi_manager.h"
 #include "miner_config.h"
 #include "duinocoin_miner.h"
+#include "thermal_governor.h"
+#include "stats_journal.h"
+#include "mem_budget.h"
+#include "dlog.h"
+#include "boot_metrics.h"
+#include "webserver.h"
+#include "fleet.h"
+#include "touch_input.h"
+#include "ui_action.h"
+#include "touch_ui.h"
 
 static const char *TAG = "MAIN";
-static bool wifi_connected = false;
+
+#define MEM_REPORT_EVERY 20     // Stats passes (30 s each) between memory reports
+
+/**
+ * @brief Network link changes - pause the Duino-Coin miner while down
+ */
+static void link_cb(bool up, void *arg)
+{
+    if (up) {
+        boot_metrics_mark(BOOT_STAGE_LINK_UP);
+    }
+    duco_miner_set_link(up);
+}
 
 void app_main(void)
 {
@@ -38,6 +59,17 @@ void app_main(void)
     }
     ESP_ERROR_CHECK(ret);
     ESP_LOGI(TAG, "NVS initialized");
+    boot_metrics_mark(BOOT_STAGE_NVS);
+
+    // Start memory budget sampling before the other subsystems allocate
+    if (mem_budget_init() == ESP_OK) {
+        mem_budget_register_task(NULL, CONFIG_ESP_MAIN_TASK_STACK_SIZE);
+    }
+
+    // Hot-path log lines are formatted here instead of on the mining tasks
+    if (dlog_init() != ESP_OK) {
+        ESP_LOGW(TAG, "Deferred logging unavailable - hot-path events will be discarded");
+    }
 
     // Load configuration
     ret = config_init();
@@ -49,6 +81,38 @@ void app_main(void)
         }
     }
 
+    boot_metrics_mark(BOOT_STAGE_CONFIG);
+
+    // Start associating now; everything below runs while WiFi connects.
+    // Nothing waits for the link - the miner is told when it comes up.
+    ESP_LOGI(TAG, "Initializing WiFi...");
+    ret = wifi_manager_init();
+    if (ret == ESP_OK) {
+        // The miner holds off connecting until the callback reports an IP
+        wifi_manager_register_link_cb(link_cb, NULL);
+        duco_miner_set_link(wifi_manager_is_connected());
+        ret = wifi_manager_start();
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "WiFi unavailable: %s", esp_err_to_name(ret));
+    } else {
+        boot_metrics_mark(BOOT_STAGE_WIFI_STARTED);
+
+        // Prometheus scrapes work as soon as the link comes up
+        if (webserver_start() != ESP_OK) {
+            ESP_LOGW(TAG, "Web server unavailable - no /metrics endpoint");
+        }
+        if (fleet_start() != ESP_OK) {
+            ESP_LOGW(TAG, "Fleet reporting unavailable");
+        }
+    }
+
+    // Recover lifetime stats before any miner starts counting
+    ret = stats_journal_init();
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Stats journal unavailable: %s", esp_err_to_name(ret));
+    }
+
     // Print current configuration (for debugging)
     config_print();
 
@@ -67,49 +131,15 @@ void app_main(void)
         ESP_LOGI(TAG, "Configuration is valid");
     }
 
-    // Initialize WiFi (simple station mode for now)
-    ESP_LOGI(TAG, "Initializing WiFi...");
-    ESP_ERROR_CHECK(esp_netif_init());
-    ESP_ERROR_CHECK(esp_event_loop_create_default());
-    esp_netif_create_default_wifi_sta();
-
-    wifi_init_config_t cfg = WIFI_INIT_CONFIG_DEFAULT();
-    ESP_ERROR_CHECK(esp_wifi_init(&cfg));
-    ESP_ERROR_CHECK(esp_wifi_set_mode(WIFI_MODE_STA));
-
-    wifi_config_t wifi_config = {0};
-    strncpy((char *)wifi_config.sta.ssid, config->wifi_ssid, sizeof(wifi_config.sta.ssid));
-    wifi_config.sta.ssid[sizeof(wifi_config.sta.ssid) - 1] = '\0';
-    strncpy((char *)wifi_config.sta.password, config->wifi_password, sizeof(wifi_config.sta.password));
-    wifi_config.sta.password[sizeof(wifi_config.sta.password) - 1] = '\0';
-
-    ESP_ERROR_CHECK(esp_wifi_set_config(WIFI_IF_STA, &wifi_config));
-    ESP_ERROR_CHECK(esp_wifi_start());
-
-    ESP_LOGI(TAG, "Connecting to WiFi SSID: %s...", config->wifi_ssid);
-    ESP_ERROR_CHECK(esp_wifi_connect());
-
-    // Wait for WiFi connection (simple blocking wait for now)
-    ESP_LOGI(TAG, "Waiting for WiFi connection (30 seconds)...");
-    for (int i = 0; i < 30; i++) {
-        wifi_ap_record_t ap_info;
-        if (esp_wifi_sta_get_ap_info(&ap_info) == ESP_OK) {
-            wifi_connected = true;
-            ESP_LOGI(TAG, "WiFi connected! IP will be assigned soon");
-            break;
-        }
-        vTaskDelay(pdMS_TO_TICKS(1000));
-        ESP_LOGI(TAG, "Waiting... %d/30", i + 1);
+    // Start thermal governor before any hashing begins
+    ret = thermal_governor_init();
+    if (ret == ESP_OK) {
+        ret = thermal_governor_start();
     }
-
-    if (!wifi_connected) {
-        ESP_LOGW(TAG, "WiFi connection failed, but continuing anyway...");
-        ESP_LOGW(TAG, "Mining may not work without network!");
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Thermal governor not running - mining unthrottled");
     }
 
-    // Give DHCP time to assign IP
-    vTaskDelay(pdMS_TO_TICKS(3000));
-
     // Initialize Duino-Coin miner if in DUCO mode
     if (config->active_mode == MINING_MODE_DUINOCOIN) {
         ESP_LOGI(TAG, "Initializing Duino-Coin miner...");
@@ -129,29 +159,119 @@ void app_main(void)
         ESP_LOGI(TAG, "Bitcoin mode not implemented yet");
     }
 
+    // Touch comes up after mining so probing the panel never delays the first hash
+    if (ui_action_start() != ESP_OK) {
+        ESP_LOGW(TAG, "UI action worker unavailable");
+    }
+    if (touch_input_start() != ESP_OK) {
+        ESP_LOGW(TAG, "Touch input unavailable");
+    } else if (touch_ui_start() != ESP_OK) {
+        // Nothing drains the ring without the dispatcher
+        ESP_LOGW(TAG, "Touch dispatcher unavailable - stopping touch input");
+        touch_input_stop();
+    }
+
     ESP_LOGI(TAG, "Initialization complete - entering main loop");
     ESP_LOGI(TAG, "Current mode: %s",
              config->active_mode == MINING_MODE_BITCOIN ? "Bitcoin" : "Duino-Coin");
 
     // Main loop - print stats every 30 seconds
+    uint32_t passes = 0;
+    bool boot_logged = false;
     while (1) {
         vTaskDelay(pdMS_TO_TICKS(30000));
 
+        // Full startup timeline once the first share has been accepted
+        if (!boot_logged && boot_metrics_get(BOOT_STAGE_FIRST_SHARE) != 0) {
+            boot_metrics_log();
+            boot_logged = true;
+        }
+
+        if (++passes % MEM_REPORT_EVERY == 0) {
+            mem_budget_log();
+
+            dlog_stats_t dlog;
+            dlog_get_stats(&dlog);
+            ESP_LOGI(TAG, "Deferred log: %lu recorded, %lu emitted, %lu dropped, peak %lu/%d queued",
+                     (unsigned long)dlog.recorded, (unsigned long)dlog.emitted,
+                     (unsigned long)dlog.dropped, (unsigned long)dlog.high_water, DLOG_RING_SIZE);
+
+            touch_stats_t touch;
+            if (touch_input_get_stats(&touch) == ESP_OK) {
+                ESP_LOGI(TAG, "Touch: %lu reports, %lu coalesced, %lu dropped",
+                         (unsigned long)touch.reports, (unsigned long)touch.coalesced,
+                         (unsigned long)touch.dropped);
+                touch_ui_stats_t gestures;
+                touch_ui_get_stats(&gestures);
+                ESP_LOGI(TAG, "Touch gestures: %lu taps, %lu mode switches, %lu refused",
+                         (unsigned long)gestures.taps, (unsigned long)gestures.holds,
+                         (unsigned long)gestures.rejected);
+                if (touch.feedback_count > 0) {
+                    ESP_LOGI(TAG, "Touch feedback: %.1f ms avg / %.1f ms max over %lu events",
+                             touch.feedback_avg_us / 1000.0f, touch.feedback_max_us / 1000.0f,
+                             (unsigned long)touch.feedback_count);
+                }
+            }
+        }
+
         if (config->active_mode == MINING_MODE_DUINOCOIN && duco_miner_is_running()) {
+            // Journal batches writes internally, so offering totals each pass is cheap
+            stats_totals_t totals;
+            if (duco_miner_get_totals(&totals) == ESP_OK) {
+                stats_journal_checkpoint(&totals, false);
+            }
+
             duco_stats_t stats;
             if (duco_miner_get_stats(&stats) == ESP_OK) {
                 ESP_LOGI(TAG, "=== Duino-Coin Stats ===");
                 ESP_LOGI(TAG, "State: %d", stats.state);
-                ESP_LOGI(TAG, "Hashrate: %.2f H/s (avg: %.2f H/s)",
-                         stats.current_hashrate, stats.avg_hashrate);
+                ESP_LOGI(TAG, "Hashrate: %.2f / %.2f / %.2f H/s (10s/1m/15m, wall clock)",
+                         stats.hashrate.wall_10s, stats.hashrate.wall_1m, stats.hashrate.wall_15m);
+                ESP_LOGI(TAG, "While hashing: %.2f H/s (1m), duty %.0f%%",
+                         stats.hashrate.hashing_1m, stats.hashrate.duty_pct);
                 ESP_LOGI(TAG, "Shares: %lu accepted, %lu rejected",
                          (unsigned long)stats.shares_accepted,
                          (unsigned long)stats.shares_rejected);
+                for (int i = 0; i < stats.rig_count && stats.rig_count > 1; i++) {
+                    const duco_rig_stats_t *rig = &stats.rigs[i];
+                    ESP_LOGI(TAG, "  Rig %s: %.2f H/s, %lu/%lu shares, tier %s (%s), rtt %.0f ms, %lu reconnects",
+                             rig->rig_id, rig->hashrate,
+                             (unsigned long)rig->shares_accepted,
+                             (unsigned long)rig->shares_rejected,
+                             rig->difficulty_tier, rig->tier_reason,
+                             rig->avg_rtt_ms, (unsigned long)rig->reconnects);
+                }
+                ESP_LOGI(TAG, "Retry queue: %lu recovered, %lu expired, %lu pending",
+                         (unsigned long)stats.shares_recovered,
+                         (unsigned long)stats.shares_expired,
+                         (unsigned long)stats.shares_pending);
                 ESP_LOGI(TAG, "DUCO Earned: %.8f (today: %.8f)",
                          stats.duco_earned_total, stats.duco_earned_today);
+                ESP_LOGI(TAG, "Tier: %s (%s) - solve %.0f ms, rtt %.0f ms, overhead %.1f%%",
+                         stats.difficulty_tier, stats.tier_reason, stats.avg_solve_ms,
+                         stats.avg_rtt_ms, stats.network_overhead_pct);
                 ESP_LOGI(TAG, "Uptime: %lu seconds", (unsigned long)stats.uptime_seconds);
-                ESP_LOGI(TAG, "=======================");
+                ESP_LOGI(TAG, "Boot to first hash: %lu ms, to first accepted share: %lu ms",
+                         (unsigned long)stats.boot_to_first_hash_ms,
+                         (unsigned long)stats.boot_to_first_share_ms);
+            }
+
+            wifi_status_t wifi;
+            if (wifi_manager_get_status(&wifi) == ESP_OK) {
+                ESP_LOGI(TAG, "WiFi: %s, ch %u, %d dBm, %lu drop(s), last join %lu ms%s",
+                         wifi_sm_state_name(wifi.state), wifi.channel, wifi.rssi,
+                         (unsigned long)wifi.link_losses, (unsigned long)wifi.last_join_ms,
+                         wifi.ap_active ? ", setup AP on" : "");
+            }
+
+            thermal_status_t thermal;
+            if (thermal_governor_get_status(&thermal) == ESP_OK && thermal.sensor_ok) {
+                ESP_LOGI(TAG, "Temp: %.1f C (effort %.0f%%, %u workers, %u%% duty%s)",
+                         thermal.filtered_c, thermal.effort * 100.0f,
+                         thermal.limits.workers, thermal.limits.duty_pct,
+                         thermal.limits.shutdown ? ", SHUTDOWN" : "");
             }
+            ESP_LOGI(TAG, "=======================");
         } else {
             ESP_LOGI(TAG, "System running...");
         }
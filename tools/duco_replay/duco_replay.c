@@ -0,0 +1,358 @@
+/**
+ * DUCO-S1 Corpus Replay (host tool)
+ *
+ * Runs every job of one or more replay corpora through each registered
+ * nonce-search kernel, checks that every kernel finds the recorded nonce
+ * and reports time-to-solution per job. See duco_corpus.h for the format.
+ *
+ * Build:
+ *   cmake -S tools/duco_replay -B build-replay && cmake --build build-replay
+ *
+ * Get a corpus from a board running in recorder mode:
+ *   esptool.py read_flash 0x3B0000 0x40000 corpus.bin
+ *
+ * Usage:
+ *   duco_replay [-k kernel] [-r repeat] [-q] corpus...
+ */
+
+#include "duco_corpus.h"
+#include "duco_sha1_mb.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define MAX_JOBS 100000
+
+typedef struct {
+    char last_hash[41];
+    char expected_hash[41];
+    uint32_t difficulty;
+    uint32_t nonce;                 // Recorded (server-accepted) nonce
+    int64_t device_solve_us;
+} replay_job_t;
+
+// A nonce-search kernel: lowest matching nonce in [0, difficulty * 100]
+typedef bool (*kernel_fn_t)(const replay_job_t *job, uint32_t *nonce);
+
+typedef struct {
+    const char *name;
+    kernel_fn_t solve;
+    double total_s;
+    uint64_t hashes;
+    uint32_t mismatches;
+} kernel_t;
+
+// ---------------------------------------------------------------------------
+// Reference kernel: one full SHA-1 per nonce over the formatted string, the
+// way the original device loop did it. Independent of duco_sha1_mb.c.
+// ---------------------------------------------------------------------------
+
+#define ROL(x, n) (((x) << (n)) | ((x) >> (32 - (n))))
+
+static void sha1(const uint8_t *msg, size_t len, uint8_t out[20])
+{
+    uint32_t h[5] = { 0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0 };
+    uint8_t block[128] = {0};
+    size_t blocks = (len + 9 + 63) / 64;
+
+    memcpy(block, msg, len);
+    block[len] = 0x80;
+    uint64_t bits = (uint64_t)len * 8;
+    for (int i = 0; i < 8; i++) {
+        block[blocks * 64 - 1 - i] = (uint8_t)(bits >> (8 * i));
+    }
+
+    for (size_t b = 0; b < blocks; b++) {
+        uint32_t w[80];
+        for (int i = 0; i < 16; i++) {
+            const uint8_t *p = block + b * 64 + i * 4;
+            w[i] = (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | p[3];
+        }
+        for (int i = 16; i < 80; i++) {
+            w[i] = ROL(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+        }
+
+        uint32_t a = h[0], bb = h[1], c = h[2], d = h[3], e = h[4];
+        for (int i = 0; i < 80; i++) {
+            uint32_t f, k;
+            if (i < 20) {
+                f = (bb & c) | (~bb & d);
+                k = 0x5A827999;
+            } else if (i < 40) {
+                f = bb ^ c ^ d;
+                k = 0x6ED9EBA1;
+            } else if (i < 60) {
+                f = (bb & c) | (bb & d) | (c & d);
+                k = 0x8F1BBCDC;
+            } else {
+                f = bb ^ c ^ d;
+                k = 0xCA62C1D6;
+            }
+            uint32_t t = ROL(a, 5) + f + e + k + w[i];
+            e = d;
+            d = c;
+            c = ROL(bb, 30);
+            bb = a;
+            a = t;
+        }
+        h[0] += a;
+        h[1] += bb;
+        h[2] += c;
+        h[3] += d;
+        h[4] += e;
+    }
+
+    for (int i = 0; i < 5; i++) {
+        out[i * 4] = (uint8_t)(h[i] >> 24);
+        out[i * 4 + 1] = (uint8_t)(h[i] >> 16);
+        out[i * 4 + 2] = (uint8_t)(h[i] >> 8);
+        out[i * 4 + 3] = (uint8_t)h[i];
+    }
+}
+
+static bool hex_to_bytes(const char *hex, uint8_t out[20])
+{
+    for (int i = 0; i < 20; i++) {
+        unsigned v;
+        if (sscanf(hex + i * 2, "%2x", &v) != 1) {
+            return false;
+        }
+        out[i] = (uint8_t)v;
+    }
+    return true;
+}
+
+static bool kernel_reference(const replay_job_t *job, uint32_t *nonce)
+{
+    uint8_t target[20];
+    uint8_t digest[20];
+    char input[64];
+    uint32_t max_nonce = job->difficulty * 100 + 1;
+
+    if (!hex_to_bytes(job->expected_hash, target)) {
+        return false;
+    }
+
+    for (uint32_t n = 0; n < max_nonce; n++) {
+        int len = snprintf(input, sizeof(input), "%s%u", job->last_hash, n);
+        sha1((const uint8_t *)input, len, digest);
+        if (memcmp(digest, target, 20) == 0) {
+            *nonce = n;
+            return true;
+        }
+    }
+    return false;
+}
+
+// ---------------------------------------------------------------------------
+// Multi-buffer kernels (the device search, duco_sha1_mb.c)
+// ---------------------------------------------------------------------------
+
+static bool kernel_mb(const replay_job_t *job, uint32_t *nonce, unsigned lanes)
+{
+    duco_sha1_job_t sha1_job;
+    uint32_t max_nonce = job->difficulty * 100 + 1;
+
+    if (!duco_sha1_mb_prepare(&sha1_job, job->last_hash, strlen(job->last_hash),
+                              job->expected_hash)) {
+        return false;
+    }
+
+    for (uint32_t base = 0; base < max_nonce; base += lanes) {
+        uint32_t match = duco_sha1_mb_search(&sha1_job, base, lanes);
+        if (match) {
+            uint32_t n = base + __builtin_ctz(match);
+            if (n >= max_nonce) {
+                return false;
+            }
+            *nonce = n;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool kernel_mb2(const replay_job_t *job, uint32_t *nonce) { return kernel_mb(job, nonce, 2); }
+static bool kernel_mb4(const replay_job_t *job, uint32_t *nonce) { return kernel_mb(job, nonce, 4); }
+static bool kernel_mb8(const replay_job_t *job, uint32_t *nonce) { return kernel_mb(job, nonce, 8); }
+
+// Registered kernels - add new search implementations here
+static kernel_t kernels[] = {
+    { "reference", kernel_reference, 0, 0, 0 },
+    { "mb-2", kernel_mb2, 0, 0, 0 },
+    { "mb-4", kernel_mb4, 0, 0, 0 },
+    { "mb-8", kernel_mb8, 0, 0, 0 },
+};
+#define KERNEL_COUNT (sizeof(kernels) / sizeof(kernels[0]))
+
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Append the job records of one corpus file
+ */
+static int load_corpus(const char *path, replay_job_t *jobs, int count)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+
+    char line[DUCO_CORPUS_MAX_LINE * 2];
+    int skipped = 0;
+    while (count < MAX_JOBS && fgets(line, sizeof(line), f)) {
+        // A raw flash dump ends in erased (0xFF) bytes
+        char *erased = memchr(line, 0xFF, strlen(line));
+        if (erased) {
+            *erased = '\0';
+        }
+
+        replay_job_t *job = &jobs[count];
+        if (duco_corpus_parse(line, job->last_hash, job->expected_hash, &job->difficulty,
+                              &job->nonce, &job->device_solve_us)) {
+            count++;
+        } else if (line[0] != '#' && line[0] != '\n' && line[0] != '\0') {
+            skipped++;
+        }
+        if (erased) {
+            break;
+        }
+    }
+    fclose(f);
+
+    if (skipped) {
+        fprintf(stderr, "%s: skipped %d malformed line(s)\n", path, skipped);
+    }
+    return count;
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr, "Usage: %s [-k kernel] [-r repeat] [-q] corpus...\n", prog);
+    fprintf(stderr, "Kernels:");
+    for (size_t i = 0; i < KERNEL_COUNT; i++) {
+        fprintf(stderr, " %s", kernels[i].name);
+    }
+    fprintf(stderr, " (multi-buffer variant: %s)\n", duco_sha1_mb_variant());
+}
+
+int main(int argc, char **argv)
+{
+    const char *only = NULL;
+    int repeat = 1;
+    bool quiet = false;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "k:r:qh")) != -1) {
+        switch (opt) {
+            case 'k': only = optarg; break;
+            case 'r': repeat = atoi(optarg) > 0 ? atoi(optarg) : 1; break;
+            case 'q': quiet = true; break;
+            default: usage(argv[0]); return 2;
+        }
+    }
+    if (optind >= argc) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    bool enabled[KERNEL_COUNT];
+    size_t enabled_count = 0;
+    for (size_t k = 0; k < KERNEL_COUNT; k++) {
+        enabled[k] = !only || strcmp(only, kernels[k].name) == 0;
+        enabled_count += enabled[k];
+    }
+    if (enabled_count == 0) {
+        fprintf(stderr, "Unknown kernel '%s'\n", only);
+        usage(argv[0]);
+        return 2;
+    }
+
+    replay_job_t *jobs = calloc(MAX_JOBS, sizeof(replay_job_t));
+    if (!jobs) {
+        return 2;
+    }
+    int count = 0;
+    for (int i = optind; i < argc; i++) {
+        count = load_corpus(argv[i], jobs, count);
+        if (count < 0) {
+            return 2;
+        }
+    }
+    if (count == 0) {
+        fprintf(stderr, "No job records found\n");
+        return 2;
+    }
+
+    printf("%d jobs, multi-buffer variant %s\n", count, duco_sha1_mb_variant());
+    if (!quiet) {
+        printf("%6s %6s %10s %10s", "job", "diff", "nonce", "device_ms");
+        for (size_t k = 0; k < KERNEL_COUNT; k++) {
+            if (enabled[k]) printf(" %10s", kernels[k].name);
+        }
+        printf("\n");
+    }
+
+    for (int j = 0; j < count; j++) {
+        const replay_job_t *job = &jobs[j];
+        if (!quiet) {
+            printf("%6d %6lu %10lu %10.1f", j, (unsigned long)job->difficulty,
+                   (unsigned long)job->nonce, job->device_solve_us / 1000.0);
+        }
+
+        for (size_t k = 0; k < KERNEL_COUNT; k++) {
+            if (!enabled[k]) continue;
+            kernel_t *kern = &kernels[k];
+            uint32_t nonce = UINT32_MAX;
+            bool found = false;
+
+            double start = now_s();
+            for (int r = 0; r < repeat; r++) {
+                found = kern->solve(job, &nonce);
+            }
+            double elapsed = (now_s() - start) / repeat;
+
+            kern->total_s += elapsed;
+            kern->hashes += (uint64_t)job->nonce + 1;
+            if (!found || nonce != job->nonce) {
+                kern->mismatches++;
+                fprintf(stderr, "MISMATCH job %d kernel %s: expected %lu, got %s%lu\n",
+                        j, kern->name, (unsigned long)job->nonce,
+                        found ? "" : "none/", (unsigned long)nonce);
+            }
+            if (!quiet) {
+                printf(" %10.3f", elapsed * 1000.0);
+            }
+        }
+        if (!quiet) {
+            printf("\n");
+        }
+    }
+
+    // Summary: throughput relative to the first enabled kernel
+    printf("\n%-10s %12s %12s %10s %10s\n", "kernel", "total_ms", "MH/s", "speedup", "mismatch");
+    double baseline = 0;
+    int failed = 0;
+    for (size_t k = 0; k < KERNEL_COUNT; k++) {
+        if (!enabled[k]) continue;
+        kernel_t *kern = &kernels[k];
+        if (baseline == 0) {
+            baseline = kern->total_s;
+        }
+        printf("%-10s %12.1f %12.3f %9.2fx %10lu\n", kern->name, kern->total_s * 1000.0,
+               kern->total_s > 0 ? kern->hashes / kern->total_s / 1e6 : 0.0,
+               kern->total_s > 0 ? baseline / kern->total_s : 0.0,
+               (unsigned long)kern->mismatches);
+        failed += kern->mismatches > 0;
+    }
+
+    free(jobs);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,250 @@
+/**
+ * Fleet Simulator and Aggregator (host tool)
+ *
+ * Speaks the fleet datagram format from components/fleet (fleet_proto.h).
+ * "send" simulates one or more miners; "listen" is the same aggregator the
+ * firmware runs, printing the device table once a second. Several instances
+ * on loopback exercise the whole path without hardware; on a LAN, "listen"
+ * also shows real boards running with FLEET_MODE set.
+ *
+ * Build:
+ *   cmake -S tools/fleet_sim -B build-fleet && cmake --build build-fleet
+ *
+ * Usage:
+ *   fleet_sim listen [-p port] [-t seconds]
+ *   fleet_sim send [-p port] [-a addr] [-n devices] [-i interval_ms]
+ *                  [-c reports] [-r hashrate] [-s straggler] [-H hot] [-x name]
+ *
+ * Example (three processes on loopback, one straggler, one hot board):
+ *   fleet_sim listen -t 10 &
+ *   fleet_sim send -n 4 -s 3 -x rackA &
+ *   fleet_sim send -n 3 -H 0 -x rackB
+ */
+
+#include "fleet_proto.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <errno.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+
+#define DEFAULT_PORT 45900
+
+static uint32_t now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+
+static void usage(void)
+{
+    fprintf(stderr,
+            "usage: fleet_sim listen [-p port] [-t seconds]\n"
+            "       fleet_sim send [-p port] [-a addr] [-n devices] [-i interval_ms]\n"
+            "                      [-c reports] [-r hashrate] [-s straggler] [-H hot] [-x name]\n");
+    exit(2);
+}
+
+// ---------------------------------------------------------------------------
+// Aggregator
+// ---------------------------------------------------------------------------
+
+static void print_table(fleet_table_t *table, uint32_t start_ms)
+{
+    fleet_summary_t s;
+    uint32_t now = now_ms();
+    fleet_table_evaluate(table, now, &s);
+
+    printf("\nt=%us  %u/%u online  total %.1f kH/s  median %.1f kH/s  stragglers %u  hot %u  rejected %u\n",
+           (now - start_ms) / 1000, s.online, s.devices, s.hashrate / 1000.0,
+           s.median_hashrate / 1000.0, s.stragglers, s.hot, table->rejected);
+    printf("  %-15s %-12s %-9s %10s %6s %6s %5s %5s %4s\n",
+           "NAME", "ID", "HEALTH", "H/S", "TEMP", "SEEN", "RECV", "LOST", "RST");
+    for (int i = 0; i < table->count; i++) {
+        const fleet_device_t *dev = &table->devices[i];
+        const fleet_report_t *r = &dev->report;
+        char temp[8] = "-";
+        if (r->temp_centi_c != FLEET_TEMP_UNKNOWN) {
+            snprintf(temp, sizeof(temp), "%.1f", r->temp_centi_c / 100.0);
+        }
+        printf("  %-15s %02x%02x%02x%02x%02x%02x %-9s %10u %6s %5us %5u %5u %4u\n",
+               r->name, r->device_id[0], r->device_id[1], r->device_id[2], r->device_id[3],
+               r->device_id[4], r->device_id[5], fleet_health_name(dev->health), r->hashrate,
+               temp, (now - dev->last_seen_ms) / 1000, dev->received, dev->lost, dev->restarts);
+    }
+    fflush(stdout);
+}
+
+static int run_listen(int port, int seconds)
+{
+    int sock = socket(AF_INET, SOCK_DGRAM, 0);
+    int on = 1;
+    setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    struct sockaddr_in addr = {
+        .sin_family = AF_INET,
+        .sin_port = htons(port),
+        .sin_addr.s_addr = htonl(INADDR_ANY),
+    };
+    if (bind(sock, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        perror("bind");
+        return 1;
+    }
+
+    static fleet_table_t table;
+    fleet_table_init(&table);
+
+    uint32_t start = now_ms();
+    uint32_t next_print = start + 1000;
+    uint64_t datagrams = 0;
+    double decode_ns = 0;
+
+    while (seconds == 0 || now_ms() - start < (uint32_t)seconds * 1000) {
+        fd_set readfds;
+        FD_ZERO(&readfds);
+        FD_SET(sock, &readfds);
+        struct timeval tv = { .tv_sec = 0, .tv_usec = 100000 };
+
+        if (select(sock + 1, &readfds, NULL, NULL, &tv) > 0) {
+            uint8_t buf[FLEET_DATAGRAM_SIZE + 1];
+            struct sockaddr_in from;
+            socklen_t from_len = sizeof(from);
+            ssize_t len = recvfrom(sock, buf, sizeof(buf), 0, (struct sockaddr *)&from, &from_len);
+            if (len > 0) {
+                struct timespec a, b;
+                clock_gettime(CLOCK_MONOTONIC, &a);
+                fleet_table_receive(&table, buf, (size_t)len, from.sin_addr.s_addr, now_ms());
+                clock_gettime(CLOCK_MONOTONIC, &b);
+                decode_ns += (b.tv_sec - a.tv_sec) * 1e9 + (b.tv_nsec - a.tv_nsec);
+                datagrams++;
+            }
+        }
+
+        if ((int32_t)(now_ms() - next_print) >= 0) {
+            next_print += 1000;
+            print_table(&table, start);
+        }
+    }
+
+    print_table(&table, start);
+    printf("\n%llu datagrams, %.0f ns average decode + table update\n",
+           (unsigned long long)datagrams, datagrams ? decode_ns / datagrams : 0.0);
+    close(sock);
+    return 0;
+}
+
+// ---------------------------------------------------------------------------
+// Simulated miners
+// ---------------------------------------------------------------------------
+
+static int run_send(int port, const char *dest_addr, int devices, int interval_ms, int reports,
+                    uint32_t hashrate, int straggler, int hot, const char *name)
+{
+    int sock = socket(AF_INET, SOCK_DGRAM, 0);
+    int on = 1;
+    setsockopt(sock, SOL_SOCKET, SO_BROADCAST, &on, sizeof(on));
+    struct sockaddr_in dest = {
+        .sin_family = AF_INET,
+        .sin_port = htons(port),
+    };
+    if (inet_pton(AF_INET, dest_addr, &dest.sin_addr) != 1) {
+        fprintf(stderr, "bad address %s\n", dest_addr);
+        return 1;
+    }
+
+    // Distinct, locally administered MACs per process and device
+    uint32_t pid = (uint32_t)getpid();
+    uint32_t start = now_ms();
+    srand(pid);
+
+    for (int round = 0; reports == 0 || round < reports; round++) {
+        for (int d = 0; d < devices; d++) {
+            fleet_report_t r = {0};
+            r.device_id[0] = 0x02;
+            r.device_id[1] = (uint8_t)(pid >> 16);
+            r.device_id[2] = (uint8_t)(pid >> 8);
+            r.device_id[3] = (uint8_t)pid;
+            r.device_id[4] = 0x00;
+            r.device_id[5] = (uint8_t)d;
+            snprintf(r.name, sizeof(r.name), "%s-%d", name, d);
+            r.seq = (uint32_t)round;
+            r.interval_s = (uint16_t)(interval_ms >= 1000 ? interval_ms / 1000 : 1);
+            r.mode = 1;
+            r.state = 3;
+            r.uptime_s = (now_ms() - start) / 1000;
+
+            // +-5% jitter; the straggler runs at a third of the rate
+            uint32_t rate = hashrate - hashrate / 20 + (uint32_t)(rand() % (hashrate / 10 + 1));
+            r.hashrate = d == straggler ? rate / 3 : rate;
+            r.shares_accepted = (uint32_t)round * 3;
+            r.shares_rejected = (uint32_t)round / 10;
+            r.temp_centi_c = (int16_t)(d == hot ? 8150 : 6200 + d * 50);
+            r.flags = d == hot ? FLEET_FLAG_THROTTLED : 0;
+            r.free_heap_kb = 180;
+            r.rssi = -60;
+
+            uint8_t datagram[FLEET_DATAGRAM_SIZE];
+            fleet_encode(&r, datagram);
+            if (sendto(sock, datagram, sizeof(datagram), 0, (struct sockaddr *)&dest, sizeof(dest)) < 0) {
+                perror("sendto");
+            }
+        }
+        usleep((useconds_t)interval_ms * 1000);
+    }
+    close(sock);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2) {
+        usage();
+    }
+    const char *cmd = argv[1];
+
+    int port = DEFAULT_PORT;
+    int seconds = 0;
+    const char *addr = "127.0.0.1";
+    int devices = 1;
+    int interval_ms = 1000;
+    int reports = 0;
+    uint32_t hashrate = 60000;
+    int straggler = -1;
+    int hot = -1;
+    const char *name = "sim";
+
+    optind = 2;
+    int opt;
+    while ((opt = getopt(argc, argv, "p:t:a:n:i:c:r:s:H:x:")) != -1) {
+        switch (opt) {
+            case 'p': port = atoi(optarg); break;
+            case 't': seconds = atoi(optarg); break;
+            case 'a': addr = optarg; break;
+            case 'n': devices = atoi(optarg); break;
+            case 'i': interval_ms = atoi(optarg); break;
+            case 'c': reports = atoi(optarg); break;
+            case 'r': hashrate = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 's': straggler = atoi(optarg); break;
+            case 'H': hot = atoi(optarg); break;
+            case 'x': name = optarg; break;
+            default: usage();
+        }
+    }
+
+    if (strcmp(cmd, "listen") == 0) {
+        return run_listen(port, seconds);
+    }
+    if (strcmp(cmd, "send") == 0) {
+        if (devices < 1 || devices > 255 || interval_ms < 1) {
+            usage();
+        }
+        return run_send(port, addr, devices, interval_ms, reports, hashrate, straggler, hot, name);
+    }
+    usage();
+    return 2;
+}
@@ -0,0 +1,380 @@
+/**
+ * Thermal Controller Simulator (host tool)
+ *
+ * Steps the controller from components/mining_common (thermal_control.h)
+ * against a first-order thermal model of the chip: temperature relaxes
+ * towards ambient plus a rise proportional to hashing effort, with time
+ * constant tau. The controller is sampled once a second like the governor
+ * task, with the same tuning as thermal_governor_init().
+ *
+ * Checks:
+ *   settle   - from cold at full effort, holds the setpoint without tripping
+ *   shutdown - a heat soak past shutdown_c latches shutdown, which holds
+ *              until the filtered temperature is below resume_c
+ *   sensor_fail - after fail_limit failed reads a hot chip drops to minimum
+ *              effort, a shut-down one stays down, and both recover gently
+ *              once the sensor reads again
+ * Exits non-zero if any check fails.
+ *
+ * Build:
+ *   cmake -S tools/thermal_sim -B build-thermal && cmake --build build-thermal
+ *
+ * Usage:
+ *   thermal_sim [-a ambient_c] [-r rise_c] [-t tau_s] [-n noise_c] [-c] [scenario...]
+ *
+ *   -c prints a CSV trace (second, raw, filtered, effort, workers, duty, shutdown)
+ */
+
+#include "thermal_control.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+
+#define SAMPLE_S 1.0f                   // Governor sample period
+#define SUBSTEPS 10                     // Model steps per sample
+
+// Mirrors thermal_governor_init() with the config.h.example thresholds
+static const thermal_control_params_t params = {
+    .setpoint_c = 78.0f,
+    .shutdown_c = 90.0f,
+    .resume_c = 78.0f,
+    .kp = 0.10f,
+    .ki = 0.02f,
+    .filter_alpha = 0.3f,
+    .min_effort = 0.10f,
+    .max_workers = 2,
+    .min_slice_us = 1000,
+    .max_slice_us = 5000,
+    .fail_limit = 3,
+};
+
+// First-order plant
+typedef struct {
+    float ambient_c;
+    float rise_c;                       // Steady-state rise over ambient at full effort
+    float tau_s;
+    float noise_c;                      // Peak sensor noise
+    float temp_c;
+    bool sensor_failed;                 // Reads fail while set
+} plant_t;
+
+static plant_t plant_defaults = {
+    .ambient_c = 30.0f,
+    .rise_c = 65.0f,
+    .tau_s = 60.0f,
+    .noise_c = 0.0f,
+};
+
+static bool csv = false;
+static int failures = 0;
+
+#define CHECK(cond) check((cond), #cond, __LINE__)
+
+static void check(bool ok, const char *what, int line)
+{
+    if (!ok) {
+        printf("    FAIL line %d: %s\n", line, what);
+        failures++;
+    }
+}
+
+/**
+ * @brief Fraction of full throughput the limits allow
+ */
+static float limits_effort(const thermal_limits_t *l)
+{
+    if (l->shutdown) {
+        return 0.0f;
+    }
+    return (float)l->workers * l->duty_pct / 100.0f / params.max_workers;
+}
+
+static float sensor_read(const plant_t *p)
+{
+    // Deterministic so failures reproduce
+    static uint32_t lcg = 12345;
+    lcg = lcg * 1103515245u + 12345u;
+    float u = (float)(lcg >> 8) / (float)(1u << 24);
+    return p->temp_c + p->noise_c * (2.0f * u - 1.0f);
+}
+
+/**
+ * @brief Run one controller sample and advance the plant under its limits
+ */
+static void sim_step(plant_t *p, thermal_control_t *ctl, thermal_limits_t *limits, int second)
+{
+    // Like the governor: a failed read keeps the last limits until failing safe
+    float raw = NAN;
+    if (p->sensor_failed) {
+        thermal_control_sensor_failed(ctl, limits);
+    } else {
+        raw = sensor_read(p);
+        thermal_control_step(ctl, raw, SAMPLE_S, limits);
+    }
+
+    float effort = limits_effort(limits);
+    float dt = SAMPLE_S / SUBSTEPS;
+    for (int i = 0; i < SUBSTEPS; i++) {
+        float target = p->ambient_c + p->rise_c * effort;
+        p->temp_c += (target - p->temp_c) * dt / p->tau_s;
+    }
+
+    if (csv) {
+        printf("%d,%.2f,%.2f,%.3f,%u,%u,%d\n", second, raw, ctl->filtered_c, ctl->effort,
+               limits->workers, limits->duty_pct, limits->shutdown);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Scenarios
+// ---------------------------------------------------------------------------
+
+static void scenario_settle(void)
+{
+    plant_t p = plant_defaults;
+    p.temp_c = p.ambient_c;
+    thermal_control_t ctl;
+    thermal_limits_t limits;
+    thermal_control_init(&ctl, &params);
+
+    const int duration = 1800;
+    const int window = 600;             // Judge the last ten minutes
+    float max_c = p.temp_c;
+    float sum = 0.0f;
+    float lo = 1000.0f;
+    float hi = -1000.0f;
+    bool tripped = false;
+
+    for (int s = 0; s < duration; s++) {
+        sim_step(&p, &ctl, &limits, s);
+        tripped |= limits.shutdown;
+        if (p.temp_c > max_c) {
+            max_c = p.temp_c;
+        }
+        if (s >= duration - window) {
+            sum += p.temp_c;
+            lo = fminf(lo, p.temp_c);
+            hi = fmaxf(hi, p.temp_c);
+        }
+    }
+    float mean = sum / window;
+
+    if (!csv) {
+        printf("  peak %.2f C, last %d s: mean %.2f C, range %.2f-%.2f C, effort %.2f\n",
+               max_c, window, mean, lo, hi, ctl.effort);
+    }
+    CHECK(!tripped);
+    CHECK(fabsf(mean - params.setpoint_c) < 0.5f);
+    CHECK(hi - lo < 1.5f);
+    CHECK(max_c < params.setpoint_c + 3.0f);
+    // The plant needs less than full effort to sit at the setpoint
+    CHECK(ctl.effort < 1.0f && ctl.effort > params.min_effort);
+}
+
+static void scenario_shutdown(void)
+{
+    plant_t p = plant_defaults;
+    p.temp_c = params.setpoint_c;
+    thermal_control_t ctl;
+    thermal_limits_t limits;
+    thermal_control_init(&ctl, &params);
+
+    int s = 0;
+    for (; s < 600; s++) {
+        sim_step(&p, &ctl, &limits, s);
+    }
+    CHECK(!limits.shutdown);
+
+    // Heat soak: even minimum effort now ends above the hard limit
+    p.ambient_c = params.shutdown_c + 5.0f;
+    int trip_s = -1;
+    float trip_c = 0.0f;
+    for (; s < 1800 && trip_s < 0; s++) {
+        sim_step(&p, &ctl, &limits, s);
+        if (limits.shutdown) {
+            trip_s = s;
+            trip_c = p.temp_c;
+        }
+    }
+    CHECK(trip_s >= 0);
+    CHECK(trip_c >= params.shutdown_c - 1.0f);
+
+    // Soak ends; shutdown must hold all the way down to resume_c
+    p.ambient_c = plant_defaults.ambient_c;
+    int resume_s = -1;
+    float resume_filtered = 0.0f;
+    bool held = true;
+    for (; s < 3600 && resume_s < 0; s++) {
+        sim_step(&p, &ctl, &limits, s);
+        if (!limits.shutdown) {
+            resume_s = s;
+            resume_filtered = ctl.filtered_c;
+        } else if (ctl.filtered_c < params.resume_c) {
+            held = false;               // Still down although below resume_c
+        }
+    }
+    CHECK(held);
+    CHECK(resume_s >= 0);
+    CHECK(resume_filtered < params.resume_c);
+    CHECK(resume_filtered > params.resume_c - 1.5f);
+
+    // Resumes gently (integrator restarts at min_effort), then settles without tripping again
+    float headroom = params.setpoint_c - resume_filtered;
+    CHECK(ctl.effort <= params.min_effort + (params.kp + params.ki * SAMPLE_S) * headroom + 0.01f);
+    bool retripped = false;
+    for (int end = s + 900; s < end; s++) {
+        sim_step(&p, &ctl, &limits, s);
+        retripped |= limits.shutdown;
+    }
+    CHECK(!retripped);
+    CHECK(fabsf(p.temp_c - params.setpoint_c) < 1.0f);
+
+    if (!csv) {
+        printf("  tripped at %d s (%.2f C), resumed at %d s (filtered %.2f C), now %.2f C\n",
+               trip_s, trip_c, resume_s, resume_filtered, p.temp_c);
+    }
+}
+
+static void scenario_sensor_fail(void)
+{
+    plant_t p = plant_defaults;
+    p.temp_c = p.ambient_c;
+    thermal_control_t ctl;
+    thermal_limits_t limits;
+    thermal_control_init(&ctl, &params);
+
+    int s = 0;
+    for (; s < 900; s++) {
+        sim_step(&p, &ctl, &limits, s);
+    }
+    float hot_effort = limits_effort(&limits);
+    CHECK(!limits.shutdown);
+    CHECK(hot_effort > params.min_effort + 0.1f);
+
+    // Sensor dies while hot: the last limits hold until fail_limit reads fail
+    p.sensor_failed = true;
+    for (int n = 1; n < params.fail_limit; n++, s++) {
+        sim_step(&p, &ctl, &limits, s);
+        CHECK(limits_effort(&limits) == hot_effort);
+    }
+    bool min_held = true;
+    for (int end = s + 300; s < end; s++) {
+        sim_step(&p, &ctl, &limits, s);
+        min_held &= !limits.shutdown &&
+                    fabsf(limits_effort(&limits) - params.min_effort) < 0.01f;
+    }
+    CHECK(min_held);
+    float blind_c = p.temp_c;
+
+    // Sensor back: restarts from min_effort and settles without tripping
+    p.sensor_failed = false;
+    sim_step(&p, &ctl, &limits, s++);
+    float headroom = params.setpoint_c - ctl.filtered_c;
+    CHECK(fabsf(ctl.filtered_c - blind_c) <= p.noise_c + 0.01f);    // Filter restarted from the fresh reading
+    CHECK(ctl.effort <= params.min_effort + (params.kp + params.ki * SAMPLE_S) * headroom + 0.01f);
+    bool tripped = false;
+    for (int end = s + 900; s < end; s++) {
+        sim_step(&p, &ctl, &limits, s);
+        tripped |= limits.shutdown;
+    }
+    CHECK(!tripped);
+    CHECK(fabsf(p.temp_c - params.setpoint_c) < 1.0f);
+
+    // Sensor dies during a shutdown: it holds even after the soak is over
+    p.ambient_c = params.shutdown_c + 5.0f;
+    for (int end = s + 1200; s < end && !limits.shutdown; s++) {
+        sim_step(&p, &ctl, &limits, s);
+    }
+    CHECK(limits.shutdown);
+    p.ambient_c = plant_defaults.ambient_c;
+    p.sensor_failed = true;
+    bool held = true;
+    for (int end = s + 600; s < end; s++) {
+        sim_step(&p, &ctl, &limits, s);
+        held &= limits.shutdown;
+    }
+    CHECK(held);
+
+    p.sensor_failed = false;
+    for (int end = s + 900; s < end; s++) {
+        sim_step(&p, &ctl, &limits, s);
+    }
+    CHECK(!limits.shutdown);
+    CHECK(fabsf(p.temp_c - params.setpoint_c) < 1.0f);
+
+    if (!csv) {
+        printf("  effort %.2f hot, %.2f blind (cooled to %.2f C), now %.2f C\n",
+               hot_effort, params.min_effort, blind_c, p.temp_c);
+    }
+}
+
+static const struct {
+    const char *name;
+    void (*run)(void);
+} scenarios[] = {
+    { "settle", scenario_settle },
+    { "shutdown", scenario_shutdown },
+    { "sensor_fail", scenario_sensor_fail },
+};
+
+#define SCENARIO_COUNT (sizeof(scenarios) / sizeof(scenarios[0]))
+
+static void usage(void)
+{
+    fprintf(stderr,
+            "usage: thermal_sim [-a ambient_c] [-r rise_c] [-t tau_s] [-n noise_c] [-c] [scenario...]\n"
+            "scenarios: settle shutdown sensor_fail\n");
+    exit(2);
+}
+
+int main(int argc, char **argv)
+{
+    int opt;
+    while ((opt = getopt(argc, argv, "a:r:t:n:ch")) != -1) {
+        switch (opt) {
+            case 'a': plant_defaults.ambient_c = strtof(optarg, NULL); break;
+            case 'r': plant_defaults.rise_c = strtof(optarg, NULL); break;
+            case 't': plant_defaults.tau_s = strtof(optarg, NULL); break;
+            case 'n': plant_defaults.noise_c = strtof(optarg, NULL); break;
+            case 'c': csv = true; break;
+            default: usage();
+        }
+    }
+    if (plant_defaults.tau_s <= 0.0f) {
+        usage();
+    }
+    if (csv) {
+        printf("second,raw_c,filtered_c,effort,workers,duty_pct,shutdown\n");
+    }
+
+    int ran = 0;
+    for (size_t i = 0; i < SCENARIO_COUNT; i++) {
+        bool selected = optind == argc;
+        for (int a = optind; a < argc; a++) {
+            selected |= strcmp(argv[a], scenarios[i].name) == 0;
+        }
+        if (!selected) {
+            continue;
+        }
+
+        int before = failures;
+        if (!csv) {
+            printf("%s\n", scenarios[i].name);
+        }
+        scenarios[i].run();
+        if (!csv) {
+            printf("  %s\n", failures == before ? "pass" : "FAIL");
+        }
+        ran++;
+    }
+
+    if (ran == 0) {
+        usage();
+    }
+    if (!csv) {
+        printf("%d scenario(s), %d failed check(s)\n", ran, failures);
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,365 @@
+/**
+ * Wi-Fi State Machine Harness (host tool)
+ *
+ * Drives components/wifi_manager/wifi_sm.c against a mocked driver on a
+ * simulated clock and checks the connection policy: backoff growth and cap,
+ * the cached-BSSID fallback to a full scan, the setup AP fallback, the
+ * attempt timeout (including swallowing the disconnect event it causes)
+ * and rejoin after a drop or a lost lease. Exits non-zero if any check fails.
+ *
+ * Build:
+ *   cmake -S tools/wifi_sm_sim -B build-wifi-sm && cmake --build build-wifi-sm
+ *
+ * Usage:
+ *   wifi_sm_sim [-v] [scenario...]
+ */
+
+#include "wifi_sm.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// Mocked driver: records every call the state machine makes
+typedef struct {
+    int connects;
+    bool last_hinted;
+    bool last_static;
+    int disconnects;
+    int ap_starts;
+    int ap_stops;
+    int cache_saves;
+    wifi_sm_cache_t saved;
+    int link_ups;
+    int link_downs;
+} mock_t;
+
+static const wifi_sm_params_t params = {
+    .attempt_timeout_ms = 10000,
+    .backoff_min_ms = 1000,
+    .backoff_max_ms = 8000,
+    .ap_fallback_ms = 60000,
+    .static_ip = true,
+};
+
+static const uint8_t bssid_old[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x01 };
+static const uint8_t bssid_new[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x02 };
+static const wifi_sm_ip_t lease = { .ip = 0x0A01A8C0, .netmask = 0x00FFFFFF, .gw = 0x0101A8C0 };
+
+static bool verbose = false;
+static int failures = 0;
+
+#define CHECK(cond) check((cond), #cond, __LINE__)
+
+static void check(bool ok, const char *what, int line)
+{
+    if (!ok) {
+        printf("    FAIL line %d: %s\n", line, what);
+        failures++;
+    } else if (verbose) {
+        printf("    ok   %s\n", what);
+    }
+}
+
+static void drv_connect(void *ctx, const wifi_sm_cache_t *hint, bool static_ip)
+{
+    mock_t *m = ctx;
+    m->connects++;
+    m->last_hinted = hint != NULL;
+    m->last_static = static_ip;
+}
+
+static void drv_disconnect(void *ctx)
+{
+    ((mock_t *)ctx)->disconnects++;
+}
+
+static void drv_start_ap(void *ctx)
+{
+    ((mock_t *)ctx)->ap_starts++;
+}
+
+static void drv_stop_ap(void *ctx)
+{
+    ((mock_t *)ctx)->ap_stops++;
+}
+
+static void drv_save_cache(void *ctx, const wifi_sm_cache_t *cache)
+{
+    mock_t *m = ctx;
+    m->cache_saves++;
+    m->saved = *cache;
+}
+
+static void drv_link_changed(void *ctx, bool up)
+{
+    mock_t *m = ctx;
+    if (up) {
+        m->link_ups++;
+    } else {
+        m->link_downs++;
+    }
+}
+
+static const wifi_sm_driver_t driver = {
+    .connect = drv_connect,
+    .disconnect = drv_disconnect,
+    .start_ap = drv_start_ap,
+    .stop_ap = drv_stop_ap,
+    .save_cache = drv_save_cache,
+    .link_changed = drv_link_changed,
+};
+
+static void setup(wifi_sm_t *sm, mock_t *m, bool cached)
+{
+    memset(m, 0, sizeof(*m));
+    wifi_sm_cache_t cache = { .channel = 6, .ip_valid = true, .ip = lease };
+    memcpy(cache.bssid, bssid_old, sizeof(cache.bssid));
+    wifi_sm_init(sm, &params, &driver, m, cached ? &cache : NULL);
+}
+
+/**
+ * @brief Tick every 100 ms (like the manager's timer) up to and including until_ms
+ */
+static void run_until(wifi_sm_t *sm, int64_t *now_ms, int64_t until_ms)
+{
+    while (*now_ms < until_ms) {
+        *now_ms += 100;
+        wifi_sm_tick(sm, *now_ms);
+    }
+}
+
+static void join(wifi_sm_t *sm, int64_t now_ms, const uint8_t bssid[6])
+{
+    wifi_sm_on_connected(sm, now_ms, bssid, 6);
+    wifi_sm_on_got_ip(sm, now_ms, &lease);
+}
+
+// ---------------------------------------------------------------------------
+// Scenarios
+// ---------------------------------------------------------------------------
+
+/**
+ * No cache, the AP refuses every attempt: unhinted joins spaced by doubling
+ * backoff that stops at the cap
+ */
+static void scenario_backoff(void)
+{
+    wifi_sm_t sm;
+    mock_t m;
+    int64_t now = 0;
+    setup(&sm, &m, false);
+
+    wifi_sm_start(&sm, now);
+    CHECK(m.connects == 1 && !m.last_hinted && !m.last_static);
+
+    const uint32_t expected[] = { 1000, 2000, 4000, 8000, 8000 };
+    for (size_t i = 0; i < sizeof(expected) / sizeof(expected[0]); i++) {
+        wifi_sm_on_disconnected(&sm, now, 201);
+        CHECK(sm.state == WIFI_SM_BACKOFF);
+        CHECK(sm.deadline_ms - now == (int64_t)expected[i]);
+
+        int before = m.connects;
+        run_until(&sm, &now, sm.deadline_ms - 100);
+        CHECK(m.connects == before);
+        run_until(&sm, &now, sm.deadline_ms);
+        CHECK(m.connects == before + 1 && !m.last_hinted);
+    }
+    CHECK(m.link_ups == 0 && m.link_downs == 0);
+
+    // Success resets the backoff for the next outage
+    join(&sm, now, bssid_new);
+    CHECK(sm.state == WIFI_SM_CONNECTED && m.link_ups == 1);
+    CHECK(sm.backoff_ms == params.backoff_min_ms && sm.attempts == 0);
+}
+
+/**
+ * Cached BSSID no longer works: the hinted (static IP) join fails and a full
+ * scan with DHCP follows at once; the new AP replaces the cache
+ */
+static void scenario_hint_fallback(void)
+{
+    wifi_sm_t sm;
+    mock_t m;
+    int64_t now = 0;
+    setup(&sm, &m, true);
+
+    wifi_sm_start(&sm, now);
+    CHECK(m.connects == 1 && m.last_hinted && m.last_static);
+
+    now += 300;
+    wifi_sm_on_disconnected(&sm, now, 201);
+    CHECK(m.connects == 2 && !m.last_hinted && !m.last_static);
+    CHECK(sm.state == WIFI_SM_CONNECTING && sm.hint_failed);
+
+    now += 2000;
+    join(&sm, now, bssid_new);
+    CHECK(m.link_ups == 1 && sm.fast_joins == 0);
+    CHECK(m.cache_saves == 1 && memcmp(m.saved.bssid, bssid_new, 6) == 0 && m.saved.ip_valid);
+    CHECK(sm.last_join_ms == 2300);
+
+    // The next outage trusts the fresh cache again
+    now += 1000;
+    wifi_sm_on_disconnected(&sm, now, 8);
+    CHECK(m.link_downs == 1 && m.connects == 3 && m.last_hinted);
+    join(&sm, now + 150, bssid_new);
+    CHECK(sm.fast_joins == 1 && m.cache_saves == 1);
+}
+
+/**
+ * Offline past the fallback time: the AP starts once, the station keeps
+ * retrying, and the AP stops when the station gets an address
+ */
+static void scenario_ap_fallback(void)
+{
+    wifi_sm_t sm;
+    mock_t m;
+    int64_t now = 0;
+    setup(&sm, &m, false);
+
+    wifi_sm_start(&sm, now);
+    while (now < params.ap_fallback_ms - 100) {
+        if (sm.state == WIFI_SM_CONNECTING) {
+            wifi_sm_on_disconnected(&sm, now, 201);
+        }
+        run_until(&sm, &now, now + 100);
+    }
+    CHECK(m.ap_starts == 0);
+
+    run_until(&sm, &now, params.ap_fallback_ms + 100);
+    CHECK(m.ap_starts == 1 && sm.ap_active);
+
+    int before = m.connects;
+    run_until(&sm, &now, now + 20000);
+    CHECK(m.ap_starts == 1);
+    CHECK(m.connects > before);
+
+    if (sm.state != WIFI_SM_CONNECTING) {
+        run_until(&sm, &now, sm.deadline_ms);
+    }
+    join(&sm, now, bssid_new);
+    CHECK(m.ap_stops == 1 && !sm.ap_active && m.link_ups == 1);
+}
+
+/**
+ * No answer at all: the attempt budget expires, the machine disconnects and
+ * the resulting disconnect event is swallowed instead of failing the retry
+ */
+static void scenario_timeout(void)
+{
+    wifi_sm_t sm;
+    mock_t m;
+    int64_t now = 0;
+    setup(&sm, &m, true);
+
+    wifi_sm_start(&sm, now);
+    wifi_sm_on_connected(&sm, 200, bssid_old, 6);
+    CHECK(sm.state == WIFI_SM_WAIT_IP);
+
+    // Hinted attempt times out waiting for the address - unhinted retry at once
+    run_until(&sm, &now, params.attempt_timeout_ms);
+    CHECK(m.disconnects == 1 && sm.disconnect_pending);
+    CHECK(m.connects == 2 && !m.last_hinted && sm.state == WIFI_SM_CONNECTING);
+
+    // The driver reports our own disconnect; the new attempt must survive it
+    now += 50;
+    wifi_sm_on_disconnected(&sm, now, 8);
+    CHECK(!sm.disconnect_pending);
+    CHECK(sm.state == WIFI_SM_CONNECTING && m.connects == 2);
+
+    // Unhinted attempt times out too - now it backs off
+    run_until(&sm, &now, 2 * params.attempt_timeout_ms);
+    CHECK(m.disconnects == 2 && sm.state == WIFI_SM_BACKOFF);
+    wifi_sm_on_disconnected(&sm, now + 50, 8);
+    CHECK(sm.state == WIFI_SM_BACKOFF && sm.backoff_ms == 2 * params.backoff_min_ms);
+    CHECK(m.link_ups == 0 && m.link_downs == 0);
+}
+
+/**
+ * Link lost after working: one link-down report, immediate hinted rejoin;
+ * a lost lease gets one attempt budget for DHCP before a full retry
+ */
+static void scenario_drop(void)
+{
+    wifi_sm_t sm;
+    mock_t m;
+    int64_t now = 0;
+    setup(&sm, &m, true);
+
+    wifi_sm_start(&sm, now);
+    join(&sm, 100, bssid_old);
+    CHECK(m.link_ups == 1 && sm.fast_joins == 1 && m.cache_saves == 0);
+
+    now = 5000;
+    wifi_sm_on_disconnected(&sm, now, 8);
+    CHECK(m.link_downs == 1 && sm.link_losses == 1);
+    CHECK(m.connects == 2 && m.last_hinted && sm.state == WIFI_SM_CONNECTING);
+    wifi_sm_on_disconnected(&sm, now, 8);
+    CHECK(m.link_downs == 1);
+    join(&sm, now + 500, bssid_old);
+    CHECK(m.link_ups == 2);
+
+    now = 20000;
+    wifi_sm_on_lost_ip(&sm, now);
+    CHECK(m.link_downs == 2 && sm.state == WIFI_SM_WAIT_IP && m.connects == 3);
+    run_until(&sm, &now, now + params.attempt_timeout_ms);
+    CHECK(m.disconnects == 1 && m.connects == 3 && sm.state == WIFI_SM_BACKOFF);
+    CHECK(m.link_downs == 2);
+}
+
+static const struct {
+    const char *name;
+    void (*run)(void);
+} scenarios[] = {
+    { "backoff", scenario_backoff },
+    { "hint_fallback", scenario_hint_fallback },
+    { "ap_fallback", scenario_ap_fallback },
+    { "timeout", scenario_timeout },
+    { "drop", scenario_drop },
+};
+
+#define SCENARIO_COUNT (sizeof(scenarios) / sizeof(scenarios[0]))
+
+static void usage(void)
+{
+    fprintf(stderr, "usage: wifi_sm_sim [-v] [scenario...]\nscenarios:");
+    for (size_t i = 0; i < SCENARIO_COUNT; i++) {
+        fprintf(stderr, " %s", scenarios[i].name);
+    }
+    fprintf(stderr, "\n");
+    exit(2);
+}
+
+int main(int argc, char **argv)
+{
+    int opt;
+    while ((opt = getopt(argc, argv, "vh")) != -1) {
+        switch (opt) {
+            case 'v': verbose = true; break;
+            default: usage();
+        }
+    }
+
+    int ran = 0;
+    for (size_t i = 0; i < SCENARIO_COUNT; i++) {
+        bool selected = optind == argc;
+        for (int a = optind; a < argc; a++) {
+            selected |= strcmp(argv[a], scenarios[i].name) == 0;
+        }
+        if (!selected) {
+            continue;
+        }
+
+        int before = failures;
+        printf("%s\n", scenarios[i].name);
+        scenarios[i].run();
+        printf("  %s\n", failures == before ? "pass" : "FAIL");
+        ran++;
+    }
+
+    if (ran == 0) {
+        usage();
+    }
+    printf("%d scenario(s), %d failed check(s)\n", ran, failures);
+    return failures == 0 ? 0 : 1;
+}